@@ -0,0 +1,58 @@
+/**
+ * Bar aggregation throughput: aggregateInPlace() on a synthetic 1m series.
+ * Usage: bench_aggregate [bars]   (default 10M bars)
+ */
+#include "bench_common.hpp"
+#include "bar_aggregator.hpp"
+#include "timestamp.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+backtest::BarSeries makeSeries(std::size_t n) {
+    backtest::BarSeries s;
+    s.reserve(n);
+    const std::int64_t t0 = backtest::daysFromCivil(2024, 1, 1) * backtest::NS_PER_DAY;
+    double px = 20000.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        px += ((i * 2654435761u) % 9 < 4) ? 0.25 : -0.25;
+        backtest::Bar b;
+        b.timestamp = t0 + static_cast<std::int64_t>(i) * backtest::NS_PER_MINUTE;
+        b.open = px;
+        b.high = px + 1.5;
+        b.low = px - 1.25;
+        b.close = px + 0.5;
+        b.volume = static_cast<double>(100 + i % 500);
+        s.push_back(b);
+    }
+    return s;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 10000000;
+    const backtest::BarSeries source = makeSeries(n);
+    const double mb = static_cast<double>(n) * (sizeof(std::int64_t) + 5 * sizeof(double)) / (1024.0 * 1024.0);
+
+    std::cout << "Bars: " << n << " (" << mb << " MB of columns)\n";
+    for (const char* spec : { "5m", "15m", "1h", "1d@22:00" }) {
+        backtest::BarResolution res;
+        backtest::parseBarResolution(spec, res);
+        double best = 1e300;
+        std::size_t out = 0;
+        for (int rep = 0; rep < 3; ++rep) {
+            backtest::BarSeries s = source;
+            bench::Timer t;
+            backtest::aggregateInPlace(s, res);
+            double sec = t.seconds();
+            bench::doNotOptimize(s.closes().back());
+            out = s.size();
+            if (sec < best) best = sec;
+        }
+        std::cout << "  " << spec << ": " << out << " bars, " << best << " s, " << (mb / best) << " MB/s\n";
+    }
+    return 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+
+namespace bench {
+
+/// Wall-clock stopwatch for the bench_* executables.
+class Timer {
+public:
+    Timer() : start_(std::chrono::steady_clock::now()) {}
+    void reset() { start_ = std::chrono::steady_clock::now(); }
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// Keep the optimizer from discarding a computed value.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    const volatile T* p = &value;
+    (void)*p;
+}
+
+} // namespace bench
@@ -0,0 +1,62 @@
+/**
+ * CSV load throughput: DataSource::load() in Stream vs Mapped mode.
+ * Usage: bench_csv_load [path.csv]   (without a path, writes a synthetic 1m file of 2M rows)
+ */
+#include "bench_common.hpp"
+#include "data_source.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+std::string writeSyntheticCsv(std::size_t rows) {
+    std::string path = "bench_csv_load.csv";
+    std::ofstream f(path);
+    f << "timestamp,open,high,low,close,volume\n";
+    char buf[160];
+    double px = 20000.0;
+    for (std::size_t i = 0; i < rows; ++i) {
+        int day = static_cast<int>(i / 1440), minute = static_cast<int>(i % 1440);
+        px += ((i * 2654435761u) % 9 < 4) ? 0.25 : -0.25;
+        std::snprintf(buf, sizeof(buf), "2024-%02d-%02dT%02d:%02d:00,%.2f,%.2f,%.2f,%.2f,%zu\n",
+                      1 + (day / 28) % 12, 1 + day % 28, minute / 60, minute % 60,
+                      px, px + 1.5, px - 1.25, px + 0.5, 100 + i % 500);
+        f << buf;
+    }
+    return path;
+}
+
+double runOnce(const std::string& path, backtest::CsvLoadMode mode, std::size_t& bars) {
+    backtest::DataSource ds(path);
+    bench::Timer t;
+    if (!ds.load(mode)) return -1;
+    double s = t.seconds();
+    bars = ds.size();
+    return s;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool synthetic = argc < 2;
+    std::string path = synthetic ? writeSyntheticCsv(2000000) : argv[1];
+    const double mb = static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+
+    std::cout << "File: " << path << " (" << mb << " MB)\n";
+    for (auto [name, mode] : { std::pair{ "stream", backtest::CsvLoadMode::Stream },
+                               std::pair{ "mapped", backtest::CsvLoadMode::Mapped } }) {
+        std::size_t bars = 0;
+        double best = 1e300;
+        for (int rep = 0; rep < 3; ++rep) {
+            double s = runOnce(path, mode, bars);
+            if (s < 0) { std::cerr << "load failed\n"; return 1; }
+            if (s < best) best = s;
+        }
+        std::cout << "  " << name << ": " << bars << " bars, " << best << " s, " << (mb / best) << " MB/s\n";
+    }
+    if (synthetic) std::remove(path.c_str());
+    return 0;
+}
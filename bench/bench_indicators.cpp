@@ -0,0 +1,85 @@
+/**
+ * Per-update cost of the streaming indicators vs lookback, and of a naive re-summed SMA for contrast.
+ * Usage: bench_indicators [values]   (default 2M)
+ */
+#include "bench_common.hpp"
+#include "indicators.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+std::vector<double> makePrices(std::size_t n) {
+    std::vector<double> px(n);
+    double p = 20000.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        p += ((i * 2654435761u) % 9 < 4) ? 0.25 : -0.25;
+        px[i] = p;
+    }
+    return px;
+}
+
+/// Best-of-3 nanoseconds per update for fn(i) over all prices.
+template <typename F>
+double nsPerUpdate(std::size_t n, F&& fn) {
+    double best = 1e300;
+    for (int rep = 0; rep < 3; ++rep) {
+        bench::Timer t;
+        double acc = fn();
+        double s = t.seconds();
+        bench::doNotOptimize(acc);
+        if (s < best) best = s;
+    }
+    return best * 1e9 / static_cast<double>(n);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace backtest;
+    const std::size_t n = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 2000000;
+    const std::vector<double> px = makePrices(n);
+
+    std::cout << "Values: " << n << " (ns per update)\n";
+    std::cout << "  lookback   naive_sma   sma   ema   variance   min   max   regression\n";
+    for (std::size_t lb : { 10u, 50u, 200u, 1000u }) {
+        double naive = nsPerUpdate(n, [&]() {
+            double acc = 0;
+            for (std::size_t i = lb; i <= n; ++i) {
+                double sum = 0;
+                for (std::size_t k = 0; k < lb; ++k) sum += px[i - 1 - k];
+                acc += sum / static_cast<double>(lb);
+            }
+            return acc;
+        });
+        auto run = [&](auto make) {
+            return nsPerUpdate(n, [&]() {
+                auto ind = make();
+                double acc = 0;
+                for (double x : px) {
+                    ind.update(x);
+                    acc += ind.value();
+                }
+                return acc;
+            });
+        };
+        double sma = run([&]() { return Sma(lb); });
+        double ema = run([&]() { return Ema(lb); });
+        double var = nsPerUpdate(n, [&]() {
+            RollingVariance v(lb);
+            double acc = 0;
+            for (double x : px) {
+                v.update(x);
+                acc += v.variance();
+            }
+            return acc;
+        });
+        double mn = run([&]() { return RollingMin(lb); });
+        double mx = run([&]() { return RollingMax(lb); });
+        double reg = run([&]() { return RollingRegression(lb); });
+        std::cout << "  " << lb << "\t" << naive << "\t" << sma << "\t" << ema << "\t" << var
+                  << "\t" << mn << "\t" << mx << "\t" << reg << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * Monte Carlo paths per second: one path at a time with std::mt19937_64 (single thread) vs runMonteCarlo's
+ * lane groups on 1 thread and on every core, bootstrap and shuffle.
+ * Usage: bench_monte_carlo [paths] [trades]   (default 100k paths of 1000 trades)
+ */
+#include "bench_common.hpp"
+#include "monte_carlo.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<backtest::Trade> makeTrades(std::size_t n) {
+    std::vector<backtest::Trade> trades(n);
+    for (std::size_t i = 0; i < n; ++i)
+        trades[i].pnl = ((i * 2654435761u) % 9 < 4) ? 150.0 : -100.0;  // ~44% winners at 1.5 : 1
+    return trades;
+}
+
+/// The straightforward version: one path after another, a library RNG and distribution per draw.
+double naiveBootstrap(const std::vector<backtest::Trade>& trades, double initial_cash, std::size_t paths) {
+    std::mt19937_64 rng(1);
+    std::uniform_int_distribution<std::size_t> pick(0, trades.size() - 1);
+    double acc = 0;
+    for (std::size_t p = 0; p < paths; ++p) {
+        double equity = initial_cash, peak = initial_cash, max_dd = 0;
+        for (std::size_t k = 0; k < trades.size(); ++k) {
+            equity += trades[pick(rng)].pnl;
+            peak = std::max(peak, equity);
+            max_dd = std::max(max_dd, (peak - equity) / peak);
+        }
+        acc += equity + max_dd;
+    }
+    return acc;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace backtest;
+    const std::size_t paths = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 100000;
+    const std::size_t n = argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 1000;
+    const std::vector<Trade> trades = makeTrades(n);
+    const double cash = 100000.0;
+
+    // The naive loop on a tenth of the paths (it is the slow side).
+    const std::size_t naive_paths = std::max<std::size_t>(paths / 10, 1);
+    bench::Timer t;
+    bench::doNotOptimize(naiveBootstrap(trades, cash, naive_paths));
+    const double naive = static_cast<double>(naive_paths) / t.seconds();
+
+    ThreadPool one(1), all(0);
+    MonteCarloOptions options;
+    options.paths = paths;
+    auto rate = [&](MonteCarloMethod method, ThreadPool& pool) {
+        options.method = method;
+        bench::Timer timer;
+        MonteCarloPaths out = runMonteCarlo(trades, cash, options, pool);
+        const double per_second = static_cast<double>(paths) / timer.seconds();
+        bench::doNotOptimize(out.return_pct.back());
+        return per_second;
+    };
+    const double boot_one = rate(MonteCarloMethod::Bootstrap, one);
+    const double boot_all = rate(MonteCarloMethod::Bootstrap, all);
+    const double shuffle_one = rate(MonteCarloMethod::Shuffle, one);
+    const double shuffle_all = rate(MonteCarloMethod::Shuffle, all);
+
+    std::cout << "Paths: " << paths << " of " << n << " trades (paths/s; " << all.size() << " threads)\n";
+    std::cout << "  naive bootstrap, 1 thread:      " << naive << "\n";
+    std::cout << "  runMonteCarlo bootstrap, 1:     " << boot_one << "  (" << boot_one / naive << "x)\n";
+    std::cout << "  runMonteCarlo bootstrap, all:   " << boot_all << "  (" << boot_all / naive << "x)\n";
+    std::cout << "  runMonteCarlo shuffle, 1:       " << shuffle_one << "\n";
+    std::cout << "  runMonteCarlo shuffle, all:     " << shuffle_all << "\n";
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * session.json / equity_curve.csv write MB/s: the iostream formatting the reports used to do (std::fixed,
+ * setprecision, char-by-char JSON strings) vs Report's BufferedWriter (std::to_chars, block writes).
+ * Usage: bench_report_write [bars]   (default 2M; writes to the temp directory)
+ */
+#include "bench_common.hpp"
+#include "report.hpp"
+#include "simulator.hpp"
+#include "timestamp.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+backtest::BarSeries makeSeries(std::size_t n) {
+    backtest::BarSeries s;
+    s.reserve(n);
+    const std::int64_t t0 = backtest::daysFromCivil(2024, 1, 1) * backtest::NS_PER_DAY;
+    double px = 20000.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        px += ((i * 2654435761u) % 9 < 4) ? 0.25 : -0.25;
+        backtest::Bar b;
+        b.timestamp = t0 + static_cast<std::int64_t>(i) * backtest::NS_PER_MINUTE;
+        b.open = px;
+        b.high = px + 1.5;
+        b.low = px - 1.25;
+        b.close = px + 0.5;
+        b.volume = static_cast<double>(100 + i % 900);
+        s.push_back(b);
+    }
+    return s;
+}
+
+void writeJsonString(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"') out << "\\\"";
+        else if (c == '\\') out << "\\\\";
+        else if (c == '\n') out << "\\n";
+        else if (c == '\r') out << "\\r";
+        else out << c;
+    }
+    out << '"';
+}
+
+/// The bars section of session.json the iostream way (trades omitted: the bars are the bulk).
+void writeSessionIostream(const std::string& path, const backtest::BarSeries& bars) {
+    std::ofstream f(path);
+    f << std::fixed << std::setprecision(4);
+    f << "{\n  \"symbol\": \"bench\",\n  \"bars\": [\n";
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        const auto b = bars[i];
+        f << "    {\"t\":";
+        writeJsonString(f, backtest::formatTimestamp(b.timestamp));
+        f << ",\"o\":" << b.open << ",\"h\":" << b.high << ",\"l\":" << b.low << ",\"c\":" << b.close;
+        if (b.volume != 0) f << ",\"v\":" << b.volume;
+        f << "}";
+        if (i + 1 < bars.size()) f << ",";
+        f << "\n";
+    }
+    f << "  ],\n  \"trades\": [\n  ]\n}\n";
+}
+
+void writeEquityIostream(const std::string& path, const backtest::BarSeries& bars, const std::vector<double>& curve) {
+    std::ofstream f(path);
+    f << "bar_index,timestamp,equity\n";
+    f << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i < curve.size(); ++i)
+        f << i << ",\"" << backtest::formatTimestamp(bars.times()[i]) << "\"," << curve[i] << "\n";
+}
+
+double mbPerSecond(const std::string& path, double seconds) {
+    return static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0) / seconds;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace backtest;
+    const std::size_t n = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 2000000;
+    const BarSeries bars = makeSeries(n);
+
+    // A simulator whose equity curve covers every bar (no trades: the report rows are the point).
+    Simulator sim(100000.0);
+    sim.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) sim.updateEquity(bars[i]);
+    Report report(sim, bars, 100000.0, "bench", "");
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string json_old = (dir / "bench_session_iostream.json").string();
+    const std::string json_new = (dir / "bench_session_buffered.json").string();
+    const std::string csv_old = (dir / "bench_equity_iostream.csv").string();
+    const std::string csv_new = (dir / "bench_equity_buffered.csv").string();
+
+    bench::Timer t;
+    writeSessionIostream(json_old, bars);
+    const double json_iostream = mbPerSecond(json_old, t.seconds());
+    t.reset();
+    report.writeSessionJson(json_new, "bench");
+    const double json_buffered = mbPerSecond(json_new, t.seconds());
+
+    t.reset();
+    writeEquityIostream(csv_old, bars, sim.equityCurve());
+    const double csv_iostream = mbPerSecond(csv_old, t.seconds());
+    t.reset();
+    report.writeEquityCurve(csv_new);
+    const double csv_buffered = mbPerSecond(csv_new, t.seconds());
+
+    std::cout << "Bars: " << n << " (MB/s written)\n";
+    std::cout << "                      iostream   BufferedWriter\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  session.json      " << std::setw(10) << json_iostream << std::setw(17) << json_buffered << "\n";
+    std::cout << "  equity_curve.csv  " << std::setw(10) << csv_iostream << std::setw(17) << csv_buffered << "\n";
+
+    for (const auto& p : { json_old, json_new, csv_old, csv_new }) std::filesystem::remove(p);
+    return 0;
+}
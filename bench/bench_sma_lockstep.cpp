@@ -0,0 +1,73 @@
+/**
+ * sma_crossover parameter sets per second: one Backtester per combination vs the lockstep kernel.
+ * Single-threaded on both sides. Usage: bench_sma_lockstep [bars]   (default 100k)
+ */
+#include "bench_common.hpp"
+#include "backtester.hpp"
+#include "example_sma_strategy.hpp"
+#include "report.hpp"
+#include "sma_lockstep.hpp"
+#include "timestamp.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+backtest::BarSeries makeSeries(std::size_t n) {
+    backtest::BarSeries s;
+    s.reserve(n);
+    const std::int64_t t0 = backtest::daysFromCivil(2024, 1, 1) * backtest::NS_PER_DAY;
+    double px = 20000.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        px += ((i * 2654435761u) % 9 < 4) ? 0.25 : -0.25;
+        backtest::Bar b;
+        b.timestamp = t0 + static_cast<std::int64_t>(i) * backtest::NS_PER_MINUTE;
+        b.open = px;
+        b.high = px + 1.5;
+        b.low = px - 1.25;
+        b.close = px + 0.5;
+        s.push_back(b);
+    }
+    return s;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace backtest;
+    const std::size_t n = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 100000;
+    const auto bars = std::make_shared<const BarSeries>(makeSeries(n));
+
+    // fast 2..49 x slow 10..400 step 10, fast < slow
+    std::vector<SmaLane> lanes;
+    for (int fast = 2; fast < 50; ++fast)
+        for (int slow = 10; slow <= 400; slow += 10)
+            if (fast < slow) lanes.push_back({ fast, slow, 0.1 });
+
+    // One Backtester per combination, on a sample of the grid (it is the slow side).
+    const std::size_t sample = std::min<std::size_t>(lanes.size(), 64);
+    bench::Timer t;
+    double acc = 0;
+    for (std::size_t i = 0; i < sample; ++i) {
+        Backtester bt(createSmaCrossoverStrategy(lanes[i].fast, lanes[i].slow, lanes[i].size), bars, 100000.0);
+        bt.run();
+        Report r(bt.simulator(), bt.bars(), 100000.0);
+        acc += r.computeMetrics().final_equity;
+    }
+    const double per_backtester = static_cast<double>(sample) / t.seconds();
+
+    t.reset();
+    std::vector<SmaLaneResult> results = runSmaCrossoverLockstep(*bars, lanes, 100000.0);
+    const double per_lockstep = static_cast<double>(lanes.size()) / t.seconds();
+    for (const auto& r : results) acc += r.metrics.final_equity;
+    bench::doNotOptimize(acc);
+
+    std::cout << "Bars: " << n << ", combinations: " << lanes.size() << " (kernel: " << smaLockstepIsa() << ")\n";
+    std::cout << "  Backtester per combination: " << per_backtester << " combos/s\n";
+    std::cout << "  lockstep kernel:            " << per_lockstep << " combos/s  ("
+              << per_lockstep / per_backtester << "x)\n";
+    return 0;
+}
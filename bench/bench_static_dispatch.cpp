@@ -0,0 +1,90 @@
+/**
+ * Per-bar engine overhead on a no-op strategy: Backtester (virtual IStrategy / IContext calls) vs
+ * StaticBacktester (strategy and context types known at compile time).
+ * Usage: bench_static_dispatch [bars]   (default 2M)
+ */
+#include "bench_common.hpp"
+#include "backtester.hpp"
+#include "static_backtester.hpp"
+#include "timestamp.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+backtest::BarSeries makeSeries(std::size_t n) {
+    backtest::BarSeries s;
+    s.reserve(n);
+    const std::int64_t t0 = backtest::daysFromCivil(2024, 1, 1) * backtest::NS_PER_DAY;
+    double px = 20000.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        px += ((i * 2654435761u) % 9 < 4) ? 0.25 : -0.25;
+        backtest::Bar b;
+        b.timestamp = t0 + static_cast<std::int64_t>(i) * backtest::NS_PER_MINUTE;
+        b.open = px;
+        b.high = px + 1.5;
+        b.low = px - 1.25;
+        b.close = px + 0.5;
+        s.push_back(b);
+    }
+    return s;
+}
+
+/// Reads what a typical strategy reads every bar and never trades.
+template <typename Ctx>
+double touch(const backtest::Bar& bar, Ctx& ctx) {
+    return ctx.position() + ctx.equity() + ctx.cash() + static_cast<double>(ctx.bars().size()) + bar.close;
+}
+
+class VirtualNoop : public backtest::IStrategy {
+public:
+    void onBar(const backtest::Bar& bar, backtest::IContext& ctx) override { acc += touch(bar, ctx); }
+    double acc{0};
+};
+
+struct StaticNoop {
+    void onBar(const backtest::Bar& bar, backtest::BacktestContext& ctx) { acc += touch(bar, ctx); }
+    double acc{0};
+};
+
+/// Best-of-3 nanoseconds per bar for one run.
+template <typename F>
+double nsPerBar(std::size_t n, F&& fn) {
+    double best = 1e300;
+    for (int rep = 0; rep < 3; ++rep) {
+        bench::Timer t;
+        double acc = fn();
+        double s = t.seconds();
+        bench::doNotOptimize(acc);
+        if (s < best) best = s;
+    }
+    return best * 1e9 / static_cast<double>(n);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace backtest;
+    const std::size_t n = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 2000000;
+    const auto bars = std::make_shared<const BarSeries>(makeSeries(n));
+
+    double dynamic_ns = nsPerBar(n, [&]() {
+        auto strategy = std::make_unique<VirtualNoop>();
+        VirtualNoop* s = strategy.get();
+        Backtester bt(std::move(strategy), bars, 100000.0);
+        bt.run();
+        return s->acc;
+    });
+    double static_ns = nsPerBar(n, [&]() {
+        StaticBacktester<StaticNoop> bt(StaticNoop{}, bars, 100000.0);
+        bt.run();
+        return bt.strategy().acc;
+    });
+
+    std::cout << "Bars: " << n << " (ns per bar, no-op strategy)\n";
+    std::cout << "  Backtester (virtual):       " << dynamic_ns << "\n";
+    std::cout << "  StaticBacktester<Strategy>: " << static_ns << "\n";
+    std::cout << "  Speedup: " << (static_ns > 0 ? dynamic_ns / static_ns : 0.0) << "x\n";
+    return 0;
+}
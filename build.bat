@@ -3,15 +3,31 @@ REM Build with g++ when make isn't on PATH. Run from build/ folder.
 REM Add your MinGW or g++ bin folder to PATH if g++ not found.
 
 set CXX=g++
-set INC=-I../include -I../strategies
-set CFLAGS=-std=c++17 -Wall %INC%
+set INC=-I../include -I../strategies -I../indicators
+set CFLAGS=-std=c++17 -Wall -pthread %INC%
 
 echo Compiling...
 %CXX% %CFLAGS% -c ../src/main.cpp -o main.o
 %CXX% %CFLAGS% -c ../src/data_source.cpp -o data_source.o
+%CXX% %CFLAGS% -c ../src/bar_aggregator.cpp -o bar_aggregator.o
+%CXX% %CFLAGS% -c ../src/databento_index.cpp -o databento_index.o
+%CXX% %CFLAGS% -c ../src/dbn_decoder.cpp -o dbn_decoder.o
+%CXX% %CFLAGS% -c ../src/thread_pool.cpp -o thread_pool.o
+%CXX% %CFLAGS% -c ../src/mapped_file.cpp -o mapped_file.o
+%CXX% %CFLAGS% -c ../src/bar_cache.cpp -o bar_cache.o
+%CXX% %CFLAGS% -c ../src/timestamp.cpp -o timestamp.o
 %CXX% %CFLAGS% -c ../src/simulator.cpp -o simulator.o
+%CXX% %CFLAGS% -c ../src/order_book.cpp -o order_book.o
 %CXX% %CFLAGS% -c ../src/backtester.cpp -o backtester.o
+%CXX% %CFLAGS% -c ../src/pruning.cpp -o pruning.o
+%CXX% %CFLAGS% -c ../src/indicator_cache.cpp -o indicator_cache.o
 %CXX% %CFLAGS% -c ../src/report.cpp -o report.o
+%CXX% %CFLAGS% -c ../src/buffered_writer.cpp -o buffered_writer.o
+%CXX% %CFLAGS% -c ../src/sweep.cpp -o sweep.o
+%CXX% %CFLAGS% -c ../src/walk_forward.cpp -o walk_forward.o
+%CXX% %CFLAGS% -c ../src/monte_carlo.cpp -o monte_carlo.o
+%CXX% %CFLAGS% -c ../src/portfolio.cpp -o portfolio.o
+%CXX% %CFLAGS% -c ../src/sma_lockstep.cpp -o sma_lockstep.o
 %CXX% %CFLAGS% -c ../strategies/example_sma_strategy.cpp -o example_sma_strategy.o
 %CXX% %CFLAGS% -c ../strategies/ctm_strategy_simple.cpp -o ctm_strategy_simple.o
 %CXX% %CFLAGS% -c ../strategies/orb_strategy.cpp -o orb_strategy.o
@@ -19,10 +35,11 @@ echo Compiling...
 %CXX% %CFLAGS% -c ../strategies/experiment_strategy.cpp -o experiment_strategy.o
 
 echo Linking...
-%CXX% -o backtester.exe main.o data_source.o simulator.o backtester.o report.o example_sma_strategy.o ctm_strategy_simple.o orb_strategy.o one_point_oh_strategy.o experiment_strategy.o
+%CXX% -pthread -o backtester.exe main.o data_source.o bar_aggregator.o databento_index.o dbn_decoder.o thread_pool.o mapped_file.o bar_cache.o timestamp.o simulator.o order_book.o backtester.o pruning.o indicator_cache.o report.o buffered_writer.o sweep.o walk_forward.o monte_carlo.o portfolio.o sma_lockstep.o example_sma_strategy.o ctm_strategy_simple.o orb_strategy.o one_point_oh_strategy.o experiment_strategy.o
 
 %CXX% %CFLAGS% -c ../tests/test_runner.cpp -o test_runner.o
-%CXX% -o test_runner.exe test_runner.o data_source.o simulator.o
+%CXX% %CFLAGS% -c ../tests/alloc_counter.cpp -o alloc_counter.o
+%CXX% -pthread -o test_runner.exe test_runner.o alloc_counter.o data_source.o bar_aggregator.o databento_index.o dbn_decoder.o thread_pool.o mapped_file.o bar_cache.o timestamp.o simulator.o order_book.o backtester.o pruning.o indicator_cache.o report.o buffered_writer.o sweep.o walk_forward.o monte_carlo.o portfolio.o sma_lockstep.o example_sma_strategy.o orb_strategy.o
 
 if %ERRORLEVEL% equ 0 (
   echo Done. Run: backtester.exe  or  test_runner.exe
@@ -3,39 +3,59 @@
 #include "bar.hpp"
 #include "strategy.hpp"
 #include "context.hpp"
+#include "bar_aggregator.hpp"
 #include "data_source.hpp"
 #include "simulator.hpp"
+#include "indicator_cache.hpp"
+#include "metrics.hpp"
+#include "pruning.hpp"
+#include <cstdint>
 #include <memory>
 #include <string>
 
 namespace backtest {
 
-/// Concrete context implementation passed to the strategy.
-class BacktestContext : public IContext {
+/// Concrete context implementation passed to the strategy. final, with the state accessors inline, so a
+/// strategy that takes BacktestContext& (see StaticBacktester) gets direct, inlinable calls.
+/// bars is the run's series, or a window of one (Backtester::setRange): bar indices count from its start.
+class BacktestContext final : public IContext {
 public:
-    explicit BacktestContext(Simulator& sim, const std::vector<Bar>& bars);
+    BacktestContext(Simulator& sim, BarSeriesView bars);
+    BacktestContext(Simulator& sim, const BarSeries& bars) : BacktestContext(sim, bars.view()) {}
 
     void placeOrder(Side side, double quantity) override;
-    double position() const override;
-    double equity() const override;
-    double cash() const override;
-    double lastClose() const override;
-    std::size_t barIndex() const override;
-    const std::vector<Bar>& bars() const override;
+    OrderId submitOrder(const Order& order) override;
+    BracketOrderIds submitBracket(const Order& entry, double stop_price, double target_price) override;
+    bool cancelOrder(OrderId id) override;
+    bool isOrderOpen(OrderId id) const override;
+    double position() const override { return sim_.position(); }
+    double equity() const override { return sim_.equity(); }
+    double cash() const override { return sim_.cash(); }
+    double lastClose() const override { return sim_.lastClose(); }
+    std::size_t barIndex() const override { return bar_index_; }
+    BarSeriesView bars() const override { return bars_.slice(0, bar_index_ + 1); }
+    IndicatorColumnPtr indicator(IndicatorKind kind, std::size_t period) const override;
 
     void setBarIndex(std::size_t i) { bar_index_ = i; }
+    void setIndicatorCache(IndicatorCache* cache, std::uint64_t series_id) {
+        cache_ = cache;
+        series_id_ = series_id;
+    }
 
 private:
     Simulator& sim_;
-    const std::vector<Bar>& bars_;
+    BarSeriesView bars_;
     std::size_t bar_index_{0};
+    IndicatorCache* cache_{nullptr};
+    std::uint64_t series_id_{0};
 };
 
 /// Orchestrates the backtest: feed bars to strategy, run simulator, collect results.
 class Backtester {
 public:
-    /// If databento_dir non-empty, load from that folder (filename = bar data); else load from data_path CSV.
-    /// symbol_filter: when using databento, load only this symbol (e.g. "NQU5"); empty = all.
+    /// If databento_dir non-empty, load from that folder (filename = bar data); else load from data_path,
+    /// a CSV or a DBN file (.dbn / .dbn.zst). symbol_filter: Databento dir or DBN only, load only this
+    /// symbol (e.g. "NQU5"); empty = all.
     /// bar_resolution: "1m" (default), "15m", or "1h" — aggregate 1m bars to that timeframe before backtest.
     /// slippage: fraction of fill price (e.g. 0.001 = 0.1%); longs fill worse (higher), shorts worse (lower).
     Backtester(std::unique_ptr<IStrategy> strategy,
@@ -47,27 +67,101 @@ public:
               const std::string& bar_resolution = "1m",
               double slippage = 0.0);
 
+    /// Backtest bars already in memory (e.g. one symbol out of a DatabentoIndex); run() skips loading.
+    Backtester(std::unique_ptr<IStrategy> strategy,
+              BarSeries bars,
+              double initial_cash = 100000.0,
+              double commission = 0.0,
+              const std::string& bar_resolution = "1m",
+              double slippage = 0.0);
+
+    /// Backtest a shared, read-only series (already aggregated), e.g. one series across every run of a
+    /// parameter sweep. Nothing is loaded or copied; bars must outlive run().
+    Backtester(std::unique_ptr<IStrategy> strategy,
+              std::shared_ptr<const BarSeries> shared_bars,
+              double initial_cash = 100000.0,
+              double commission = 0.0,
+              double slippage = 0.0);
+
+    /// Read/write the binary bar cache (.btc) next to the data source. Call before run().
+    void setUseCache(bool use_cache) { data_.setUseCache(use_cache); }
+
+    /// Keep the loaded bars when aggregating to bar_resolution and fill resting orders (submitOrder)
+    /// against them inside each aggregated bar: e.g. 1h strategy bars with 1m stop / target fills.
+    /// No effect at "1m" or with a shared series (use setIntrabar). Call before run().
+    void setIntrabarFills(bool on) { intrabar_fills_ = on; }
+
+    /// Intrabar bars for the shared series (offsets must match it; see IntrabarSeries). Call before run().
+    void setIntrabar(std::shared_ptr<const IntrabarSeries> intrabar) { shared_intrabar_ = std::move(intrabar); }
+
+    /// Serve strategies' indicator() requests from cache, keyed by series_id (IndicatorCache::newSeriesId()
+    /// for the series this backtester runs on). Share one cache and id across backtesters of the same series.
+    void setIndicatorCache(std::shared_ptr<IndicatorCache> cache, std::uint64_t series_id) {
+        indicator_cache_ = std::move(cache);
+        series_id_ = series_id;
+    }
+
+    /// Store the equity curve in the simulator (default on; Report needs it). Off for runs that only want
+    /// metrics(), e.g. sweeps: nothing per bar is kept. Call before run().
+    void setRecordEquityCurve(bool on) { sim_->setRecordEquityCurve(on); }
+
+    /// Run only bars [begin, end) of the shared series (clamped to it), as if they were the whole series:
+    /// bar indices, bars() and indicator columns start at begin. Nothing is copied; e.g. the windows of a
+    /// walk-forward (walk_forward.hpp). Shared series only. Call before run().
+    void setRange(std::size_t begin, std::size_t end) {
+        range_begin_ = begin;
+        range_end_ = end;
+    }
+
+    /// Stop hopeless runs early (see PruneCriteria), e.g. in a sweep. board: shared by the sweep's runs for
+    /// equity_percentile (PruneBoard(criteria.checkpoints)); may be null otherwise. Call before run().
+    void setPruning(const PruneCriteria& criteria, std::shared_ptr<PruneBoard> board) {
+        prune_ = criteria;
+        prune_board_ = std::move(board);
+    }
+
     /// Run the backtest. Returns false if data failed to load.
-    /// If equity <= 0 or max drawdown >= 100%, stops early and sets stoppedEarly() / stopReason().
+    /// If equity <= 0 or max drawdown >= 100%, or a pruning criterion hits, stops early and sets
+    /// stoppedEarly() / stopReason().
     bool run();
 
     const Simulator& simulator() const { return *sim_; }
     Simulator& simulator() { return *sim_; }
-    const std::vector<Bar>& bars() const { return data_.bars(); }
+    /// The series the backtest ran on (loaded and aggregated, or the shared one; all of it with setRange).
+    const BarSeries& bars() const { return shared_bars_ ? *shared_bars_ : data_.bars(); }
     const DataSource& data() const { return data_; }
 
+    /// Metrics accumulated during run() (MetricsAccumulator), with or without the stored equity curve;
+    /// matches Report::computeMetrics (Sharpe / Sortino to the last bits) and adds exposure_pct.
+    BacktestMetrics metrics() const { return withOpenPosition(metrics_.metrics(), *sim_); }
+
     bool stoppedEarly() const { return stopped_early_; }
     const std::string& stopReason() const { return stop_reason_; }
 
 private:
+    bool runLoop(const BarSeries& bars, std::size_t begin, std::size_t end);
+
     std::unique_ptr<IStrategy> strategy_;
     DataSource data_;
     double initial_cash_;
     std::string databento_dir_;
     std::string symbol_filter_;
     std::string bar_resolution_;
+    bool preloaded_{false};
+    std::shared_ptr<const BarSeries> shared_bars_;
+    std::size_t range_begin_{0};
+    std::size_t range_end_{SIZE_MAX};
+    std::shared_ptr<IndicatorCache> indicator_cache_;
+    bool intrabar_fills_{false};
+    IntrabarSeries intrabar_;
+    std::shared_ptr<const IntrabarSeries> shared_intrabar_;
+    std::uint64_t series_id_{0};
     std::unique_ptr<Simulator> sim_;
     std::unique_ptr<BacktestContext> ctx_;
+    MetricsAccumulator metrics_;
+    PruneCriteria prune_;
+    std::shared_ptr<PruneBoard> prune_board_;
+    std::unique_ptr<RunPruner> pruner_;
     bool stopped_early_{false};
     std::string stop_reason_;
 };
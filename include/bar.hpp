@@ -1,13 +1,13 @@
 #pragma once
 
-#include <string>
+#include "timestamp.hpp"
 #include <cstdint>
 
 namespace backtest {
 
 /// Single OHLC (Open, High, Low, Close) bar.
 struct Bar {
-    std::string timestamp;  // e.g. "2024-01-02" or ISO datetime
+    std::int64_t timestamp{0};  // ns since epoch, UTC; parsed once at load, formatted only in reports
     double open{0};
     double high{0};
     double low{0};
@@ -15,6 +15,11 @@ struct Bar {
     double volume{0};       // optional
 
     double typical_price() const { return (high + low + close) / 3.0; }
+
+    /// Calendar day (days since 1970-01-01, UTC); equal for bars on the same date.
+    std::int64_t day() const { return dayOf(timestamp); }
+    int hour() const { return hourOf(timestamp); }
+    int minute() const { return minuteOf(timestamp); }
 };
 
 } // namespace backtest
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "bar_series.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+/// Target bar size for aggregation. Buckets are [anchor + k*period, anchor + (k+1)*period).
+struct BarResolution {
+    std::int64_t period_ns{0};
+    std::int64_t anchor_ns{0};  // offset from UTC midnight; e.g. 22:00 for CME sessions
+
+    /// Start of the bucket containing t.
+    std::int64_t bucketStart(std::int64_t t) const {
+        std::int64_t rel = t - anchor_ns;
+        std::int64_t q = rel / period_ns;
+        if (rel % period_ns < 0) --q;
+        return anchor_ns + q * period_ns;
+    }
+};
+
+/// Parse "<N><unit>[@HH:MM]" with unit s, m/min, h/hr or d (case-insensitive), e.g. "15m", "4h", "1d", "1d@22:00".
+/// The optional @HH:MM aligns buckets to a session start (UTC) instead of midnight. Returns false if invalid.
+bool parseBarResolution(const std::string& text, BarResolution& out);
+
+/// Roll bars up to res in one pass, in place: open=first, high=max, low=min, close=last, volume=sum,
+/// timestamp=bucket start. Input is expected sorted by time; if it isn't, it is stably sorted first.
+void aggregateInPlace(BarSeries& bars, const BarResolution& res);
+
+/// The finer bars an aggregated series was built from, for resolving fills inside each coarse bar
+/// (Simulator::processOrders): coarse bar i is made of fine bars [offsets[i], offsets[i + 1]).
+struct IntrabarSeries {
+    BarSeries fine;
+    std::vector<std::size_t> offsets;  // coarse bars + 1 entries; empty = none kept
+
+    bool empty() const { return offsets.empty(); }
+    std::size_t coarseSize() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    BarSeriesView of(std::size_t i) const { return fine.view(offsets[i], offsets[i + 1]); }
+};
+
+/// aggregateInPlace that first keeps a copy of the input bars (sorted by time) in intrabar.
+void aggregateInPlace(BarSeries& bars, const BarResolution& res, IntrabarSeries& intrabar);
+
+/// Downsampled copies of a series for drawing it at any zoom (the chart viewer's session.lod): each level
+/// rolls the one below up with aggregateInPlace, so every level keeps the true high / low of its span.
+struct LodPyramid {
+    struct Level {
+        std::int64_t period_ns{0};
+        BarSeries bars;
+    };
+    std::int64_t base_period_ns{0};  // smallest step between the input bars (level "0" = the input itself)
+    std::vector<Level> levels;       // coarser levels, finest first
+};
+
+/// Levels at the steps of 1m / 5m / 15m / 1h / 4h / 1d / 1w (weeks from Monday) that are coarser than the
+/// input, skipping steps that don't at least halve the bar count, until one has <= max_top_bars bars.
+/// bars must be sorted by time.
+LodPyramid buildLodPyramid(const BarSeries& bars, std::size_t max_top_bars);
+
+} // namespace backtest
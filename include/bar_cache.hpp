@@ -0,0 +1,72 @@
+#pragma once
+
+#include "bar_series.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+/// Identity of the text source a cache was built from. Any mismatch invalidates the cache.
+struct SourceFingerprint {
+    std::uint64_t size{0};      // file size in bytes; 0 for a directory
+    std::int64_t mtime{0};      // last write time (filesystem clock ticks); a directory's changes when files are added/removed
+    std::uint64_t checksum{0};  // FNV-1a over size + first/last 64 KiB (file) or the path (directory)
+
+    bool operator==(const SourceFingerprint& o) const {
+        return size == o.size && mtime == o.mtime && checksum == o.checksum;
+    }
+};
+
+/// Bars of one symbol inside a cache. Bars are grouped by symbol, each group sorted by time.
+struct SymbolRange {
+    std::string symbol;
+    std::size_t begin{0};
+    std::size_t count{0};
+};
+
+/// Fingerprint a CSV file or Databento directory. Returns false if it doesn't exist.
+bool fingerprintSource(const std::string& path, SourceFingerprint& out);
+
+/// Cache file sitting next to the source: "<file>.btc" or "<dir>.btc".
+std::string barCachePath(const std::string& source_path);
+
+/// Read-only, memory-mapped view of a .btc bar cache (version 1).
+///
+/// Layout (little-endian): 64-byte header (magic "BTCACHE", version, endian marker, source
+/// fingerprint, bar count, symbol count, column offset); symbol table (u64 begin, u64 count,
+/// u32 length, name bytes); then six 64-byte-aligned columns of bar_count entries each:
+/// int64 time (ns since epoch UTC), double open, high, low, close, volume.
+class BarCacheReader {
+public:
+    /// Map and validate the cache. False if missing, corrupt, another version, or built from a different source.
+    bool open(const std::string& cache_path, const SourceFingerprint& expected);
+
+    const std::vector<SymbolRange>& symbols() const { return symbols_; }
+    std::size_t size() const { return bar_count_; }
+
+    const std::int64_t* times() const { return times_; }
+    const double* opens() const { return cols_[0]; }
+    const double* highs() const { return cols_[1]; }
+    const double* lows() const { return cols_[2]; }
+    const double* closes() const { return cols_[3]; }
+    const double* volumes() const { return cols_[4]; }
+
+    /// Replace out with every bar in the cache (straight column copies).
+    void copyTo(BarSeries& out) const;
+
+private:
+    MappedFile file_;
+    std::vector<SymbolRange> symbols_;
+    std::size_t bar_count_{0};
+    const std::int64_t* times_{nullptr};
+    const double* cols_[5]{};
+};
+
+/// Write a cache atomically (temp file + rename).
+/// Returns false on I/O failure; callers treat that as "no cache".
+bool writeBarCache(const std::string& cache_path, const SourceFingerprint& source,
+                   const std::vector<SymbolRange>& symbols, const BarSeries& bars);
+
+} // namespace backtest
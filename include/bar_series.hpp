@@ -0,0 +1,215 @@
+#pragma once
+
+#include "bar.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace backtest {
+
+/// Allocator handing out ALIGN-byte aligned storage (64 = cache line / one AVX-512 register).
+template <typename T, std::size_t ALIGN = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, ALIGN>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, ALIGN>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(ALIGN)));
+    }
+    void deallocate(T* p, std::size_t) noexcept { ::operator delete(p, std::align_val_t(ALIGN)); }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, ALIGN>&) const noexcept { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, ALIGN>&) const noexcept { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/// Read-only contiguous column (span-like): pointer + length, cheap to copy.
+template <typename T>
+class Column {
+public:
+    Column() = default;
+    Column(const T* data, std::size_t size) : data_(data), size_(size) {}
+
+    const T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    /// Elements [offset, offset + count).
+    Column subspan(std::size_t offset, std::size_t count) const { return Column(data_ + offset, count); }
+
+private:
+    const T* data_{nullptr};
+    std::size_t size_{0};
+};
+
+class BarSeriesView;
+
+/// Bars stored as a structure of arrays: one contiguous, 64-byte aligned column per field,
+/// so indicator loops read only the column they need (e.g. closes) and vectorize cleanly.
+/// Bar-at-a-time access (operator[], iteration) assembles a Bar by value.
+class BarSeries {
+public:
+    std::size_t size() const { return time_.size(); }
+    bool empty() const { return time_.empty(); }
+
+    void clear() {
+        time_.clear(); open_.clear(); high_.clear(); low_.clear(); close_.clear(); volume_.clear();
+    }
+    void reserve(std::size_t n) {
+        time_.reserve(n); open_.reserve(n); high_.reserve(n); low_.reserve(n); close_.reserve(n); volume_.reserve(n);
+    }
+    void resize(std::size_t n) {
+        time_.resize(n); open_.resize(n); high_.resize(n); low_.resize(n); close_.resize(n); volume_.resize(n);
+    }
+
+    void push_back(const Bar& b) {
+        time_.push_back(b.timestamp);
+        open_.push_back(b.open);
+        high_.push_back(b.high);
+        low_.push_back(b.low);
+        close_.push_back(b.close);
+        volume_.push_back(b.volume);
+    }
+
+    void set(std::size_t i, const Bar& b) {
+        time_[i] = b.timestamp; open_[i] = b.open; high_[i] = b.high;
+        low_[i] = b.low; close_[i] = b.close; volume_[i] = b.volume;
+    }
+
+    Bar operator[](std::size_t i) const {
+        Bar b;
+        b.timestamp = time_[i];
+        b.open = open_[i];
+        b.high = high_[i];
+        b.low = low_[i];
+        b.close = close_[i];
+        b.volume = volume_[i];
+        return b;
+    }
+    Bar at(std::size_t i) const {
+        if (i >= size()) throw std::out_of_range("BarSeries::at");
+        return (*this)[i];
+    }
+
+    Column<std::int64_t> times() const { return { time_.data(), time_.size() }; }
+    Column<double> opens() const { return { open_.data(), open_.size() }; }
+    Column<double> highs() const { return { high_.data(), high_.size() }; }
+    Column<double> lows() const { return { low_.data(), low_.size() }; }
+    Column<double> closes() const { return { close_.data(), close_.size() }; }
+    Column<double> volumes() const { return { volume_.data(), volume_.size() }; }
+
+    /// Raw column storage for loaders that fill columns directly (e.g. from the bar cache).
+    std::int64_t* timeData() { return time_.data(); }
+    double* openData() { return open_.data(); }
+    double* highData() { return high_.data(); }
+    double* lowData() { return low_.data(); }
+    double* closeData() { return close_.data(); }
+    double* volumeData() { return volume_.data(); }
+
+    /// Non-owning view of all bars, or of [begin, end).
+    BarSeriesView view() const;
+    BarSeriesView view(std::size_t begin, std::size_t end) const;
+
+private:
+    AlignedVector<std::int64_t> time_;
+    AlignedVector<double> open_, high_, low_, close_, volume_;
+};
+
+/// Non-owning window onto a BarSeries: what strategies receive from IContext::bars().
+/// Column accessors give span-like views; operator[]/iteration give Bars by value, so
+/// strategies written against the old std::vector<Bar> (bars[i].close, range-for) keep compiling.
+class BarSeriesView {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Bar;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Bar;
+
+        Iterator(const BarSeriesView* v, std::size_t i) : v_(v), i_(i) {}
+        Bar operator*() const { return (*v_)[i_]; }
+        Iterator& operator++() { ++i_; return *this; }
+        bool operator==(const Iterator& o) const { return i_ == o.i_; }
+        bool operator!=(const Iterator& o) const { return i_ != o.i_; }
+
+    private:
+        const BarSeriesView* v_;
+        std::size_t i_;
+    };
+
+    BarSeriesView() = default;
+    BarSeriesView(const BarSeries& s, std::size_t begin, std::size_t end)
+        : time_(s.times().subspan(begin, end - begin))
+        , open_(s.opens().subspan(begin, end - begin))
+        , high_(s.highs().subspan(begin, end - begin))
+        , low_(s.lows().subspan(begin, end - begin))
+        , close_(s.closes().subspan(begin, end - begin))
+        , volume_(s.volumes().subspan(begin, end - begin))
+    {}
+
+    std::size_t size() const { return time_.size(); }
+    bool empty() const { return time_.empty(); }
+
+    Bar operator[](std::size_t i) const {
+        Bar b;
+        b.timestamp = time_[i];
+        b.open = open_[i];
+        b.high = high_[i];
+        b.low = low_[i];
+        b.close = close_[i];
+        b.volume = volume_[i];
+        return b;
+    }
+    Bar at(std::size_t i) const {
+        if (i >= size()) throw std::out_of_range("BarSeriesView::at");
+        return (*this)[i];
+    }
+    Bar front() const { return (*this)[0]; }
+    Bar back() const { return (*this)[size() - 1]; }
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, size()); }
+
+    Column<std::int64_t> times() const { return time_; }
+    Column<double> opens() const { return open_; }
+    Column<double> highs() const { return high_; }
+    Column<double> lows() const { return low_; }
+    Column<double> closes() const { return close_; }
+    Column<double> volumes() const { return volume_; }
+
+    /// Bars [begin, end) of this view.
+    BarSeriesView slice(std::size_t begin, std::size_t end) const {
+        BarSeriesView v;
+        v.time_ = time_.subspan(begin, end - begin);
+        v.open_ = open_.subspan(begin, end - begin);
+        v.high_ = high_.subspan(begin, end - begin);
+        v.low_ = low_.subspan(begin, end - begin);
+        v.close_ = close_.subspan(begin, end - begin);
+        v.volume_ = volume_.subspan(begin, end - begin);
+        return v;
+    }
+
+private:
+    Column<std::int64_t> time_;
+    Column<double> open_, high_, low_, close_, volume_;
+};
+
+inline BarSeriesView BarSeries::view() const { return BarSeriesView(*this, 0, size()); }
+inline BarSeriesView BarSeries::view(std::size_t begin, std::size_t end) const {
+    return BarSeriesView(*this, begin, end);
+}
+
+} // namespace backtest
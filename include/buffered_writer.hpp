@@ -0,0 +1,85 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace backtest {
+
+/// Text file written through one large buffer: numbers are formatted straight into it with std::to_chars
+/// (the same text as an ostream with std::fixed / std::setprecision) and it goes to the file in big blocks.
+/// For report files with millions of rows. Open with open(); check close() (or ok()) for write errors.
+/// Reusable: open() again after close() keeps the buffer.
+class BufferedWriter {
+public:
+    static constexpr std::size_t DEFAULT_BUFFER_BYTES = 1u << 20;
+
+    explicit BufferedWriter(std::size_t buffer_bytes = DEFAULT_BUFFER_BYTES);
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    /// Create / truncate path (text mode, like std::ofstream, unless binary: then bytesWritten() is also
+    /// the file offset on every platform). Returns false if it can't be opened.
+    bool open(const std::string& path, bool binary = false);
+    /// Flush and close. Returns false if any write failed since open().
+    bool close();
+    bool ok() const { return file_ != nullptr && ok_; }
+    /// Bytes written since open(), buffered ones included.
+    std::uint64_t bytesWritten() const { return flushed_ + pos_; }
+
+    void put(char c) {
+        if (pos_ == buf_.size()) flush();
+        buf_[pos_++] = c;
+    }
+    void write(std::string_view s);
+
+    /// v with `precision` digits after the point (std::fixed).
+    void fixed(double v, int precision) {
+        ensure(MAX_FIXED_CHARS);
+        char* const begin = buf_.data() + pos_;
+        auto res = std::to_chars(begin, buf_.data() + buf_.size(), v, std::chars_format::fixed, precision);
+        if (res.ec == std::errc()) pos_ += static_cast<std::size_t>(res.ptr - begin);
+        else fixedFallback(v, precision);
+    }
+    void integer(std::int64_t v) {
+        ensure(24);
+        char* const begin = buf_.data() + pos_;
+        pos_ += static_cast<std::size_t>(std::to_chars(begin, begin + 24, v).ptr - begin);
+    }
+    void integer(std::uint64_t v) {
+        ensure(24);
+        char* const begin = buf_.data() + pos_;
+        pos_ += static_cast<std::size_t>(std::to_chars(begin, begin + 24, v).ptr - begin);
+    }
+    /// formatTimestamp(ns), unquoted.
+    void timestamp(std::int64_t ns);
+
+    /// s in double quotes, '"' doubled (CSV).
+    void csvQuoted(std::string_view s);
+    /// s as a JSON string literal (quotes, backslashes, \n and \r escaped).
+    void jsonString(std::string_view s);
+
+private:
+    /// Longest std::fixed text for a finite double (up to 309 integer digits) at the precisions reports use.
+    static constexpr std::size_t MAX_FIXED_CHARS = 400;
+
+    void ensure(std::size_t n) {
+        if (buf_.size() - pos_ < n) flush();
+    }
+    void flush();
+    void fixedFallback(double v, int precision);
+
+    std::vector<char> buf_;
+    std::size_t pos_{0};
+    std::uint64_t flushed_{0};
+    std::FILE* file_{nullptr};
+    bool ok_{false};
+};
+
+} // namespace backtest
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "bar.hpp"
+#include "bar_series.hpp"
+#include "indicator_cache.hpp"
 #include "order.hpp"
 #include <vector>
 #include <functional>
@@ -14,6 +16,20 @@ public:
     /// Place a market order (executed at next bar open in the simulator).
     virtual void placeOrder(Side side, double quantity) = 0;
 
+    /// Submit a resting order (market, limit, stop or stop-limit; see order.hpp / order_book.hpp). Unlike
+    /// placeOrder it doesn't replace earlier orders: it works from the next bar until filled or cancelled,
+    /// filling intrabar at its price. Returns its id, or 0 if rejected.
+    virtual OrderId submitOrder(const Order& order) = 0;
+
+    /// Entry with a reduce-only stop and target (OCO) that activate once it fills; price <= 0 = no leg.
+    virtual BracketOrderIds submitBracket(const Order& entry, double stop_price, double target_price) = 0;
+
+    /// Cancel a resting order (and its bracket children). Returns false if it already filled or is gone.
+    virtual bool cancelOrder(OrderId id) = 0;
+
+    /// True while the order rests in the book (not yet filled or cancelled).
+    virtual bool isOrderOpen(OrderId id) const = 0;
+
     /// Current position: positive = long, negative = short, 0 = flat.
     virtual double position() const = 0;
 
@@ -29,8 +45,13 @@ public:
     /// Number of bars processed so far (0-based).
     virtual std::size_t barIndex() const = 0;
 
-    /// History of bars up to and including current bar (no look-ahead).
-    virtual const std::vector<Bar>& bars() const = 0;
+    /// History of bars up to and including current bar (no look-ahead): bars().size() == barIndex() + 1.
+    /// Use the column views (bars().closes(), .highs(), ...) for indicator loops; bars()[i] returns a Bar.
+    virtual BarSeriesView bars() const = 0;
+
+    /// Precomputed indicator over this run's whole series, shared through an IndicatorCache; nullptr when
+    /// the run has no cache (compute it yourself). Only read elements <= barIndex(): the rest is future.
+    virtual IndicatorColumnPtr indicator(IndicatorKind /*kind*/, std::size_t /*period*/) const { return nullptr; }
 };
 
 } // namespace backtest
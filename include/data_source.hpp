@@ -1,12 +1,20 @@
 #pragma once
 
 #include "bar.hpp"
+#include "bar_series.hpp"
 #include <vector>
 #include <string>
 #include <optional>
 
 namespace backtest {
 
+struct IntrabarSeries;
+
+/// How DataSource::load() reads a CSV file.
+/// Mapped: mmap the file and parse fields in place (std::from_chars, column indices resolved once from the header).
+/// Stream: std::getline + per-row split; kept as a fallback and as the baseline for bench_csv_load.
+enum class CsvLoadMode { Mapped, Stream };
+
 /// Loads OHLC bars from a CSV file or from Databento glbx folder (filename = data).
 /// CSV: expected columns timestamp/date, open, high, low, close [, volume].
 /// Databento: each file is 0 bytes; filename is comma-separated: ts, ignore, ignore, ignore, o, h, l, c, v, symbol.
@@ -15,34 +23,60 @@ public:
     explicit DataSource(const std::string& filepath);
 
     /// Load bars from CSV file. Returns false on parse error.
-    bool load();
+    /// With the cache on, a valid "<file>.btc" is read instead of parsing, and is (re)written after a parse.
+    bool load(CsvLoadMode mode = CsvLoadMode::Mapped);
 
     /// Load bars from Databento glbx... folder. Each filename = one bar (ts, 3 ignored, o, h, l, c, v, symbol).
     /// Skips empty/invalid filenames. Optional symbol_filter (e.g. "NQU5") to load only that symbol.
-    /// Bars are sorted by timestamp.
+    /// Bars are sorted by timestamp. Goes through a DatabentoIndex: one parallel scan of every symbol (or the
+    /// "<dir>.btc" cache when on and valid). To run many symbols, build the index once and use assign().
     bool loadFromDatabentoDir(const std::string& dir, const std::string& symbol_filter = "");
 
-    /// Discover unique symbols in a Databento dir (parses filenames, symbol at index 9). Returns sorted list; empty if dir missing or no valid filenames.
-    static std::vector<std::string> listSymbolsInDatabentoDir(const std::string& dir);
+    /// Load OHLCV bars from the DBN file at the constructor path (.dbn, or .dbn.zst if built with zstd).
+    /// symbol_filter selects one symbol (case-insensitive); empty = every symbol merged by time.
+    /// Returns false if the file can't be decoded (reason on stderr).
+    bool loadFromDbn(const std::string& symbol_filter = "");
+    /// True for paths ending in .dbn or .dbn.zst (case-insensitive).
+    static bool isDbnPath(const std::string& path);
+
+    /// Use bars already in memory (e.g. one symbol selected from a DatabentoIndex) instead of loading.
+    void assign(BarSeries bars);
+    /// Move the loaded bars out (e.g. into a series shared by a parameter sweep); leaves this source empty.
+    BarSeries release();
 
-    const std::vector<Bar>& bars() const { return bars_; }
+    /// Use the binary bar cache (see bar_cache.hpp) in load()/loadFromDatabentoDir(). Off by default.
+    /// The cache stores each bar's time as the int64 (ns since epoch UTC) parsed from the text once, so cached
+    /// and parsed runs load identical bars.
+    void setUseCache(bool use_cache) { use_cache_ = use_cache; }
+    /// True if the last load was served from a .btc cache.
+    bool loadedFromCache() const { return loaded_from_cache_; }
+
+    const std::string& path() const { return filepath_; }
+    const BarSeries& bars() const { return bars_; }
     std::size_t size() const { return bars_.size(); }
     bool empty() const { return bars_.empty(); }
 
-    /// Get bar at index (0-based). No bounds check in release.
-    const Bar& at(std::size_t i) const { return bars_.at(i); }
+    /// Get bar at index (0-based), assembled from the columns. Throws std::out_of_range.
+    Bar at(std::size_t i) const { return bars_.at(i); }
 
-    /// Aggregate 1m bars into 15m or 1h bars. Resolution: "15m", "1h" (or "1hr"); "1m" = no-op.
-    /// OHLCV: open=first, high=max, low=min, close=last, volume=sum. Bars must be sorted by timestamp.
-    void aggregateBars(const std::string& resolution);
+    /// Aggregate bars to a coarser resolution in one in-place pass: "15m", "4h", "1d", "1d@22:00"
+    /// (see parseBarResolution); "1m" = no-op. OHLCV: open=first, high=max, low=min, close=last,
+    /// volume=sum. Returns false if the resolution is not recognised (bars left untouched).
+    /// intrabar (optional): receives the bars as they were before aggregating, for intrabar fills;
+    /// left empty when there is nothing to aggregate ("1m").
+    bool aggregateBars(const std::string& resolution, IntrabarSeries* intrabar = nullptr);
 
 private:
     std::string filepath_;
-    std::vector<Bar> bars_;
+    BarSeries bars_;
+    bool use_cache_{false};
+    bool loaded_from_cache_{false};
+
+    bool loadStream();
+    bool loadMapped();
 
     std::optional<Bar> parseLine(const std::string& line,
                                  const std::vector<std::string>& headers);
-    std::optional<Bar> parseDatabentoFilename(const std::string& filename);
 };
 
 } // namespace backtest
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "bar.hpp"
+#include "bar_cache.hpp"
+#include "bar_series.hpp"
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace backtest {
+
+class ThreadPool;
+
+/// Every symbol of a Databento glbx directory (one empty file per bar, data in the filename),
+/// read with a single directory scan and held in memory: bars grouped by lower-case symbol, each
+/// group sorted by time — the same layout as the .btc cache, which is loaded instead when valid.
+/// Can also be filled from a DBN file. Build once, then serve any number of per-symbol backtests from it.
+class DatabentoIndex {
+public:
+    /// Scan dir once, parsing filenames in parallel on pool (a temporary pool if null).
+    /// With use_cache, a valid "<dir>.btc" is mapped instead, and is (re)written after a scan.
+    /// Returns false if dir is not a directory.
+    bool build(const std::string& dir, bool use_cache, ThreadPool* pool = nullptr);
+
+    /// Decode a DBN OHLCV file (see DbnDecoder) into the index; symbols come from the file's
+    /// instrument-id mappings (the id itself when unmapped). Errors go to stderr; returns false.
+    bool buildFromDbn(const std::string& path, ThreadPool* pool = nullptr);
+
+    /// Symbols (lower-case, sorted) and where their bars sit in bars().
+    const std::vector<SymbolRange>& symbols() const { return symbols_; }
+    std::vector<std::string> symbolNames() const;
+    const BarSeries& bars() const { return bars_; }
+    bool loadedFromCache() const { return loaded_from_cache_; }
+
+    /// Replace out with one symbol's bars (case-insensitive), or every symbol merged by time
+    /// (stable) when symbol is empty. Returns false (out empty) if the symbol is not in the index.
+    bool select(const std::string& symbol, BarSeries& out) const;
+
+    /// Parse "ts,_,_,_,open,high,low,close,volume,symbol[,...]". symbol points into filename.
+    static bool parseFilename(std::string_view filename, Bar& bar, std::string_view& symbol);
+
+private:
+    /// Sort each symbol's bars by time and lay them out grouped by symbol in bars_/symbols_.
+    void assemble(std::map<std::string, std::vector<Bar>>& by_symbol, ThreadPool& pool);
+
+    BarSeries bars_;
+    std::vector<SymbolRange> symbols_;
+    bool loaded_from_cache_{false};
+};
+
+} // namespace backtest
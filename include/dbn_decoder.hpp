@@ -0,0 +1,98 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace backtest {
+
+/// Constants from the DBN (Databento Binary Encoding) spec used by DbnDecoder.
+namespace dbn {
+constexpr std::uint8_t RTYPE_OHLCV_DEPRECATED = 0x11;
+constexpr std::uint8_t RTYPE_OHLCV_1S = 0x20;
+constexpr std::uint8_t RTYPE_OHLCV_1M = 0x21;
+constexpr std::uint8_t RTYPE_OHLCV_1H = 0x22;
+constexpr std::uint8_t RTYPE_OHLCV_1D = 0x23;
+constexpr std::uint8_t RTYPE_OHLCV_EOD = 0x24;
+constexpr std::uint8_t STYPE_INSTRUMENT_ID = 0;
+constexpr std::int64_t UNDEF_PRICE = std::numeric_limits<std::int64_t>::max();
+constexpr double PRICE_SCALE = 1e9;  // prices are fixed-point int64 in units of 1e-9
+constexpr std::size_t HEADER_SIZE = 16;
+constexpr std::size_t OHLCV_SIZE = 56;
+} // namespace dbn
+
+/// One symbology interval from the metadata: symbol <-> instrument id over [start_date, end_date).
+struct DbnMapping {
+    std::uint32_t instrument_id{0};
+    std::uint32_t start_date{0};  // YYYYMMDD (UTC)
+    std::uint32_t end_date{0};
+    std::string symbol;
+};
+
+/// Metadata header of a DBN stream (fields this engine uses).
+struct DbnMetadata {
+    std::uint8_t version{0};
+    std::string dataset;
+    std::uint16_t schema{0};
+    std::uint64_t start{0};  // ns since epoch
+    std::uint64_t end{0};
+    std::uint8_t stype_in{0};
+    std::uint8_t stype_out{0};
+    bool ts_out{false};
+    std::vector<std::string> symbols;
+    std::vector<DbnMapping> mappings;
+};
+
+/// One OHLCV record, prices converted from fixed point.
+struct DbnOhlcv {
+    std::uint8_t rtype{0};
+    std::uint32_t instrument_id{0};
+    std::int64_t ts_event{0};  // bar open, ns since epoch UTC
+    double open{0}, high{0}, low{0}, close{0}, volume{0};
+};
+
+/// Dependency-free reader for DBN files (versions 1-3) holding OHLCV records.
+/// The file is memory-mapped and decoded in place, one record at a time. If compiled with
+/// BACKTEST_HAVE_ZSTD, zstd-framed files (.dbn.zst) are inflated into memory first; otherwise
+/// open() fails on them with an explanatory error().
+///
+/// Layout (little-endian): "DBN" + version byte, u32 metadata length, 100-byte fixed section,
+/// then symbol lists and symbology mappings; after that, records of `length * 4` bytes, each
+/// starting with a 16-byte header (length, rtype, publisher_id, instrument_id, ts_event).
+class DbnDecoder {
+public:
+    /// Map (and, if needed, inflate) a DBN file and parse its metadata.
+    bool open(const std::string& path);
+    /// Decode from a caller-owned buffer, which must outlive the decoder.
+    bool openBuffer(const char* data, std::size_t size);
+
+    const DbnMetadata& metadata() const { return meta_; }
+    /// Why open()/next() failed; empty otherwise.
+    const std::string& error() const { return error_; }
+
+    /// Next OHLCV record. Other record types and bars with an undefined price are skipped.
+    /// Returns false at end of data, or on a truncated/corrupt record (error() is set).
+    bool next(DbnOhlcv& out);
+
+    /// Symbol for an instrument id on the record's UTC date, from the metadata mappings.
+    /// Empty if the id is not mapped.
+    std::string_view symbolFor(std::uint32_t instrument_id, std::int64_t ts_event) const;
+
+private:
+    bool parseMetadata();
+    bool fail(const std::string& msg);
+
+    MappedFile file_;
+    std::vector<char> inflated_;
+    const unsigned char* pos_{nullptr};
+    const unsigned char* end_{nullptr};
+    DbnMetadata meta_;
+    std::unordered_map<std::uint32_t, std::vector<std::size_t>> by_id_;  // indices into meta_.mappings
+    std::string error_;
+};
+
+} // namespace backtest
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "bar_series.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace backtest {
+
+/// Close-price indicators the cache can precompute.
+enum class IndicatorKind : std::uint8_t { Sma, Ema };
+
+/// One indicator over a whole series: element i is the value after bar i, identical to the streaming
+/// class in indicators.hpp (Sma, Ema) fed closes 0..i.
+using IndicatorColumn = AlignedVector<double>;
+using IndicatorColumnPtr = std::shared_ptr<const IndicatorColumn>;
+
+/// Full indicator columns keyed by (series id, indicator, period), computed once and shared by every
+/// strategy and run that asks for them — CTM's repeated SMAs, the runs of a sweep — with an LRU byte
+/// budget. Eviction only drops the cache's reference: a run holding a column keeps it alive.
+/// Thread-safe; concurrent requests for the same missing column compute it once.
+class IndicatorCache {
+public:
+    static constexpr std::size_t DEFAULT_BUDGET_BYTES = std::size_t(512) << 20;
+
+    explicit IndicatorCache(std::size_t budget_bytes = DEFAULT_BUDGET_BYTES) : budget_(budget_bytes) {}
+
+    IndicatorCache(const IndicatorCache&) = delete;
+    IndicatorCache& operator=(const IndicatorCache&) = delete;
+
+    /// A process-unique id for a series. The caller keeps the id <-> series pairing: the cache never
+    /// looks at bars it already has a column for, so give a series a new id if it changes (a window of a
+    /// series is a different series: its indicators start over at the window's first bar).
+    static std::uint64_t newSeriesId();
+
+    /// Column of kind(period) over bars' closes; computed on a miss. period 0 is treated as 1.
+    IndicatorColumnPtr get(std::uint64_t series_id, BarSeriesView bars, IndicatorKind kind, std::size_t period);
+    IndicatorColumnPtr get(std::uint64_t series_id, const BarSeries& bars, IndicatorKind kind, std::size_t period) {
+        return get(series_id, bars.view(), kind, period);
+    }
+
+    std::size_t budgetBytes() const { return budget_; }
+    std::size_t bytesUsed() const;
+    std::size_t hits() const { return hits_.load(); }
+    std::size_t misses() const { return misses_.load(); }
+
+private:
+    struct Key {
+        std::uint64_t series;
+        IndicatorKind kind;
+        std::size_t period;
+        bool operator==(const Key& o) const { return series == o.series && kind == o.kind && period == o.period; }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const {
+            std::uint64_t h = k.series * 0x9E3779B97F4A7C15ull;
+            h ^= (static_cast<std::uint64_t>(k.period) << 8 | static_cast<std::uint64_t>(k.kind)) + (h << 6) + (h >> 2);
+            return static_cast<std::size_t>(h);
+        }
+    };
+    struct Entry {
+        std::shared_future<IndicatorColumnPtr> column;
+        std::size_t bytes{0};                 // 0 while being computed
+        std::list<Key>::iterator lru;         // position in lru_ (front = most recent)
+    };
+
+    static IndicatorColumnPtr compute(BarSeriesView bars, IndicatorKind kind, std::size_t period);
+    void evictLocked();
+
+    std::size_t budget_;
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, Entry, KeyHash> entries_;
+    std::list<Key> lru_;
+    std::size_t used_{0};
+    std::atomic<std::size_t> hits_{0};
+    std::atomic<std::size_t> misses_{0};
+};
+
+} // namespace backtest
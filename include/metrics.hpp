@@ -0,0 +1,130 @@
+#pragma once
+
+#include "simulator.hpp"
+#include <cmath>
+#include <cstddef>
+
+namespace backtest {
+
+/// Backtest metrics for reporting.
+struct BacktestMetrics {
+    double total_return_pct{0};   // (final_equity - initial) / initial * 100
+    double max_drawdown_pct{0};   // max peak-to-trough decline %
+    double sharpe_ratio{0};       // annualized Sharpe (0 if < 2 bars)
+    int num_trades{0};            // closed round-trip trades only
+    int winning_trades{0};
+    double win_rate_pct{0};
+    double avg_trade_pnl{0};
+    double initial_equity{0};
+    double final_equity{0};
+    double open_position{0};       // shares at end (+ long, - short); 0 = flat
+    double unrealized_pnl{0};     // mark-to-market P&L on open position
+    double sortino_ratio{0};      // annualized mean return / downside deviation (0 if no down bars)
+    double calmar_ratio{0};       // total_return_pct / max_drawdown_pct (not annualized; 0 if no drawdown)
+    double exposure_pct{0};       // % of bars closed with a position (MetricsAccumulator only)
+};
+
+/// m with open_position / unrealized_pnl filled in from sim's position, marked at its last close.
+inline BacktestMetrics withOpenPosition(BacktestMetrics m, const Simulator& sim) {
+    const double pos = sim.position();
+    m.open_position = pos;
+    if (std::abs(pos) >= 1e-9 && sim.lastClose() > 0)
+        m.unrealized_pnl = pos * (sim.lastClose() - sim.avgEntryPrice());
+    return m;
+}
+
+/// Annualization of per-bar Sharpe / Sortino (trading days per year, whatever the bar size).
+constexpr double TRADING_DAYS_PER_YEAR = 252.0;
+
+/// The metrics of computeCurveMetrics, updated one bar at a time so nothing has to be stored: Welford
+/// mean / variance of the bar-to-bar returns, running peak and drawdown, downside deviation, exposure
+/// and trade stats. Same definitions as computeCurveMetrics (peak starts at the first curve point);
+/// only Sharpe / Sortino may differ from it in the last bits.
+class MetricsAccumulator {
+public:
+    explicit MetricsAccumulator(double initial_cash = 0) { reset(initial_cash); }
+
+    void reset(double initial_cash) {
+        initial_cash_ = initial_cash;
+        last_ = initial_cash;
+        bars_ = 0;
+        in_market_ = 0;
+        returns_ = 0;
+        mean_ = m2_ = down_sq_ = 0;
+        peak_ = max_dd_ = 0;
+        trades_ = wins_ = 0;
+        total_pnl_ = 0;
+    }
+
+    /// One equity curve point (equity at the bar's close) and the position held over it.
+    void addBar(double equity, double position) {
+        if (bars_ == 0) {
+            peak_ = equity;
+        } else {
+            const double r = (last_ != 0) ? (equity - last_) / last_ : 0;
+            ++returns_;
+            const double delta = r - mean_;
+            mean_ += delta / static_cast<double>(returns_);
+            m2_ += delta * (r - mean_);
+            if (r < 0) down_sq_ += r * r;
+            if (equity > peak_) peak_ = equity;
+        }
+        const double dd = (peak_ != 0) ? (peak_ - equity) / peak_ * 100.0 : 0;
+        if (dd > max_dd_) max_dd_ = dd;
+        if (position != 0) ++in_market_;
+        last_ = equity;
+        ++bars_;
+    }
+
+    /// One closed trade (Simulator::trades() order).
+    void addTrade(const Trade& t) {
+        ++trades_;
+        if (t.pnl > 0) ++wins_;
+        total_pnl_ += t.pnl;
+    }
+
+    std::size_t bars() const { return bars_; }
+    std::size_t barsInMarket() const { return in_market_; }
+    int numTrades() const { return trades_; }
+    double lastEquity() const { return last_; }
+
+    /// Metrics so far, final equity = the last curve point (initial cash before any).
+    /// open_position / unrealized_pnl are left 0.
+    BacktestMetrics metrics() const {
+        BacktestMetrics m;
+        m.initial_equity = initial_cash_;
+        m.final_equity = last_;
+        m.total_return_pct = (initial_cash_ != 0) ? ((last_ - initial_cash_) / initial_cash_) * 100.0 : 0;
+        m.max_drawdown_pct = max_dd_;
+        if (returns_ > 0) {
+            const double stddev = (returns_ > 1) ? std::sqrt(m2_ / static_cast<double>(returns_ - 1)) : 0;
+            m.sharpe_ratio = (stddev != 0) ? (mean_ / stddev) * std::sqrt(TRADING_DAYS_PER_YEAR) : 0;
+            const double down_dev = std::sqrt(down_sq_ / static_cast<double>(returns_));
+            m.sortino_ratio = (down_dev != 0) ? (mean_ / down_dev) * std::sqrt(TRADING_DAYS_PER_YEAR) : 0;
+        }
+        m.calmar_ratio = (max_dd_ != 0) ? m.total_return_pct / max_dd_ : 0;
+        m.exposure_pct = (bars_ > 0) ? 100.0 * static_cast<double>(in_market_) / static_cast<double>(bars_) : 0;
+        m.num_trades = trades_;
+        m.winning_trades = wins_;
+        m.win_rate_pct = (trades_ > 0) ? (100.0 * wins_ / trades_) : 0;
+        m.avg_trade_pnl = (trades_ > 0) ? (total_pnl_ / trades_) : 0;
+        return m;
+    }
+
+private:
+    double initial_cash_{0};
+    double last_{0};
+    std::size_t bars_{0};
+    std::size_t in_market_{0};
+    std::size_t returns_{0};
+    double mean_{0};
+    double m2_{0};
+    double down_sq_{0};
+    double peak_{0};
+    double max_dd_{0};
+    int trades_{0};
+    int wins_{0};
+    double total_pnl_{0};
+};
+
+} // namespace backtest
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "simulator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+class ThreadPool;
+
+/// How a path draws its trades from the run's closed trades.
+/// Bootstrap: as many draws as there are trades, with replacement (the return varies from path to path).
+/// Shuffle: the same trades in a random order (the return is fixed; drawdown depends on the order).
+enum class MonteCarloMethod { Bootstrap, Shuffle };
+
+/// "bootstrap" or "shuffle". Returns false for anything else.
+bool parseMonteCarloMethod(const std::string& name, MonteCarloMethod& out);
+
+inline const char* monteCarloMethodName(MonteCarloMethod method) {
+    return method == MonteCarloMethod::Shuffle ? "shuffle" : "bootstrap";
+}
+
+struct MonteCarloOptions {
+    std::size_t paths{10000};
+    MonteCarloMethod method{MonteCarloMethod::Bootstrap};
+    /// Resample each trade's return on the closed-trade equity it was opened with (for strategies sized as
+    /// a fraction of equity) instead of its P&L in cash (fixed-size strategies).
+    bool compound{false};
+    std::uint64_t seed{1};  // same seed, same paths, whatever the thread count
+};
+
+/// Per path: total return % and max drawdown % of the closed-trade equity (starting cash, then equity
+/// after each trade; peak starts at the starting cash). Path k is at index k.
+struct MonteCarloPaths {
+    std::vector<double> return_pct;
+    std::vector<double> max_drawdown_pct;
+};
+
+/// Simulate options.paths equity paths from trades (Simulator::trades() order), in parallel on pool.
+/// Paths run in groups of lanes whose equity / peak / drawdown live in arrays updated a lane at a time
+/// (loops the compiler vectorizes); each path has its own splitmix64 stream seeded from (seed, path), so
+/// results don't depend on how paths are spread over threads. Empty if there are no trades or
+/// initial_cash <= 0.
+MonteCarloPaths runMonteCarlo(const std::vector<Trade>& trades, double initial_cash,
+                              const MonteCarloOptions& options, ThreadPool& pool);
+
+/// Percentiles reported by MonteCarloSummary.
+constexpr std::size_t MONTE_CARLO_PERCENTILE_COUNT = 7;
+constexpr double MONTE_CARLO_PERCENTILES[MONTE_CARLO_PERCENTILE_COUNT] = { 1, 5, 25, 50, 75, 95, 99 };
+
+/// Distribution of runMonteCarlo's paths: percentile k of the return and of the max drawdown is the value
+/// MONTE_CARLO_PERCENTILES[k] % of the way through the sorted paths (same rule as PruneBoard).
+struct MonteCarloSummary {
+    std::size_t paths{0};
+    std::size_t trades{0};
+    MonteCarloMethod method{MonteCarloMethod::Bootstrap};
+    bool compound{false};
+    double return_pct[MONTE_CARLO_PERCENTILE_COUNT]{};
+    double max_drawdown_pct[MONTE_CARLO_PERCENTILE_COUNT]{};
+    double mean_return_pct{0};
+    double loss_probability_pct{0};  // paths ending below the starting cash
+    double ruin_probability_pct{0};  // paths whose equity reached 0 (max drawdown >= 100%)
+};
+
+MonteCarloSummary summarizeMonteCarlo(const MonteCarloPaths& paths, std::size_t trades, const MonteCarloOptions& options);
+
+} // namespace backtest
@@ -6,13 +6,29 @@ namespace backtest {
 
 enum class Side { Long, Short };
 
-enum class OrderType { Market, Limit };
+enum class OrderType { Market, Limit, Stop, StopLimit };
+
+using OrderId = std::uint64_t;  // 0 = no order
 
 struct Order {
     Side side{Side::Long};
     double quantity{0};
     OrderType type{OrderType::Market};
-    double limit_price{0};  // used if type == Limit
+    double limit_price{0};  // used if type == Limit or StopLimit
+    double stop_price{0};   // used if type == Stop or StopLimit (trigger)
+
+    // Resting orders (Simulator::submitOrder); ignored by placeOrder.
+    OrderId id{0};          // assigned on submit
+    OrderId oco_group{0};   // orders sharing a non-zero group (e.g. the first one's id) are one-cancels-other
+    OrderId parent_id{0};   // inactive until this order fills; cancelled with it
+    bool reduce_only{false};  // only shrinks the position: clipped to it, dropped when flat
+};
+
+/// Ids of an entry order with its protective stop and profit target (0 = leg not placed).
+struct BracketOrderIds {
+    OrderId entry{0};
+    OrderId stop{0};
+    OrderId target{0};
 };
 
 } // namespace backtest
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "bar.hpp"
+#include "order.hpp"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace backtest {
+
+/// Resting orders of one symbol (market, limit, stop, stop-limit; OCO groups and bracket children),
+/// matched against each bar's OHLC. Within a bar price is assumed to travel
+///   open -> low -> high -> close   when close >= open,
+///   open -> high -> low -> close   otherwise,
+/// and orders fill in the order that path reaches them:
+/// - limit: at the limit price, or at the price the order became active at if already better (gap);
+/// - stop: at the stop price, or the price it became active at if already through it (gap), plus slippage;
+/// - stop-limit: the stop arms a limit, which then fills as a limit from that point on;
+/// - market: at the price it became active at (the open), plus slippage.
+/// Ties go to stops/market before limits (conservative for brackets), then to the older order.
+/// A fill cancels the rest of its OCO group and activates its children from that point of the bar,
+/// so a bracket's stop or target can fill in the same bar as its entry.
+class OrderBook {
+public:
+    /// Called for each fill with the order and its price (slippage included). Return false when it
+    /// could not be filled (e.g. reduce-only while flat): it is dropped and its children cancelled.
+    using FillFn = std::function<bool(const Order& order, double price)>;
+
+    /// Add an order; it takes part from the next match(). Returns its id, or 0 if rejected (quantity <= 0,
+    /// missing limit / stop price, or parent_id not in the book).
+    OrderId submit(Order order);
+
+    /// Entry plus reduce-only stop and target children in one OCO group; stop_price / target_price
+    /// <= 0 leave that leg out. Returns zeros if the entry is rejected.
+    BracketOrderIds submitBracket(const Order& entry, double stop_price, double target_price);
+
+    /// Remove an order and its children. Returns false if it was not in the book.
+    bool cancel(OrderId id);
+    void clear() { orders_.clear(); }
+
+    /// The order with this id, or nullptr once it has filled or been cancelled.
+    const Order* find(OrderId id) const;
+    bool contains(OrderId id) const { return find(id) != nullptr; }
+    bool empty() const { return orders_.empty(); }
+    std::size_t size() const { return orders_.size(); }
+
+    /// Fill whatever this bar reaches. slippage: fraction of price, applied against the order's side
+    /// to market and stop fills.
+    void match(const Bar& bar, double slippage, const FillFn& fill);
+
+private:
+    struct Resting {
+        Order order;
+        double from{0};        // path position (0 = open .. 3 = close) it became active at in this bar
+        double from_price{0};  // price at that position
+    };
+
+    void cancelChildren(OrderId parent);
+    void removeGroup(OrderId oco_group);
+
+    std::vector<Resting> orders_;  // in submission order (ids ascending)
+    OrderId next_id_{1};
+};
+
+} // namespace backtest
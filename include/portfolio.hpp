@@ -0,0 +1,133 @@
+#pragma once
+
+#include "bar.hpp"
+#include "bar_series.hpp"
+#include "order.hpp"
+#include "report.hpp"
+#include "simulator.hpp"
+#include "strategy.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace backtest {
+
+/// What a portfolio strategy sees: one account, many symbols (indices 0..symbolCount()-1).
+/// Per-symbol calls mirror IContext; equity() / cash() are the whole account's.
+class IPortfolioContext {
+public:
+    virtual ~IPortfolioContext() = default;
+
+    virtual std::size_t symbolCount() const = 0;
+    virtual const std::string& symbolName(std::size_t symbol) const = 0;
+
+    /// Timestamp of the bars being dispatched (ns since epoch).
+    virtual std::int64_t time() const = 0;
+
+    virtual void placeOrder(std::size_t symbol, Side side, double quantity) = 0;
+    virtual OrderId submitOrder(std::size_t symbol, const Order& order) = 0;
+    virtual BracketOrderIds submitBracket(std::size_t symbol, const Order& entry, double stop_price, double target_price) = 0;
+    virtual bool cancelOrder(std::size_t symbol, OrderId id) = 0;
+    virtual bool isOrderOpen(std::size_t symbol, OrderId id) const = 0;
+
+    virtual double position(std::size_t symbol) const = 0;
+    virtual double lastClose(std::size_t symbol) const = 0;
+    /// Index of the symbol's latest bar seen so far (0-based).
+    virtual std::size_t barIndex(std::size_t symbol) const = 0;
+    /// The symbol's bars up to and including its latest one seen (no look-ahead).
+    virtual BarSeriesView bars(std::size_t symbol) const = 0;
+
+    /// Account equity: cash plus every position at its latest price.
+    virtual double equity() const = 0;
+    virtual double cash() const = 0;
+};
+
+/// Strategy over several symbols sharing one account. Bars arrive in time order across symbols;
+/// bars with the same timestamp are dispatched in symbol order, after all their fills.
+class IPortfolioStrategy {
+public:
+    virtual ~IPortfolioStrategy() = default;
+
+    virtual void onBar(std::size_t symbol, const Bar& bar, IPortfolioContext& ctx) = 0;
+    virtual void onStart(IPortfolioContext& /*ctx*/) {}
+    virtual void onEnd(IPortfolioContext& /*ctx*/) {}
+};
+
+/// Run one single-symbol strategy per symbol on the shared account: each gets an IContext for its
+/// symbol whose equity() / cash() are the account's, so position sizing sees the whole portfolio.
+using SymbolStrategyFactory = std::function<std::unique_ptr<IStrategy>(const std::string& symbol)>;
+std::unique_ptr<IPortfolioStrategy> createPerSymbolStrategy(SymbolStrategyFactory factory);
+
+/// Backtests many symbols against one cash account. The symbols' bar streams are k-way merged by
+/// timestamp with a heap of per-symbol cursors (no pre-merged copy, no allocation per event); each
+/// symbol keeps its own Simulator (order book, position), and their cash is pooled.
+/// For each timestamp: fill every due symbol's orders at its open, stop if the account is wiped out,
+/// dispatch onBar per symbol, mark to the closes, and record one point on the account equity curve.
+/// Stops early like Backtester (equity <= 0 or 100% drawdown).
+class PortfolioBacktester {
+public:
+    PortfolioBacktester(std::unique_ptr<IPortfolioStrategy> strategy,
+                        double initial_cash = 100000.0,
+                        double commission = 0.0,
+                        double slippage = 0.0);
+    ~PortfolioBacktester();
+
+    /// Add a symbol's bars (aggregated, sorted by time; shared, never copied). Returns its index.
+    std::size_t addSymbol(const std::string& name, std::shared_ptr<const BarSeries> bars);
+
+    /// Run the merged stream. Returns false if no symbol has bars.
+    bool run();
+
+    std::size_t symbolCount() const { return symbols_.size(); }
+    const std::string& symbolName(std::size_t symbol) const { return symbols_[symbol].name; }
+    const BarSeries& bars(std::size_t symbol) const { return *symbols_[symbol].bars; }
+    const Simulator& simulator(std::size_t symbol) const { return symbols_[symbol].sim; }
+
+    /// Account equity after each timestamp, and those timestamps.
+    const std::vector<double>& equityCurve() const { return equity_curve_; }
+    const std::vector<std::int64_t>& equityTimes() const { return equity_times_; }
+    double equity() const { return equity_; }
+    double cash() const { return cash_; }
+
+    /// Metrics over the account curve and every symbol's closed trades; unrealized_pnl sums the open
+    /// positions (open_position is left 0: positions are per symbol).
+    BacktestMetrics computeMetrics() const;
+
+    bool stoppedEarly() const { return stopped_early_; }
+    const std::string& stopReason() const { return stop_reason_; }
+
+private:
+    class Context;
+    friend class Context;
+
+    struct Symbol {
+        std::string name;
+        std::shared_ptr<const BarSeries> bars;
+        Simulator sim;
+        std::size_t next{0};    // bars dispatched so far
+        double value{0};        // sim cash + position at its latest price (its part of the account)
+    };
+
+    double symbolValue(const Symbol& s, double price) const { return s.sim.cash() + s.sim.position() * price; }
+
+    std::unique_ptr<IPortfolioStrategy> strategy_;
+    double initial_cash_;
+    double commission_;
+    double slippage_;
+    std::vector<Symbol> symbols_;
+    std::vector<std::pair<std::int64_t, std::size_t>> heap_;  // (next bar time, symbol), min-heap
+    std::vector<std::size_t> due_;                            // symbols with a bar at the current time
+    std::int64_t now_{0};
+    double cash_;
+    double equity_;
+    std::vector<double> equity_curve_;
+    std::vector<std::int64_t> equity_times_;
+    bool stopped_early_{false};
+    std::string stop_reason_;
+};
+
+} // namespace backtest
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "metrics.hpp"
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+/// Kill criteria for optimization runs, checked at each bar's close after the built-in stops (equity <= 0,
+/// 100% drawdown). 0 turns a criterion off. A pruned run stops like an early stop: its metrics cover the
+/// bars up to the stop and its stop reason starts with "pruned".
+struct PruneCriteria {
+    double max_drawdown_pct{0};    // stop once drawdown from the peak (initial cash or above) exceeds this
+    std::size_t no_trade_bars{0};  // stop if no position was ever held after this many bars
+    /// At each of `checkpoints` evenly spaced bars, stop if equity is below this percentile (0..100) of the
+    /// equity completed runs had there. Needs a PruneBoard shared by the runs; applies once min_completed
+    /// runs reached the checkpoint, so it depends on which runs finish first.
+    double equity_percentile{0};
+    std::size_t checkpoints{10};
+    std::size_t min_completed{8};
+
+    bool any() const { return max_drawdown_pct > 0 || no_trade_bars > 0 || equity_percentile > 0; }
+};
+
+/// Checkpoint equities of the runs that finished without being pruned, shared by a sweep's runs
+/// (thread-safe). Each checkpoint's values are kept sorted.
+class PruneBoard {
+public:
+    explicit PruneBoard(std::size_t checkpoints) : equities_(checkpoints) {}
+
+    /// equities[k] = a run's equity at checkpoint k (shorter if it stopped before the last one).
+    void record(const std::vector<double>& equities);
+
+    /// Equity at percentile pct of the recorded runs at checkpoint k (nearest rank below). Returns false
+    /// if fewer than min_runs reached it.
+    bool percentile(std::size_t k, double pct, std::size_t min_runs, double& out) const;
+
+    std::size_t checkpoints() const { return equities_.size(); }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::vector<double>> equities_;
+};
+
+/// PruneCriteria for one run over `bars` bars, evaluated by the bar loop (see runBarLoop).
+class RunPruner {
+public:
+    /// board may be null (equity_percentile is then ignored); it must have criteria.checkpoints entries.
+    RunPruner(const PruneCriteria& criteria, std::size_t bars, PruneBoard* board);
+
+    /// After bar i's close with equity and the loop's drawdown %. True = stop the run (reason set).
+    bool check(std::size_t i, double equity, double drawdown_pct, const MetricsAccumulator& metrics,
+               std::string& reason) {
+        if (criteria_.max_drawdown_pct > 0 && drawdown_pct > criteria_.max_drawdown_pct)
+            return prune(reason, "pruned: drawdown");
+        if (i + 1 == criteria_.no_trade_bars && metrics.barsInMarket() == 0 && metrics.numTrades() == 0)
+            return prune(reason, "pruned: no trades");
+        if (i == next_checkpoint_) return checkpoint(equity, reason);
+        return false;
+    }
+
+    /// The run ended without being pruned: share its checkpoint equities on the board.
+    void finish();
+
+    bool pruned() const { return pruned_; }
+
+private:
+    bool prune(std::string& reason, const char* why) {
+        pruned_ = true;
+        reason = why;
+        return true;
+    }
+    bool checkpoint(double equity, std::string& reason);
+
+    PruneCriteria criteria_;
+    std::size_t bars_;
+    PruneBoard* board_;
+    std::vector<double> equities_;  // this run's equity at each checkpoint reached
+    std::size_t next_checkpoint_;   // bar index of the next checkpoint; SIZE_MAX when none
+    bool pruned_{false};
+};
+
+} // namespace backtest
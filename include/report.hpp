@@ -1,37 +1,32 @@
 #pragma once
 
+#include "metrics.hpp"
+#include "monte_carlo.hpp"
 #include "simulator.hpp"
-#include "data_source.hpp"
+#include "bar_series.hpp"
 #include <string>
+#include <vector>
 #include <ostream>
 #include <iostream>
 
 namespace backtest {
 
-/// Backtest metrics for reporting.
-struct BacktestMetrics {
-    double total_return_pct{0};   // (final_equity - initial) / initial * 100
-    double max_drawdown_pct{0};   // max peak-to-trough decline %
-    double sharpe_ratio{0};       // annualized Sharpe (0 if < 2 bars)
-    int num_trades{0};            // closed round-trip trades only
-    int winning_trades{0};
-    double win_rate_pct{0};
-    double avg_trade_pnl{0};
-    double initial_equity{0};
-    double final_equity{0};
-    double open_position{0};       // shares at end (+ long, - short); 0 = flat
-    double unrealized_pnl{0};     // mark-to-market P&L on open position
-};
+/// Return, drawdown, Sharpe / Sortino / Calmar and trade statistics from an equity curve (one point per
+/// bar) and the closed trades; open_position / unrealized_pnl / exposure_pct are left 0. Shared by Report and PortfolioBacktester.
+BacktestMetrics computeCurveMetrics(const std::vector<double>& curve, const std::vector<Trade>& trades,
+                                    double initial_cash, double final_equity);
 
 class Report {
 public:
     /// strategy_name and strategy_params are included in report output (e.g. "sma_crossover", "fast=10 slow=30").
-    Report(const Simulator& sim, const DataSource& data, double initial_cash,
+    /// bars: the series the simulator ran on (bar i <-> equity curve point i).
+    Report(const Simulator& sim, const BarSeries& bars, double initial_cash,
            const std::string& strategy_name = "",
            const std::string& strategy_params = "");
 
 private:
     void printReportHeader(std::ostream& out) const;
+    void printMonteCarlo(std::ostream& out) const;
 
 public:
 
@@ -54,19 +49,42 @@ public:
     bool writeSessionJson(const std::string& filepath,
                           const std::string& symbol_or_label = "") const;
 
+    /// Write bars + trades for the chart viewer as a level-of-detail file (session.lod): the bars at their
+    /// own resolution plus a buildLodPyramid of coarser levels, and the trades, in chunks the viewer reads
+    /// by byte offset so it only parses what the visible range needs. Returns false on failure.
+    bool writeSessionLod(const std::string& filepath,
+                         const std::string& symbol_or_label = "") const;
+
+    /// Write bars, trades and the equity curve as binary columns for the chart viewer (session.bin), which
+    /// maps them straight into typed arrays instead of parsing text. Returns false on failure.
+    ///
+    /// Layout (host byte order, little-endian on every supported platform; the endian marker tells):
+    /// 64-byte header (magic "BTSESS", version, endian marker 0x01020304, bar / trade / equity counts,
+    /// symbol / strategy / params byte lengths, column offset); the three UTF-8 strings; then 64-byte-aligned
+    /// columns: bars as int64 time (ns since epoch UTC), double open, high, low, close, volume; trades as
+    /// int64 entry_time, exit_time, side (1 long, -1 short), double entry_price, exit_price, quantity, pnl;
+    /// double equity (point i = equity at bar i's close).
+    bool writeSessionBinary(const std::string& filepath,
+                            const std::string& symbol_or_label = "") const;
+
     void setMetrics(const BacktestMetrics& m) { metrics_ = m; }
     const BacktestMetrics& metrics() const { return metrics_; }
 
     void setStoppedReason(const std::string& reason) { stopped_reason_ = reason; }
 
+    /// Trade-resampling percentiles (runMonteCarlo) for the summary and report.txt; not shown unless set.
+    void setMonteCarlo(const MonteCarloSummary& mc) { monte_carlo_ = mc; }
+    const MonteCarloSummary& monteCarlo() const { return monte_carlo_; }
+
 private:
     const Simulator& sim_;
-    const DataSource& data_;
+    const BarSeries& bars_;
     double initial_cash_;
     std::string strategy_name_;
     std::string strategy_params_;
     std::string stopped_reason_;
     BacktestMetrics metrics_;
+    MonteCarloSummary monte_carlo_;
 };
 
 } // namespace backtest
@@ -1,17 +1,19 @@
 #pragma once
 
 #include "bar.hpp"
+#include "bar_series.hpp"
 #include "order.hpp"
+#include "order_book.hpp"
 #include <vector>
-#include <string>
 #include <cstddef>
+#include <cstdint>
 
 namespace backtest {
 
 /// Single filled trade for reporting.
 struct Trade {
-    std::string entry_time;
-    std::string exit_time;
+    std::int64_t entry_time{0};  // ns since epoch (see timestamp.hpp)
+    std::int64_t exit_time{0};
     Side side{Side::Long};
     double quantity{0};
     double entry_price{0};
@@ -22,18 +24,34 @@ struct Trade {
 
 /// Simulates order execution and tracks positions, cash, and equity.
 /// Orders placed during bar N are filled at bar N+1 open (avoids look-ahead).
-/// At most one order can be pending at a time: placing a new order overwrites any previous pending order for the next bar.
-/// Slippage: fraction of fill price (e.g. 0.001 = 0.1%). Longs fill at open*(1+slippage), shorts at open*(1-slippage).
+/// placeOrder keeps one pending market order: placing a new one overwrites it for the next bar.
+/// submitOrder adds resting orders (limit, stop, stop-limit, market; OCO and brackets) to an OrderBook;
+/// from the next bar they fill where that bar's OHLC reaches them (see order_book.hpp), after the
+/// placeOrder fill at the open.
+/// Slippage: fraction of fill price (e.g. 0.001 = 0.1%). Longs fill at open*(1+slippage), shorts at open*(1-slippage);
+/// resting market and stop orders pay it too, limits don't.
 class Simulator {
 public:
     Simulator(double initial_cash = 100000.0, double commission_per_trade = 0.0, double slippage_fraction = 0.0);
 
-    /// Process pending order: fill at current bar's open (with slippage applied).
+    /// Process pending order: fill at current bar's open (with slippage applied), then resting orders.
     void processOrders(const Bar& bar);
 
+    /// Same, but resting orders are matched against intrabar (the finer bars bar was aggregated from,
+    /// in order) instead of bar's own OHLC: fills get the finer path's prices. Trades keep bar's time.
+    void processOrders(const Bar& bar, const BarSeriesView& intrabar);
+
     /// Add order to be filled on next bar. Overwrites any existing pending order.
     void placeOrder(Side side, double quantity);
 
+    /// Resting orders (see OrderBook). Returns the order id, or 0 if rejected.
+    OrderId submitOrder(const Order& order) { return book_.submit(order); }
+    BracketOrderIds submitBracket(const Order& entry, double stop_price, double target_price) {
+        return book_.submitBracket(entry, stop_price, target_price);
+    }
+    bool cancelOrder(OrderId id) { return book_.cancel(id); }
+    const OrderBook& orderBook() const { return book_; }
+
     /// Update equity snapshot using current bar's close for position value.
     void updateEquity(const Bar& bar);
 
@@ -46,6 +64,19 @@ public:
     const std::vector<double>& equityCurve() const { return equity_curve_; }
 
     void setLastClose(double c) { last_close_ = c; }
+    /// Reserve the equity curve for this many bars (one point per updateEquity) and the trade list for as
+    /// many closing fills, up to TRADE_RESERVE_CAP, so the bar loop doesn't allocate while recording them.
+    void reserve(std::size_t bars) {
+        if (record_curve_) equity_curve_.reserve(bars);
+        trades_.reserve(bars < TRADE_RESERVE_CAP ? bars : TRADE_RESERVE_CAP);
+    }
+
+    /// Off: updateEquity doesn't store the curve (equityCurve() stays empty), e.g. when the metrics come
+    /// from a MetricsAccumulator. On by default.
+    void setRecordEquityCurve(bool on) { record_curve_ = on; }
+
+    /// reserve() preallocates at most this many trades (4 MB); a run closing more grows the list as usual.
+    static constexpr std::size_t TRADE_RESERVE_CAP = 65536;
 
 private:
     double initial_cash_;
@@ -57,12 +88,18 @@ private:
     double equity_;
     double last_close_;
 
-    Order pending_order_;   // single pending (can extend to queue)
+    void fillPending(const Bar& bar);
+    void execute(Side side, double qty, double fill_price, std::int64_t time);
+    bool fillResting(const Order& order, double fill_price, std::int64_t time);
+
+    Order pending_order_;   // placeOrder's market order
     bool has_pending_{false};
+    OrderBook book_;        // submitOrder's resting orders
 
     std::vector<Trade> trades_;
     std::vector<double> equity_curve_;
-    std::string last_bar_time_;
+    bool record_curve_{true};
+    std::int64_t last_bar_time_{0};
 };
 
 } // namespace backtest
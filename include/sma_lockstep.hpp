@@ -0,0 +1,40 @@
+#pragma once
+
+#include "bar_series.hpp"
+#include "report.hpp"
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+/// One parameter set of the sma_crossover strategy (same meaning as --fast / --slow / --size).
+struct SmaLane {
+    int fast{9};
+    int slow{21};
+    double size{1.0};
+};
+
+struct SmaLaneResult {
+    BacktestMetrics metrics;
+    std::string stop_reason;  // empty unless the lane stopped early
+};
+
+/// Run many sma_crossover parameter sets over one bar stream in lockstep.
+/// Each distinct SMA period is computed once per bar and shared by every lane that uses it; per-lane
+/// cash / position / equity and the running metrics (drawdown, Sharpe) live in aligned arrays that
+/// are updated a SIMD register at a time (AVX-512 or AVX2 when compiled for it, scalar otherwise).
+/// Lanes follow exactly the rules of createSmaCrossoverStrategy + Simulator + Backtester (fills at
+/// next open, early stop on zero equity / 100% drawdown), so each result matches a Backtester run;
+/// only the Sharpe ratio may differ in the last bits (streaming mean/variance). Sortino and exposure
+/// aren't tracked per lane (left 0).
+/// Results are in lane order. Periods must be >= 1.
+std::vector<SmaLaneResult> runSmaCrossoverLockstep(const BarSeries& bars,
+                                                   const std::vector<SmaLane>& lanes,
+                                                   double initial_cash,
+                                                   double commission = 0.0,
+                                                   double slippage = 0.0);
+
+/// Which equity-update path was compiled in: "avx512", "avx2" or "scalar".
+const char* smaLockstepIsa();
+
+} // namespace backtest
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "backtester.hpp"
+#include "bar_aggregator.hpp"
+#include "bar_series.hpp"
+#include "indicator_cache.hpp"
+#include "metrics.hpp"
+#include "pruning.hpp"
+#include "simulator.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace backtest {
+
+namespace detail {
+
+template <typename S, typename = void>
+struct HasOnStart : std::false_type {};
+template <typename S>
+struct HasOnStart<S, std::void_t<decltype(std::declval<S&>().onStart(std::declval<BacktestContext&>()))>>
+    : std::true_type {};
+
+template <typename S, typename = void>
+struct HasOnEnd : std::false_type {};
+template <typename S>
+struct HasOnEnd<S, std::void_t<decltype(std::declval<S&>().onEnd(std::declval<BacktestContext&>()))>>
+    : std::true_type {};
+
+} // namespace detail
+
+/// The bar loop shared by Backtester (Strategy = IStrategy, virtual calls) and StaticBacktester (the
+/// concrete strategy type, direct calls): onStart, then per bar fill pending orders at the open (resting
+/// orders along the bar, or along its intrabar bars), stop on equity <= 0, onBar, mark to close, stop on
+/// equity <= 0 or 100% drawdown (then pruner's criteria, if any); then onEnd. Sets stopped_early /
+/// stop_reason when it stops. metrics is reset and fed every curve point and closed trade as they happen.
+/// bars may be a window of a series: bar i's intrabar bars are intrabar->of(intrabar_first + i).
+template <typename Strategy>
+void runBarLoop(Strategy& strategy,
+                Simulator& sim,
+                BacktestContext& ctx,
+                BarSeriesView bars,
+                const IntrabarSeries* intrabar,
+                std::size_t intrabar_first,
+                double initial_cash,
+                MetricsAccumulator& metrics,
+                RunPruner* pruner,
+                bool& stopped_early,
+                std::string& stop_reason) {
+    sim.reserve(bars.size());  // no allocation per bar from here on (see Simulator::reserve)
+    metrics.reset(initial_cash);
+    std::size_t trades_seen = sim.trades().size();
+    if constexpr (detail::HasOnStart<Strategy>::value) strategy.onStart(ctx);
+
+    double peak_equity = initial_cash;
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        const Bar bar = bars[i];
+        ctx.setBarIndex(i);
+
+        // 1. Process orders from previous bar (fill at this bar's open; resting orders along the bar,
+        //    or along its finer bars with intrabar fills)
+        if (intrabar)
+            sim.processOrders(bar, intrabar->of(intrabar_first + i));
+        else
+            sim.processOrders(bar);
+        for (; trades_seen < sim.trades().size(); ++trades_seen) metrics.addTrade(sim.trades()[trades_seen]);
+
+        // Equity after fill uses bar open (we just filled at open). Don't use sim.equity() here
+        // because it's only updated in updateEquity(bar), so it would be stale.
+        double eq_after_fill = sim.cash() + sim.position() * bar.open;
+        if (eq_after_fill <= 0) {
+            stopped_early = true;
+            stop_reason = "no more equity";
+            sim.updateEquity(bar);  // record final equity at bar close for report
+            metrics.addBar(sim.equity(), sim.position());
+            break;
+        }
+
+        // 2. Strategy sees current bar and can place orders (filled next bar)
+        strategy.onBar(bar, ctx);
+
+        // 3. Update equity at this bar's close (used for curve and next bar's checks)
+        sim.updateEquity(bar);
+        metrics.addBar(sim.equity(), sim.position());
+
+        double eq = sim.equity();
+        if (eq > peak_equity) peak_equity = eq;
+        double drawdown_pct = (peak_equity > 0) ? ((peak_equity - eq) / peak_equity * 100.0) : 100.0;
+
+        if (eq <= 0) {
+            stopped_early = true;
+            stop_reason = "no more equity";
+            break;
+        }
+        if (drawdown_pct >= 100.0) {
+            stopped_early = true;
+            stop_reason = "max drawdown 100%";
+            break;
+        }
+        if (pruner && pruner->check(i, eq, drawdown_pct, metrics, stop_reason)) {
+            stopped_early = true;
+            break;
+        }
+    }
+    if (pruner) pruner->finish();
+
+    if constexpr (detail::HasOnEnd<Strategy>::value) strategy.onEnd(ctx);
+}
+
+/// Backtester with the strategy type known at compile time: same loop and results as Backtester on a
+/// shared series, but onBar is called directly and, when the strategy takes BacktestContext& (or is a
+/// template on the context), position() / equity() / bars() ... are inline reads instead of virtual calls.
+/// Strategy needs onBar(const Bar&, BacktestContext&); onStart / onEnd are optional. An IStrategy
+/// implementation works too (mark it final so the compiler can devirtualize). Plugins and the factory
+/// strategies keep using Backtester.
+template <typename Strategy>
+class StaticBacktester {
+public:
+    StaticBacktester(Strategy strategy,
+                     std::shared_ptr<const BarSeries> bars,
+                     double initial_cash = 100000.0,
+                     double commission = 0.0,
+                     double slippage = 0.0)
+        : strategy_(std::move(strategy))
+        , bars_(std::move(bars))
+        , initial_cash_(initial_cash)
+        , sim_(initial_cash, commission, slippage)
+        , ctx_(sim_, *bars_)
+    {
+    }
+
+    StaticBacktester(const StaticBacktester&) = delete;
+    StaticBacktester& operator=(const StaticBacktester&) = delete;
+
+    /// Intrabar bars for the series (offsets must match it; see IntrabarSeries). Call before run().
+    void setIntrabar(std::shared_ptr<const IntrabarSeries> intrabar) { intrabar_ = std::move(intrabar); }
+
+    /// As Backtester::setIndicatorCache. Call before run().
+    void setIndicatorCache(std::shared_ptr<IndicatorCache> cache, std::uint64_t series_id) {
+        indicator_cache_ = std::move(cache);
+        ctx_.setIndicatorCache(indicator_cache_.get(), series_id);
+    }
+
+    /// As Backtester::setPruning. Call before run().
+    void setPruning(const PruneCriteria& criteria, std::shared_ptr<PruneBoard> board) {
+        prune_ = criteria;
+        prune_board_ = std::move(board);
+    }
+
+    /// Run the backtest. Returns false if the series is empty. Early stops as Backtester::run().
+    bool run() {
+        if (bars_->empty()) return false;
+        if (prune_.any()) pruner_ = std::make_unique<RunPruner>(prune_, bars_->size(), prune_board_.get());
+        const IntrabarSeries* intrabar = intrabar_.get();
+        if (intrabar && intrabar->coarseSize() != bars_->size()) intrabar = nullptr;
+        runBarLoop(strategy_, sim_, ctx_, bars_->view(), intrabar, 0, initial_cash_, metrics_, pruner_.get(),
+                   stopped_early_, stop_reason_);
+        return true;
+    }
+
+    const Simulator& simulator() const { return sim_; }
+    Simulator& simulator() { return sim_; }
+    const BarSeries& bars() const { return *bars_; }
+    /// As Backtester::setRecordEquityCurve / metrics(). Call before / after run().
+    void setRecordEquityCurve(bool on) { sim_.setRecordEquityCurve(on); }
+    BacktestMetrics metrics() const { return withOpenPosition(metrics_.metrics(), sim_); }
+    const Strategy& strategy() const { return strategy_; }
+    Strategy& strategy() { return strategy_; }
+
+    bool stoppedEarly() const { return stopped_early_; }
+    const std::string& stopReason() const { return stop_reason_; }
+
+private:
+    Strategy strategy_;
+    std::shared_ptr<const BarSeries> bars_;
+    std::shared_ptr<const IntrabarSeries> intrabar_;
+    std::shared_ptr<IndicatorCache> indicator_cache_;
+    double initial_cash_;
+    Simulator sim_;
+    BacktestContext ctx_;
+    MetricsAccumulator metrics_;
+    PruneCriteria prune_;
+    std::shared_ptr<PruneBoard> prune_board_;
+    std::unique_ptr<RunPruner> pruner_;
+    bool stopped_early_{false};
+    std::string stop_reason_;
+};
+
+} // namespace backtest
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "bar_aggregator.hpp"
+#include "bar_series.hpp"
+#include "indicator_cache.hpp"
+#include "pruning.hpp"
+#include "report.hpp"
+#include "sma_lockstep.hpp"
+#include "strategy.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+class ThreadPool;
+
+/// One swept parameter: values start, start+step, ... up to end (inclusive).
+struct SweepRange {
+    std::string name;
+    double start{0};
+    double end{0};
+    double step{1};
+
+    std::size_t count() const;
+    double value(std::size_t i) const { return start + static_cast<double>(i) * step; }
+};
+
+/// Parse "fast=5:50:1,slow=20:400:5" (name=start:end[:step], step defaults to 1; "name=v" = one value).
+/// Returns false and sets error_msg on a malformed spec.
+bool parseSweepSpec(const std::string& spec, std::vector<SweepRange>& ranges, std::string& error_msg);
+
+/// Number of combinations (product of every range's count); 0 if it would overflow.
+std::size_t sweepSize(const std::vector<SweepRange>& ranges);
+
+/// Most combinations one sweep may have: a sweep keeps a result per combination in memory.
+constexpr std::size_t MAX_SWEEP_COMBINATIONS = 1000000;
+
+/// Parameter values of combination `index`, first range varying slowest.
+std::vector<double> sweepValues(const std::vector<SweepRange>& ranges, std::size_t index);
+
+/// Builds the strategy for one combination (values in range order). Return nullptr to skip it.
+using SweepStrategyFactory = std::function<std::unique_ptr<IStrategy>(const std::vector<double>& values)>;
+
+struct SweepOptions {
+    double initial_cash{100000.0};
+    double commission{0.0};
+    double slippage{0.0};
+    /// Byte budget of the IndicatorCache the runs share (SMA columns computed once per period, not per
+    /// run); 0 = no cache, every strategy computes its own.
+    std::size_t indicator_cache_bytes{IndicatorCache::DEFAULT_BUDGET_BYTES};
+    /// Finer bars behind the series for intrabar fills of resting orders (Backtester::setIntrabar); null = off.
+    std::shared_ptr<const IntrabarSeries> intrabar;
+    /// Kill criteria checked during each run (runSweep only; the equity percentile is over the runs
+    /// completed so far, so which runs get pruned can vary with thread timing). Default: none.
+    PruneCriteria prune;
+    /// Run every combination on bars [range_begin, range_end) of the series only (Backtester::setRange),
+    /// e.g. a walk-forward's in-sample window. runSweep only.
+    std::size_t range_begin{0};
+    std::size_t range_end{SIZE_MAX};
+};
+
+struct SweepResult {
+    std::size_t index{0};       // combination index (see sweepValues)
+    std::vector<double> values;
+    BacktestMetrics metrics;
+    std::string stop_reason;    // empty unless the run stopped early
+
+    /// Stopped by PruneCriteria: metrics only cover the bars up to the stop.
+    bool pruned() const { return stop_reason.compare(0, 6, "pruned") == 0; }
+};
+
+/// Run every combination against the same read-only bars, one Backtester + Simulator per run,
+/// spread over pool. Results come back in combination order (skipped combinations omitted),
+/// independent of thread count. Empty if ranges have more than MAX_SWEEP_COMBINATIONS combinations.
+std::vector<SweepResult> runSweep(const std::shared_ptr<const BarSeries>& bars,
+                                  const std::vector<SweepRange>& ranges,
+                                  const SweepStrategyFactory& factory,
+                                  const SweepOptions& options,
+                                  ThreadPool& pool);
+
+/// sma_crossover lane for one combination (values in range order). Return false to skip it.
+using SmaLaneFactory = std::function<bool(const std::vector<double>& values, SmaLane& lane)>;
+
+/// runSweep for sma_crossover without a Backtester per combination: the combinations are cut into
+/// chunks, and each pool task builds one chunk's lanes and advances them in lockstep
+/// (runSmaCrossoverLockstep). Same result order and metrics as runSweep with createSmaCrossoverStrategy;
+/// empty past MAX_SWEEP_COMBINATIONS.
+std::vector<SweepResult> runSmaSweep(const BarSeries& bars,
+                                     const std::vector<SweepRange>& ranges,
+                                     const SmaLaneFactory& lane_factory,
+                                     const SweepOptions& options,
+                                     ThreadPool& pool);
+
+enum class SweepRank { Return, Sharpe, Drawdown };
+
+/// "return", "sharpe" or "drawdown". Returns false for anything else.
+bool parseSweepRank(const std::string& name, SweepRank& out);
+
+/// Best first: highest return / Sharpe, or lowest max drawdown. Pruned runs come after every other run
+/// (their cut-off metrics would otherwise outrank complete ones), ranked the same way. Ties keep
+/// combination order.
+void rankSweepResults(std::vector<SweepResult>& results, SweepRank rank);
+
+/// Write one CSV row per result (parameter columns, then metrics). Returns false and logs to stderr on failure.
+bool writeSweepCsv(const std::string& filepath, const std::vector<SweepRange>& ranges,
+                   const std::vector<SweepResult>& results);
+
+} // namespace backtest
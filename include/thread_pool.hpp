@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace backtest {
+
+/// Fixed-size pool of worker threads with a shared FIFO task queue.
+/// Used for one-off fan-out work (directory scans, per-symbol runs, parameter sweeps).
+class ThreadPool {
+public:
+    /// threads = 0 uses defaultThreads().
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const { return workers_.size(); }
+
+    /// std::thread::hardware_concurrency(), at least 1.
+    static std::size_t defaultThreads();
+
+    /// Queue fn; the future carries its result or exception.
+    template <typename F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> result = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return result;
+    }
+
+    /// Call fn(i) for every i in [0, count), spread over the workers and the calling thread;
+    /// indices are handed out one at a time so uneven items balance themselves.
+    /// Returns when all calls are done; rethrows the first exception thrown by fn.
+    /// Safe to call from inside a pool task (the caller keeps draining indices itself).
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+private:
+    void enqueue(std::function<void()> task);
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_{false};
+};
+
+} // namespace backtest
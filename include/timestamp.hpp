@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace backtest {
+
+/// Timestamps are int64 nanoseconds since 1970-01-01T00:00:00 UTC.
+constexpr std::int64_t NS_PER_SECOND = 1000000000LL;
+constexpr std::int64_t NS_PER_MINUTE = 60 * NS_PER_SECOND;
+constexpr std::int64_t NS_PER_HOUR = 60 * NS_PER_MINUTE;
+constexpr std::int64_t NS_PER_DAY = 24 * NS_PER_HOUR;
+
+/// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's days_from_civil).
+constexpr std::int64_t daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+/// Day number since 1970-01-01 (floor, so pre-epoch times land on the right day).
+constexpr std::int64_t dayOf(std::int64_t ns) {
+    return (ns >= 0 ? ns : ns - (NS_PER_DAY - 1)) / NS_PER_DAY;
+}
+
+/// Nanoseconds since midnight UTC.
+constexpr std::int64_t timeOfDay(std::int64_t ns) { return ns - dayOf(ns) * NS_PER_DAY; }
+
+constexpr int hourOf(std::int64_t ns) { return static_cast<int>(timeOfDay(ns) / NS_PER_HOUR); }
+constexpr int minuteOf(std::int64_t ns) { return static_cast<int>(timeOfDay(ns) % NS_PER_HOUR / NS_PER_MINUTE); }
+
+/// Inverse of daysFromCivil.
+void civilFromDays(std::int64_t days, int& y, unsigned& m, unsigned& d);
+
+/// Parse "YYYY-MM-DD", "YYYY-MM-DDTHH:MM[:SS[.fffffffff]][Z]" or "YYYY-MM-DD HH:MM:SS".
+/// '_' is accepted in place of ':' (Databento filenames). Returns false if unparseable.
+bool parseTimestamp(std::string_view s, std::int64_t& out_ns);
+
+/// Canonical text form, UTC: "YYYY-MM-DD HH:MM:SSZ", with ".fffffffff" before the Z only for sub-second
+/// times (bars of 1s and up are always the fixed 20 characters).
+/// Writes into buf (at least 32 bytes) and returns the length.
+std::size_t formatTimestamp(std::int64_t ns, char* buf);
+std::string formatTimestamp(std::int64_t ns);
+
+} // namespace backtest
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "bar_series.hpp"
+#include "metrics.hpp"
+#include "sweep.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+class ThreadPool;
+
+/// Walk-forward window lengths: in bars, or in time (calendar windows) when the *_ns fields are set.
+/// Each out-of-sample window follows its in-sample window; the next pair starts one out-of-sample
+/// length later, so the out-of-sample windows tile the series after the first in-sample window.
+struct WalkForwardSpec {
+    std::size_t in_sample_bars{0};
+    std::size_t out_of_sample_bars{0};
+    std::int64_t in_sample_ns{0};
+    std::int64_t out_of_sample_ns{0};
+    bool anchored{false};  // every in-sample window starts at the first bar (grows instead of rolling)
+};
+
+/// Parse "IS:OOS[:anchored]", each length a bar count ("20000") or a duration ("90d", "12h", "30m"; both
+/// the same kind), e.g. "90d:30d" or "20000:5000:anchored". Returns false and sets error_msg if invalid.
+bool parseWalkForwardSpec(const std::string& text, WalkForwardSpec& out, std::string& error_msg);
+
+/// Bar index ranges [begin, end) of one in-sample / out-of-sample pair.
+struct WalkForwardWindow {
+    std::size_t is_begin{0};
+    std::size_t is_end{0};
+    std::size_t oos_begin{0};
+    std::size_t oos_end{0};
+};
+
+/// The windows of spec over bars (sorted by time). Pairs with an empty in-sample or out-of-sample range
+/// (gaps in calendar windows) are dropped; the last out-of-sample window may be shorter.
+std::vector<WalkForwardWindow> walkForwardWindows(const BarSeries& bars, const WalkForwardSpec& spec);
+
+struct WalkForwardResult {
+    WalkForwardWindow window;
+    SweepResult best;             // the unpruned in-sample winner by rank (metrics over the in-sample bars)
+    std::size_t candidates{0};    // combinations run in-sample
+    BacktestMetrics oos;          // the winner out of sample
+    std::string oos_stop_reason;  // empty unless the out-of-sample run stopped early
+};
+
+struct WalkForwardReport {
+    std::vector<WalkForwardResult> windows;  // windows with at least one unpruned combination, in order
+    /// Out-of-sample equity stitched across windows: each window's run starts with the previous one's
+    /// final equity as cash (its open position, if any, is not carried). Point k is at series bar oos_bar[k].
+    std::vector<double> oos_equity;
+    std::vector<std::size_t> oos_bar;
+};
+
+/// For each window: runSweep over the in-sample bars (parallel on pool, options as for a sweep), rank the
+/// results, then backtest the winner (never a pruned run; windows where every run was pruned are skipped)
+/// on the out-of-sample bars. Both read windows of the one shared series (Backtester::setRange); nothing
+/// is copied. Stops stitching if equity runs out.
+/// The out-of-sample run starts cold at oos_begin, like any run: its indicators see no earlier bars, so
+/// the winner can't trade until its lookback has passed (e.g. slow bars of sma_crossover). Keep
+/// out-of-sample windows well above that; the CLI rejects ones that are not longer.
+WalkForwardReport runWalkForward(const std::shared_ptr<const BarSeries>& bars,
+                                 const std::vector<WalkForwardWindow>& windows,
+                                 const std::vector<SweepRange>& ranges,
+                                 const SweepStrategyFactory& factory,
+                                 const SweepOptions& options,
+                                 SweepRank rank,
+                                 ThreadPool& pool);
+
+/// One CSV row per window: bar ranges and times, winning parameters, in-sample and out-of-sample metrics.
+/// Returns false and logs to stderr on failure.
+bool writeWalkForwardCsv(const std::string& filepath, const BarSeries& bars, const std::vector<SweepRange>& ranges,
+                         const WalkForwardReport& report);
+
+/// The stitched out-of-sample equity curve (window, bar index, timestamp, equity). Returns false and logs to
+/// stderr on failure.
+bool writeWalkForwardEquity(const std::string& filepath, const BarSeries& bars, const WalkForwardReport& report);
+
+} // namespace backtest
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "context.hpp"
+#include "indicators.hpp"
+#include <cstddef>
+
+namespace backtest {
+
+/// SMA of closes for a strategy: reads the run's precomputed column when the context has an
+/// indicator cache (IContext::indicator), otherwise streams like Sma. Same values either way.
+class CachedSma {
+public:
+    explicit CachedSma(std::size_t period) : sma_(period > 0 ? period : 1) {}
+
+    /// Call from onStart: picks up the cached column, or resets the streaming state.
+    void start(const IContext& ctx) {
+        column_ = ctx.indicator(IndicatorKind::Sma, sma_.period());
+        sma_.reset();
+        value_ = 0;
+    }
+
+    /// Call once per bar, in order, with the bar's close and ctx.barIndex().
+    double update(double close, std::size_t bar_index) {
+        value_ = column_ ? (*column_)[bar_index] : sma_.update(close);
+        return value_;
+    }
+
+    double value() const { return value_; }
+    std::size_t period() const { return sma_.period(); }
+
+private:
+    Sma sma_;
+    IndicatorColumnPtr column_;
+    double value_{0};
+};
+
+} // namespace backtest
@@ -0,0 +1,304 @@
+#pragma once
+
+/// Streaming indicators: each update(x) is O(1) amortized and allocation-free (window buffers are
+/// sized once in the constructor), so per-bar cost does not depend on the lookback.
+/// Feed one value per bar, in order, from onBar; value() is the indicator after the latest update.
+/// Windowed sums are re-summed from the buffer once per window length to keep rounding drift bounded.
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace backtest {
+
+/// Fixed-capacity FIFO of the last N values.
+class RingBuffer {
+public:
+    explicit RingBuffer(std::size_t capacity) : data_(capacity > 0 ? capacity : 1) {}
+
+    std::size_t capacity() const { return data_.size(); }
+    std::size_t size() const { return size_; }
+    bool full() const { return size_ == data_.size(); }
+    void clear() { head_ = size_ = 0; }
+
+    /// Append x; when full, overwrites and returns true with the evicted (oldest) value in evicted.
+    bool push(double x, double& evicted) {
+        bool was_full = full();
+        evicted = data_[head_];
+        data_[head_] = x;
+        if (++head_ == data_.size()) head_ = 0;
+        if (!was_full) ++size_;
+        return was_full;
+    }
+
+    /// i = 0 is the oldest value held, size() - 1 the newest.
+    double operator[](std::size_t i) const {
+        std::size_t j = (full() ? head_ : 0) + i;
+        return data_[j >= data_.size() ? j - data_.size() : j];
+    }
+    double newest() const { return (*this)[size_ - 1]; }
+    double oldest() const { return (*this)[0]; }
+
+    /// True right after the write position wrapped (once per capacity pushes).
+    bool wrapped() const { return head_ == 0; }
+
+private:
+    std::vector<double> data_;
+    std::size_t head_{0};
+    std::size_t size_{0};
+};
+
+/// Sum of the last `period` values.
+class RollingSum {
+public:
+    explicit RollingSum(std::size_t period) : buf_(period) {}
+
+    double update(double x) {
+        double out;
+        if (buf_.push(x, out)) sum_ += x - out;
+        else sum_ += x;
+        if (buf_.wrapped()) {
+            sum_ = 0;
+            for (std::size_t i = 0; i < buf_.size(); ++i) sum_ += buf_[i];
+        }
+        return sum_;
+    }
+
+    double value() const { return sum_; }
+    std::size_t period() const { return buf_.capacity(); }
+    std::size_t count() const { return buf_.size(); }
+    bool ready() const { return buf_.full(); }
+    void reset() { buf_.clear(); sum_ = 0; }
+
+private:
+    RingBuffer buf_;
+    double sum_{0};
+};
+
+/// Simple moving average. value() is 0 until `period` values have been seen.
+class Sma {
+public:
+    explicit Sma(std::size_t period) : sum_(period) {}
+
+    double update(double x) {
+        sum_.update(x);
+        return value();
+    }
+    double value() const { return sum_.ready() ? sum_.value() / static_cast<double>(sum_.period()) : 0.0; }
+    std::size_t period() const { return sum_.period(); }
+    bool ready() const { return sum_.ready(); }
+    void reset() { sum_.reset(); }
+
+private:
+    RollingSum sum_;
+};
+
+/// Exponential moving average, alpha = 2 / (period + 1), seeded with the SMA of the first `period` values.
+class Ema {
+public:
+    explicit Ema(std::size_t period)
+        : period_(period > 0 ? period : 1), alpha_(2.0 / (static_cast<double>(period_) + 1.0)) {}
+
+    double update(double x) {
+        if (count_ < period_) {
+            seed_ += x;
+            if (++count_ == period_) value_ = seed_ / static_cast<double>(period_);
+        } else {
+            value_ += alpha_ * (x - value_);
+        }
+        return value_;
+    }
+    double value() const { return value_; }
+    std::size_t period() const { return period_; }
+    bool ready() const { return count_ >= period_; }
+    void reset() { count_ = 0; seed_ = value_ = 0; }
+
+private:
+    std::size_t period_;
+    double alpha_;
+    std::size_t count_{0};
+    double seed_{0};
+    double value_{0};
+};
+
+/// Mean and variance of the last `period` values (Welford update, sliding form once the window is full).
+class RollingVariance {
+public:
+    explicit RollingVariance(std::size_t period) : buf_(period) {}
+
+    void update(double x) {
+        double out;
+        if (buf_.push(x, out)) {
+            const double old_mean = mean_;
+            mean_ += (x - out) / static_cast<double>(buf_.size());
+            m2_ += (x - out) * (x - mean_ + out - old_mean);
+        } else {
+            const double delta = x - mean_;
+            mean_ += delta / static_cast<double>(buf_.size());
+            m2_ += delta * (x - mean_);
+        }
+        if (buf_.wrapped()) recompute();
+        if (m2_ < 0) m2_ = 0;
+    }
+
+    double mean() const { return mean_; }
+    /// Population variance (divide by n).
+    double variance() const { return buf_.size() > 0 ? m2_ / static_cast<double>(buf_.size()) : 0.0; }
+    /// Sample variance (divide by n - 1).
+    double sampleVariance() const { return buf_.size() > 1 ? m2_ / static_cast<double>(buf_.size() - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    std::size_t period() const { return buf_.capacity(); }
+    bool ready() const { return buf_.full(); }
+    void reset() { buf_.clear(); mean_ = m2_ = 0; }
+
+private:
+    void recompute() {
+        const std::size_t n = buf_.size();
+        double s = 0;
+        for (std::size_t i = 0; i < n; ++i) s += buf_[i];
+        mean_ = s / static_cast<double>(n);
+        m2_ = 0;
+        for (std::size_t i = 0; i < n; ++i) m2_ += (buf_[i] - mean_) * (buf_[i] - mean_);
+    }
+
+    RingBuffer buf_;
+    double mean_{0};
+    double m2_{0};
+};
+
+/// Two-state (price, velocity) Kalman-style smoother with a fixed gain, as used by the CTM trend
+/// filter: gain is in 1/10000 units (2400 = 0.24). The first update initializes to the input.
+class KalmanSmoother {
+public:
+    explicit KalmanSmoother(double gain) : k_(gain / 10000.0), k_price_(std::sqrt(k_ * 2.0)) {}
+
+    double update(double x) {
+        if (!initialized_) {
+            price_ = x;
+            velocity_ = 0;
+            initialized_ = true;
+            return price_;
+        }
+        const double distance = x - price_;
+        const double smooth = price_ + distance * k_price_;
+        velocity_ += k_ * distance;
+        price_ = smooth + velocity_;
+        return price_;
+    }
+    double value() const { return price_; }
+    double velocity() const { return velocity_; }
+    bool ready() const { return initialized_; }
+    void reset() { initialized_ = false; price_ = velocity_ = 0; }
+
+private:
+    double k_;
+    double k_price_;
+    bool initialized_{false};
+    double price_{0};
+    double velocity_{0};
+};
+
+/// Minimum (MIN = true) or maximum of the last `period` values: monotonic deque over a fixed ring,
+/// O(1) amortized per update.
+template <bool MIN>
+class RollingExtremum {
+public:
+    explicit RollingExtremum(std::size_t period)
+        : period_(period > 0 ? period : 1), idx_(period_), val_(period_) {}
+
+    double update(double x) {
+        // Expire the front if it falls out of the window, then drop values the new one dominates.
+        if (size_ > 0 && idx_[front_] + period_ <= seen_) {
+            front_ = front_ + 1 == period_ ? 0 : front_ + 1;
+            --size_;
+        }
+        while (size_ > 0 && dominated(val_[back()], x)) --size_;
+        const std::size_t slot = wrap(front_ + size_);
+        idx_[slot] = seen_;
+        val_[slot] = x;
+        ++size_;
+        ++seen_;
+        return val_[front_];
+    }
+    double value() const { return val_[front_]; }
+    std::size_t period() const { return period_; }
+    std::size_t count() const { return seen_ < period_ ? seen_ : period_; }
+    bool ready() const { return seen_ >= period_; }
+    void reset() { front_ = size_ = seen_ = 0; }
+
+private:
+    static bool dominated(double held, double incoming) { return MIN ? held >= incoming : held <= incoming; }
+    std::size_t wrap(std::size_t i) const { return i >= period_ ? i - period_ : i; }
+    std::size_t back() const { return wrap(front_ + size_ - 1); }
+
+    std::size_t period_;
+    std::vector<std::size_t> idx_;
+    std::vector<double> val_;
+    std::size_t front_{0};
+    std::size_t size_{0};
+    std::size_t seen_{0};
+};
+
+using RollingMin = RollingExtremum<true>;
+using RollingMax = RollingExtremum<false>;
+
+/// Least-squares line through the last `period` values at x = 0 (oldest) .. n-1 (newest).
+/// Keeps running sum(y) and sum(x*y); sliding the window shifts every x down by one, i.e.
+/// sum(x*y) -= sum(y) - y_oldest before the new value is added at x = n-1.
+class RollingRegression {
+public:
+    explicit RollingRegression(std::size_t period) : buf_(period) {}
+
+    void update(double y) {
+        double out;
+        if (buf_.push(y, out)) {
+            sum_xy_ -= sum_y_ - out;
+            sum_y_ -= out;
+        }
+        const std::size_t n = buf_.size();
+        sum_xy_ += static_cast<double>(n - 1) * y;
+        sum_y_ += y;
+        if (buf_.wrapped()) {
+            sum_y_ = sum_xy_ = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                sum_y_ += buf_[i];
+                sum_xy_ += static_cast<double>(i) * buf_[i];
+            }
+        }
+    }
+
+    std::size_t count() const { return buf_.size(); }
+    std::size_t period() const { return buf_.capacity(); }
+    bool ready() const { return buf_.full(); }
+    void reset() { buf_.clear(); sum_y_ = sum_xy_ = 0; }
+
+    /// Fit over the values held; value at x is intercept + slope * x.
+    void fit(double& slope, double& intercept) const {
+        const std::size_t n = buf_.size();
+        if (n < 2) {
+            slope = 0;
+            intercept = n == 1 ? sum_y_ : 0;
+            return;
+        }
+        const double dn = static_cast<double>(n);
+        const double sum_x = dn * (dn - 1) / 2;
+        const double sum_xx = (dn - 1) * dn * (2 * dn - 1) / 6;
+        const double denom = dn * sum_xx - sum_x * sum_x;
+        slope = (dn * sum_xy_ - sum_x * sum_y_) / denom;
+        intercept = (sum_y_ - slope * sum_x) / dn;
+    }
+    double slope() const { double s, b; fit(s, b); return s; }
+    /// Line value at the newest point (x = n-1).
+    double value() const {
+        double s, b;
+        fit(s, b);
+        return b + s * static_cast<double>(buf_.size() > 0 ? buf_.size() - 1 : 0);
+    }
+
+private:
+    RingBuffer buf_;
+    double sum_y_{0};
+    double sum_xy_{0};
+};
+
+} // namespace backtest
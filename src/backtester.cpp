@@ -1,23 +1,31 @@
 #include "backtester.hpp"
 #include "context.hpp"
 #include "simulator.hpp"
+#include "static_backtester.hpp"
 #include "strategy.hpp"
+#include <algorithm>
+#include <iostream>
 
 namespace backtest {
 
-BacktestContext::BacktestContext(Simulator& sim, const std::vector<Bar>& bars)
+BacktestContext::BacktestContext(Simulator& sim, BarSeriesView bars)
     : sim_(sim), bars_(bars) {}
 
 void BacktestContext::placeOrder(Side side, double quantity) {
     sim_.placeOrder(side, quantity);
 }
 
-double BacktestContext::position() const { return sim_.position(); }
-double BacktestContext::equity() const { return sim_.equity(); }
-double BacktestContext::cash() const { return sim_.cash(); }
-double BacktestContext::lastClose() const { return sim_.lastClose(); }
-std::size_t BacktestContext::barIndex() const { return bar_index_; }
-const std::vector<Bar>& BacktestContext::bars() const { return bars_; }
+OrderId BacktestContext::submitOrder(const Order& order) { return sim_.submitOrder(order); }
+BracketOrderIds BacktestContext::submitBracket(const Order& entry, double stop_price, double target_price) {
+    return sim_.submitBracket(entry, stop_price, target_price);
+}
+bool BacktestContext::cancelOrder(OrderId id) { return sim_.cancelOrder(id); }
+bool BacktestContext::isOrderOpen(OrderId id) const { return sim_.orderBook().contains(id); }
+
+IndicatorColumnPtr BacktestContext::indicator(IndicatorKind kind, std::size_t period) const {
+    if (!cache_) return nullptr;
+    return cache_->get(series_id_, bars_, kind, period);
+}
 
 Backtester::Backtester(std::unique_ptr<IStrategy> strategy,
                        const std::string& data_path,
@@ -37,58 +45,73 @@ Backtester::Backtester(std::unique_ptr<IStrategy> strategy,
 {
 }
 
+Backtester::Backtester(std::unique_ptr<IStrategy> strategy,
+                       BarSeries bars,
+                       double initial_cash,
+                       double commission,
+                       const std::string& bar_resolution,
+                       double slippage)
+    : strategy_(std::move(strategy))
+    , data_("")
+    , initial_cash_(initial_cash)
+    , bar_resolution_(bar_resolution.empty() ? "1m" : bar_resolution)
+    , preloaded_(true)
+    , sim_(std::make_unique<Simulator>(initial_cash, commission, slippage))
+{
+    data_.assign(std::move(bars));
+}
+
+Backtester::Backtester(std::unique_ptr<IStrategy> strategy,
+                       std::shared_ptr<const BarSeries> shared_bars,
+                       double initial_cash,
+                       double commission,
+                       double slippage)
+    : strategy_(std::move(strategy))
+    , data_("")
+    , initial_cash_(initial_cash)
+    , preloaded_(true)
+    , shared_bars_(std::move(shared_bars))
+    , sim_(std::make_unique<Simulator>(initial_cash, commission, slippage))
+{
+}
+
 bool Backtester::run() {
-    bool ok = !databento_dir_.empty()
-        ? data_.loadFromDatabentoDir(databento_dir_, symbol_filter_)
-        : data_.load();
+    if (shared_bars_) {
+        const std::size_t end = std::min(range_end_, shared_bars_->size());
+        if (range_begin_ >= end) return false;
+        return runLoop(*shared_bars_, range_begin_, end);
+    }
+
+    bool ok = true;
+    if (!preloaded_) {
+        if (!databento_dir_.empty())
+            ok = data_.loadFromDatabentoDir(databento_dir_, symbol_filter_);
+        else if (DataSource::isDbnPath(data_.path()))
+            ok = data_.loadFromDbn(symbol_filter_);
+        else
+            ok = data_.load();
+    }
     if (!ok || data_.empty()) return false;
 
-    data_.aggregateBars(bar_resolution_);
-
-    ctx_ = std::make_unique<BacktestContext>(*sim_, data_.bars());
-    strategy_->onStart(*ctx_);
-
-    double peak_equity = initial_cash_;
-    for (std::size_t i = 0; i < data_.size(); ++i) {
-        const Bar& bar = data_.at(i);
-        ctx_->setBarIndex(i);
-
-        // 1. Process orders from previous bar (fill at this bar's open)
-        sim_->processOrders(bar);
-
-        // Equity after fill uses bar open (we just filled at open). Don't use sim_->equity() here
-        // because it's only updated in updateEquity(bar), so it would be stale.
-        double eq_after_fill = sim_->cash() + sim_->position() * bar.open;
-        if (eq_after_fill <= 0) {
-            stopped_early_ = true;
-            stop_reason_ = "no more equity";
-            sim_->updateEquity(bar);  // record final equity at bar close for report
-            break;
-        }
-
-        // 2. Strategy sees current bar and can place orders (filled next bar)
-        strategy_->onBar(bar, *ctx_);
-
-        // 3. Update equity at this bar's close (used for curve and next bar's checks)
-        sim_->updateEquity(bar);
-
-        double eq = sim_->equity();
-        if (eq > peak_equity) peak_equity = eq;
-        double drawdown_pct = (peak_equity > 0) ? ((peak_equity - eq) / peak_equity * 100.0) : 100.0;
-
-        if (eq <= 0) {
-            stopped_early_ = true;
-            stop_reason_ = "no more equity";
-            break;
-        }
-        if (drawdown_pct >= 100.0) {
-            stopped_early_ = true;
-            stop_reason_ = "max drawdown 100%";
-            break;
-        }
+    if (!data_.aggregateBars(bar_resolution_, intrabar_fills_ ? &intrabar_ : nullptr)) {
+        std::cerr << "Unknown bar resolution: " << bar_resolution_ << "\n";
+        return false;
     }
 
-    strategy_->onEnd(*ctx_);
+    return runLoop(data_.bars(), 0, data_.bars().size());
+}
+
+bool Backtester::runLoop(const BarSeries& bars, std::size_t begin, std::size_t end) {
+    const BarSeriesView window = bars.view(begin, end);
+    ctx_ = std::make_unique<BacktestContext>(*sim_, window);
+    ctx_->setIndicatorCache(indicator_cache_.get(), series_id_);
+
+    const IntrabarSeries* intrabar = shared_intrabar_ ? shared_intrabar_.get() : &intrabar_;
+    if (intrabar->coarseSize() != bars.size()) intrabar = nullptr;
+
+    if (prune_.any()) pruner_ = std::make_unique<RunPruner>(prune_, window.size(), prune_board_.get());
+    runBarLoop(*strategy_, *sim_, *ctx_, window, intrabar, begin, initial_cash_, metrics_, pruner_.get(),
+               stopped_early_, stop_reason_);
     return true;
 }
 
@@ -0,0 +1,165 @@
+#include "bar_aggregator.hpp"
+#include "timestamp.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+namespace backtest {
+
+bool parseBarResolution(const std::string& text, BarResolution& out) {
+    std::string s;
+    for (char c : text) s += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    std::string anchor_part;
+    auto at = s.find('@');
+    if (at != std::string::npos) {
+        anchor_part = s.substr(at + 1);
+        s = s.substr(0, at);
+    }
+
+    std::size_t i = 0;
+    std::int64_t n = 0;
+    while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i]))) {
+        n = n * 10 + (s[i] - '0');
+        if (n > 1000000) return false;
+        ++i;
+    }
+    if (i == 0 || n <= 0) return false;
+
+    const std::string unit = s.substr(i);
+    std::int64_t unit_ns = 0;
+    if (unit == "s") unit_ns = NS_PER_SECOND;
+    else if (unit == "m" || unit == "min") unit_ns = NS_PER_MINUTE;
+    else if (unit == "h" || unit == "hr") unit_ns = NS_PER_HOUR;
+    else if (unit == "d") unit_ns = NS_PER_DAY;
+    else return false;
+
+    std::int64_t anchor = 0;
+    if (at != std::string::npos) {
+        int hh = 0, mm = 0;
+        if (anchor_part.size() != 5 || anchor_part[2] != ':') return false;
+        for (std::size_t k : { 0u, 1u, 3u, 4u })
+            if (!std::isdigit(static_cast<unsigned char>(anchor_part[k]))) return false;
+        hh = (anchor_part[0] - '0') * 10 + (anchor_part[1] - '0');
+        mm = (anchor_part[3] - '0') * 10 + (anchor_part[4] - '0');
+        if (hh > 23 || mm > 59) return false;
+        anchor = hh * NS_PER_HOUR + mm * NS_PER_MINUTE;
+    }
+
+    out.period_ns = n * unit_ns;
+    out.anchor_ns = anchor;
+    return true;
+}
+
+namespace {
+
+void sortByTime(BarSeries& bars) {
+    const std::size_t n = bars.size();
+    const Column<std::int64_t> times = bars.times();
+    if (std::is_sorted(times.begin(), times.end())) return;
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return times[a] < times[b]; });
+    BarSeries sorted;
+    sorted.reserve(n);
+    for (std::size_t i : order) sorted.push_back(bars[i]);
+    bars = std::move(sorted);
+}
+
+} // namespace
+
+void aggregateInPlace(BarSeries& bars, const BarResolution& res) {
+    const std::size_t n = bars.size();
+    if (n == 0 || res.period_ns <= 0) return;
+
+    sortByTime(bars);
+
+    std::int64_t* t = bars.timeData();
+    double* o = bars.openData();
+    double* h = bars.highData();
+    double* l = bars.lowData();
+    double* c = bars.closeData();
+    double* v = bars.volumeData();
+
+    // w = output bar being built; r reads ahead. w <= r, so writes never clobber unread input.
+    std::size_t w = 0;
+    std::int64_t bucket = res.bucketStart(t[0]);
+    t[0] = bucket;
+    for (std::size_t r = 1; r < n; ++r) {
+        const std::int64_t b = res.bucketStart(t[r]);
+        if (b == bucket) {
+            if (h[r] > h[w]) h[w] = h[r];
+            if (l[r] < l[w]) l[w] = l[r];
+            c[w] = c[r];
+            v[w] += v[r];
+        } else {
+            ++w;
+            bucket = b;
+            t[w] = b;
+            o[w] = o[r];
+            h[w] = h[r];
+            l[w] = l[r];
+            c[w] = c[r];
+            v[w] = v[r];
+        }
+    }
+    bars.resize(w + 1);
+}
+
+void aggregateInPlace(BarSeries& bars, const BarResolution& res, IntrabarSeries& intrabar) {
+    intrabar.fine = BarSeries();
+    intrabar.offsets.clear();
+    const std::size_t n = bars.size();
+    if (n == 0 || res.period_ns <= 0) return;
+
+    sortByTime(bars);
+    intrabar.fine = bars;
+    aggregateInPlace(bars, res);
+
+    // Same bucket boundaries as the aggregation pass: a new coarse bar starts where the bucket changes.
+    const Column<std::int64_t> t = intrabar.fine.times();
+    intrabar.offsets.reserve(bars.size() + 1);
+    std::int64_t bucket = 0;
+    for (std::size_t r = 0; r < n; ++r) {
+        const std::int64_t b = res.bucketStart(t[r]);
+        if (r == 0 || b != bucket) {
+            intrabar.offsets.push_back(r);
+            bucket = b;
+        }
+    }
+    intrabar.offsets.push_back(n);
+}
+
+LodPyramid buildLodPyramid(const BarSeries& bars, std::size_t max_top_bars) {
+    LodPyramid out;
+    const std::size_t n = bars.size();
+    const Column<std::int64_t> t = bars.times();
+    for (std::size_t i = 1; i < n; ++i) {
+        const std::int64_t step = t[i] - t[i - 1];
+        if (step > 0 && (out.base_period_ns == 0 || step < out.base_period_ns)) out.base_period_ns = step;
+    }
+    if (n <= max_top_bars) return out;
+
+    // 1970-01-05 was a Monday: anchoring the week there makes weekly buckets start on Mondays.
+    static const BarResolution steps[] = {
+        { NS_PER_MINUTE, 0 }, { 5 * NS_PER_MINUTE, 0 }, { 15 * NS_PER_MINUTE, 0 }, { NS_PER_HOUR, 0 },
+        { 4 * NS_PER_HOUR, 0 }, { NS_PER_DAY, 0 }, { 7 * NS_PER_DAY, 4 * NS_PER_DAY },
+    };
+    out.levels.reserve(std::size(steps));  // `below` points into it
+    const BarSeries* below = &bars;
+    for (const BarResolution& res : steps) {
+        if (res.period_ns <= out.base_period_ns) continue;
+        BarSeries level = *below;
+        aggregateInPlace(level, res);
+        if (level.size() * 2 > below->size() && &res != &steps[std::size(steps) - 1]) continue;
+        out.levels.push_back({ res.period_ns, std::move(level) });
+        below = &out.levels.back().bars;
+        if (below->size() <= max_top_bars) break;
+    }
+    return out;
+}
+
+} // namespace backtest
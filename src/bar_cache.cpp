@@ -0,0 +1,203 @@
+#include "bar_cache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace backtest {
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = { 'B', 'T', 'C', 'A', 'C', 'H', 'E', '\0' };
+constexpr std::uint32_t CACHE_VERSION = 1;
+constexpr std::uint32_t ENDIAN_MARKER = 0x01020304u;
+constexpr std::size_t HEADER_SIZE = 64;
+constexpr std::size_t COLUMN_ALIGN = 64;
+constexpr std::size_t NUM_COLUMNS = 6;  // time, open, high, low, close, volume
+constexpr std::size_t CHECKSUM_SAMPLE = 64 * 1024;
+
+struct CacheHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endian;
+    std::uint64_t source_size;
+    std::int64_t source_mtime;
+    std::uint64_t source_checksum;
+    std::uint64_t bar_count;
+    std::uint32_t symbol_count;
+    std::uint32_t reserved;
+    std::uint64_t columns_offset;
+};
+static_assert(sizeof(CacheHeader) == HEADER_SIZE, "cache header must stay 64 bytes");
+
+constexpr std::uint64_t FNV_OFFSET = 1469598103934665603ULL;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+std::uint64_t fnv1a(const void* data, std::size_t n, std::uint64_t h = FNV_OFFSET) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+std::size_t alignUp(std::size_t n) { return (n + COLUMN_ALIGN - 1) / COLUMN_ALIGN * COLUMN_ALIGN; }
+
+} // namespace
+
+bool fingerprintSource(const std::string& path, SourceFingerprint& out) {
+    std::error_code ec;
+    auto status = fs::status(path, ec);
+    if (ec || !fs::exists(status)) return false;
+    auto mtime = fs::last_write_time(path, ec);
+    if (ec) return false;
+    out.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+
+    if (fs::is_directory(status)) {
+        out.size = 0;
+        std::string canon = fs::weakly_canonical(path, ec).string();
+        if (ec) canon = path;
+        out.checksum = fnv1a(canon.data(), canon.size());
+        return true;
+    }
+
+    out.size = static_cast<std::uint64_t>(fs::file_size(path, ec));
+    if (ec) return false;
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    std::vector<char> buf(CHECKSUM_SAMPLE);
+    std::uint64_t h = fnv1a(&out.size, sizeof(out.size));
+    f.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+    h = fnv1a(buf.data(), static_cast<std::size_t>(f.gcount()), h);
+    if (out.size > 2 * CHECKSUM_SAMPLE) {
+        f.clear();
+        f.seekg(-static_cast<std::streamoff>(CHECKSUM_SAMPLE), std::ios::end);
+        f.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+        h = fnv1a(buf.data(), static_cast<std::size_t>(f.gcount()), h);
+    }
+    out.checksum = h;
+    return true;
+}
+
+std::string barCachePath(const std::string& source_path) {
+    fs::path p(source_path);
+    if (!p.has_filename()) p = p.parent_path();  // "dir/" -> "dir"
+    return p.string() + ".btc";
+}
+
+bool BarCacheReader::open(const std::string& cache_path, const SourceFingerprint& expected) {
+    symbols_.clear();
+    bar_count_ = 0;
+    if (!file_.open(cache_path) || file_.size() < HEADER_SIZE) return false;
+
+    CacheHeader h;
+    std::memcpy(&h, file_.data(), sizeof(h));
+    if (std::memcmp(h.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) return false;
+    if (h.version != CACHE_VERSION || h.endian != ENDIAN_MARKER) return false;
+    SourceFingerprint got{ h.source_size, h.source_mtime, h.source_checksum };
+    if (!(got == expected)) return false;
+
+    const std::size_t n = static_cast<std::size_t>(h.bar_count);
+    const std::size_t stride = alignUp(n * sizeof(double));
+    if (h.columns_offset % COLUMN_ALIGN != 0 || h.columns_offset > file_.size()
+        || file_.size() - h.columns_offset < NUM_COLUMNS * stride)
+        return false;
+
+    // Symbol table
+    const char* p = file_.data() + HEADER_SIZE;
+    const char* table_end = file_.data() + h.columns_offset;
+    for (std::uint32_t s = 0; s < h.symbol_count; ++s) {
+        std::uint64_t begin, count;
+        std::uint32_t len;
+        if (table_end - p < static_cast<std::ptrdiff_t>(2 * sizeof(std::uint64_t) + sizeof(std::uint32_t))) return false;
+        std::memcpy(&begin, p, sizeof(begin)); p += sizeof(begin);
+        std::memcpy(&count, p, sizeof(count)); p += sizeof(count);
+        std::memcpy(&len, p, sizeof(len)); p += sizeof(len);
+        if (table_end - p < static_cast<std::ptrdiff_t>(len) || begin + count > n) return false;
+        symbols_.push_back({ std::string(p, len), static_cast<std::size_t>(begin), static_cast<std::size_t>(count) });
+        p += len;
+    }
+
+    const char* cols = file_.data() + h.columns_offset;
+    times_ = reinterpret_cast<const std::int64_t*>(cols);
+    for (std::size_t c = 0; c < 5; ++c)
+        cols_[c] = reinterpret_cast<const double*>(cols + (c + 1) * stride);
+    bar_count_ = n;
+    return true;
+}
+
+void BarCacheReader::copyTo(BarSeries& out) const {
+    out.resize(bar_count_);
+    std::copy_n(times_, bar_count_, out.timeData());
+    std::copy_n(cols_[0], bar_count_, out.openData());
+    std::copy_n(cols_[1], bar_count_, out.highData());
+    std::copy_n(cols_[2], bar_count_, out.lowData());
+    std::copy_n(cols_[3], bar_count_, out.closeData());
+    std::copy_n(cols_[4], bar_count_, out.volumeData());
+}
+
+bool writeBarCache(const std::string& cache_path, const SourceFingerprint& source,
+                   const std::vector<SymbolRange>& symbols, const BarSeries& bars) {
+    const std::size_t n = bars.size();
+
+    std::vector<char> table;
+    for (const auto& s : symbols) {
+        std::uint64_t begin = s.begin, count = s.count;
+        std::uint32_t len = static_cast<std::uint32_t>(s.symbol.size());
+        table.insert(table.end(), reinterpret_cast<const char*>(&begin), reinterpret_cast<const char*>(&begin) + sizeof(begin));
+        table.insert(table.end(), reinterpret_cast<const char*>(&count), reinterpret_cast<const char*>(&count) + sizeof(count));
+        table.insert(table.end(), reinterpret_cast<const char*>(&len), reinterpret_cast<const char*>(&len) + sizeof(len));
+        table.insert(table.end(), s.symbol.begin(), s.symbol.end());
+    }
+
+    CacheHeader h{};
+    std::memcpy(h.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    h.version = CACHE_VERSION;
+    h.endian = ENDIAN_MARKER;
+    h.source_size = source.size;
+    h.source_mtime = source.mtime;
+    h.source_checksum = source.checksum;
+    h.bar_count = n;
+    h.symbol_count = static_cast<std::uint32_t>(symbols.size());
+    h.columns_offset = alignUp(HEADER_SIZE + table.size());
+
+    const std::string tmp_path = cache_path + ".tmp";
+    {
+        std::ofstream f(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!f) return false;
+        const std::size_t stride = alignUp(n * sizeof(double));
+        const std::vector<char> zeros(COLUMN_ALIGN, 0);
+        auto pad = [&](std::size_t written, std::size_t target) {
+            f.write(zeros.data(), static_cast<std::streamsize>(target - written));
+        };
+
+        f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        f.write(table.data(), static_cast<std::streamsize>(table.size()));
+        pad(HEADER_SIZE + table.size(), static_cast<std::size_t>(h.columns_offset));
+
+        f.write(reinterpret_cast<const char*>(bars.times().data()), static_cast<std::streamsize>(n * sizeof(std::int64_t)));
+        pad(n * sizeof(std::int64_t), stride);
+        for (Column<double> col : { bars.opens(), bars.highs(), bars.lows(), bars.closes(), bars.volumes() }) {
+            f.write(reinterpret_cast<const char*>(col.data()), static_cast<std::streamsize>(n * sizeof(double)));
+            pad(n * sizeof(double), stride);
+        }
+        if (!f) {
+            f.close();
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp_path, cache_path, ec);
+    if (ec) {
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace backtest
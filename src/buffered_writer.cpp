@@ -0,0 +1,87 @@
+#include "buffered_writer.hpp"
+#include "timestamp.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace backtest {
+
+BufferedWriter::BufferedWriter(std::size_t buffer_bytes)
+    : buf_(std::max<std::size_t>(buffer_bytes, 4096)) {}
+
+BufferedWriter::~BufferedWriter() { close(); }
+
+bool BufferedWriter::open(const std::string& path, bool binary) {
+    close();
+    pos_ = 0;
+    flushed_ = 0;
+    file_ = std::fopen(path.c_str(), binary ? "wb" : "w");
+    ok_ = file_ != nullptr;
+    return ok_;
+}
+
+bool BufferedWriter::close() {
+    if (!file_) return false;
+    flush();
+    if (std::fclose(file_) != 0) ok_ = false;
+    file_ = nullptr;
+    return ok_;
+}
+
+void BufferedWriter::flush() {
+    if (pos_ == 0) return;
+    if (file_ && std::fwrite(buf_.data(), 1, pos_, file_) != pos_) ok_ = false;
+    flushed_ += pos_;
+    pos_ = 0;
+}
+
+void BufferedWriter::write(std::string_view s) {
+    if (s.size() > buf_.size() - pos_) {
+        flush();
+        if (s.size() > buf_.size()) {
+            if (file_ && std::fwrite(s.data(), 1, s.size(), file_) != s.size()) ok_ = false;
+            flushed_ += s.size();
+            return;
+        }
+    }
+    std::memcpy(buf_.data() + pos_, s.data(), s.size());
+    pos_ += s.size();
+}
+
+void BufferedWriter::fixedFallback(double v, int precision) {
+    // Only reached for precisions whose text doesn't fit MAX_FIXED_CHARS: format into a scratch string.
+    std::string tmp(static_cast<std::size_t>(precision) + MAX_FIXED_CHARS, '\0');
+    auto res = std::to_chars(tmp.data(), tmp.data() + tmp.size(), v, std::chars_format::fixed, precision);
+    if (res.ec == std::errc()) write(std::string_view(tmp.data(), static_cast<std::size_t>(res.ptr - tmp.data())));
+    else ok_ = false;
+}
+
+void BufferedWriter::timestamp(std::int64_t ns) {
+    ensure(32);
+    pos_ += formatTimestamp(ns, buf_.data() + pos_);
+}
+
+void BufferedWriter::csvQuoted(std::string_view s) {
+    put('"');
+    for (char c : s) {
+        if (c == '"') put('"');
+        put(c);
+    }
+    put('"');
+}
+
+void BufferedWriter::jsonString(std::string_view s) {
+    put('"');
+    std::size_t run = 0;  // chars since the last escape, copied in one block
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        const char c = s[i];
+        const char* esc = c == '"' ? "\\\"" : c == '\\' ? "\\\\" : c == '\n' ? "\\n" : c == '\r' ? "\\r" : nullptr;
+        if (!esc) continue;
+        write(s.substr(run, i - run));
+        write(esc);
+        run = i + 1;
+    }
+    write(s.substr(run));
+    put('"');
+}
+
+} // namespace backtest
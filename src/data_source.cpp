@@ -1,12 +1,17 @@
 #include "data_source.hpp"
+#include "bar_aggregator.hpp"
+#include "bar_cache.hpp"
+#include "databento_index.hpp"
+#include "mapped_file.hpp"
+#include "timestamp.hpp"
+#include <charconv>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
 #include <cstdio>
 #include <filesystem>
-#include <set>
-#include <map>
 
 namespace fs = std::filesystem;
 
@@ -46,63 +51,135 @@ int findColumn(const std::vector<std::string>& headers, const std::vector<std::s
     return -1;
 }
 
-// Parse timestamp to (year, month, day, hour, minute). Returns false if unparseable.
-// Supports: "2025-08-04T00_00_00.000000000Z", "2025-08-04T00:00:00", "2024-01-02", "2024-01-02 12:30:00"
-bool parseTimestamp(const std::string& ts, int& year, int& month, int& day, int& hour, int& minute) {
-    year = month = day = hour = minute = 0;
-    std::string s = ts;
-    for (auto& c : s) if (c == '_') c = ':';
-    std::string datePart, timePart;
-    auto tPos = s.find('T');
-    auto spPos = s.find(' ');
-    if (tPos != std::string::npos) {
-        datePart = s.substr(0, tPos);
-        timePart = s.substr(tPos + 1);
-    } else if (spPos != std::string::npos) {
-        datePart = s.substr(0, spPos);
-        timePart = s.substr(spPos + 1);
-    } else {
-        datePart = s;
-    }
-    // Date YYYY-MM-DD
-    if (datePart.size() < 10) return false;
-    try {
-        year = std::stoi(datePart.substr(0, 4));
-        month = std::stoi(datePart.substr(5, 2));
-        day = std::stoi(datePart.substr(8, 2));
-    } catch (...) { return false; }
-    if (!timePart.empty()) {
-        auto colon1 = timePart.find(':');
-        if (colon1 != std::string::npos) {
-            try {
-                hour = std::stoi(timePart.substr(0, colon1));
-                auto colon2 = timePart.find(':', colon1 + 1);
-                if (colon2 != std::string::npos)
-                    minute = std::stoi(timePart.substr(colon1 + 1, colon2 - (colon1 + 1)));
-            } catch (...) { /* keep 0,0 */ }
+/// One CSV field inside a mapped buffer, already trimmed. No ownership.
+struct FieldRef {
+    const char* begin;
+    const char* end;
+};
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+FieldRef trimField(const char* b, const char* e) {
+    while (b < e && isBlank(*b)) ++b;
+    while (e > b && isBlank(e[-1])) --e;
+    return { b, e };
+}
+
+/// std::from_chars on a trimmed field. Accepts a leading '+' like std::stod; trailing junk is ignored (as stod does).
+bool parseDoubleField(FieldRef f, double& out) {
+    const char* b = f.begin;
+    if (b < f.end && *b == '+') ++b;
+    if (b == f.end) return false;
+    auto res = std::from_chars(b, f.end, out);
+    return res.ec == std::errc();
+}
+
+} // namespace
+
+DataSource::DataSource(const std::string& filepath) : filepath_(filepath) {}
+
+bool DataSource::load(CsvLoadMode mode) {
+    loaded_from_cache_ = false;
+    SourceFingerprint fp;
+    const bool cacheable = use_cache_ && fingerprintSource(filepath_, fp);
+    const std::string cache_path = cacheable ? barCachePath(filepath_) : std::string();
+    if (cacheable) {
+        BarCacheReader cache;
+        if (cache.open(cache_path, fp)) {
+            cache.copyTo(bars_);
+            loaded_from_cache_ = true;
+            return true;
         }
     }
+
+    bool ok = (mode == CsvLoadMode::Mapped) ? loadMapped() : loadStream();
+    if (!ok) return false;
+
+    if (cacheable && !bars_.empty())
+        writeBarCache(cache_path, fp, { SymbolRange{ "", 0, bars_.size() } }, bars_);
     return true;
 }
 
-// Period key for grouping: "YYYY-MM-DDTHH:MM" (15m: MM in {00,15,30,45}; 1h: MM=00)
-std::string periodKey(int year, int month, int day, int hour, int minute, int intervalMinutes) {
-    int m = (minute / intervalMinutes) * intervalMinutes;
-    int h = hour;
-    if (intervalMinutes >= 60) {
-        m = 0;
-        // 1h: already correct
+bool DataSource::loadMapped() {
+    bars_.clear();
+    MappedFile file;
+    if (!file.open(filepath_) || file.size() == 0) return false;
+
+    const char* p = file.data();
+    const char* const end = p + file.size();
+    if (file.size() >= 3 && static_cast<unsigned char>(p[0]) == 0xEF &&
+        static_cast<unsigned char>(p[1]) == 0xBB && static_cast<unsigned char>(p[2]) == 0xBF)
+        p += 3;  // UTF-8 BOM
+
+    auto lineEnd = [end](const char* from) {
+        const void* nl = std::memchr(from, '\n', static_cast<std::size_t>(end - from));
+        return nl ? static_cast<const char*>(nl) : end;
+    };
+
+    // Header: resolve column indices once.
+    const char* eol = lineEnd(p);
+    std::vector<std::string> headers = split(std::string(p, eol), ',');
+    for (auto& h : headers) toLower(h);
+
+    const int iDate = findColumn(headers, {"timestamp", "date", "datetime", "time"});
+    const int iOpen = findColumn(headers, {"open", "o"});
+    const int iHigh = findColumn(headers, {"high", "h"});
+    const int iLow = findColumn(headers, {"low", "l"});
+    const int iClose = findColumn(headers, {"close", "c"});
+    const int iVol = findColumn(headers, {"volume", "vol", "v"});
+
+    if (iDate < 0 || iOpen < 0 || iHigh < 0 || iLow < 0 || iClose < 0)
+        return false;
+
+    constexpr int MAX_FIELDS = 64;
+    const int iMaxRequired = std::max({ iDate, iOpen, iHigh, iLow, iClose });
+    if (iMaxRequired >= MAX_FIELDS || iVol >= MAX_FIELDS)
+        return loadStream();  // absurdly wide file: not worth a special case
+
+    p = (eol < end) ? eol + 1 : end;
+
+    // Size the store from the first data row so the loop doesn't reallocate.
+    if (p < end) {
+        std::size_t first_len = static_cast<std::size_t>(lineEnd(p) - p) + 1;
+        bars_.reserve(static_cast<std::size_t>(end - p) / first_len + 1);
     }
-    char buf[32];
-    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d", year, month, day, h, m);
-    return std::string(buf);
-}
 
-} // namespace
+    FieldRef fields[MAX_FIELDS];
+    while (p < end) {
+        const char* line_end = lineEnd(p);
 
-DataSource::DataSource(const std::string& filepath) : filepath_(filepath) {}
+        // Split in place. Like std::getline, a trailing ',' does not produce an empty last field.
+        int nf = 0;
+        const char* f = p;
+        while (true) {
+            const void* c = std::memchr(f, ',', static_cast<std::size_t>(line_end - f));
+            const char* comma = static_cast<const char*>(c);
+            const char* fe = comma ? comma : line_end;
+            if (nf < MAX_FIELDS) fields[nf] = trimField(f, fe);
+            ++nf;
+            if (!comma) break;
+            f = comma + 1;
+            if (f == line_end) break;
+        }
+        p = (line_end < end) ? line_end + 1 : end;
+
+        if (nf < 5 || nf <= iMaxRequired) continue;
 
-bool DataSource::load() {
+        Bar b;
+        const FieldRef ts = fields[iDate];
+        bool ok = parseTimestamp(std::string_view(ts.begin, static_cast<std::size_t>(ts.end - ts.begin)), b.timestamp)
+               && parseDoubleField(fields[iOpen], b.open)
+               && parseDoubleField(fields[iHigh], b.high)
+               && parseDoubleField(fields[iLow], b.low)
+               && parseDoubleField(fields[iClose], b.close)
+               && (iVol < 0 || iVol >= nf || parseDoubleField(fields[iVol], b.volume));
+        if (ok) bars_.push_back(b);
+    }
+
+    return true;
+}
+
+bool DataSource::loadStream() {
     bars_.clear();
     std::ifstream f(filepath_);
     if (!f.is_open()) return false;
@@ -130,112 +207,56 @@ bool DataSource::load() {
     return true;
 }
 
-std::optional<Bar> DataSource::parseDatabentoFilename(const std::string& filename) {
-    // Filename format: ts, ignore, ignore, ignore, open, high, low, close, volume, symbol
-    auto parts = split(filename, ',');
-    if (parts.size() < 10) return std::nullopt;
-    Bar b;
-    b.timestamp = parts[0];
-    try {
-        b.open = std::stod(parts[4]);
-        b.high = std::stod(parts[5]);
-        b.low = std::stod(parts[6]);
-        b.close = std::stod(parts[7]);
-        b.volume = std::stod(parts[8]);
-    } catch (...) {
-        return std::nullopt;
-    }
-    return b;
+bool DataSource::loadFromDatabentoDir(const std::string& dir, const std::string& symbol_filter) {
+    bars_.clear();
+    DatabentoIndex index;
+    if (!index.build(dir, use_cache_)) return false;
+    loaded_from_cache_ = index.loadedFromCache();
+    index.select(symbol_filter, bars_);  // unknown symbol: loads, but with no bars
+    return true;
 }
 
-bool DataSource::loadFromDatabentoDir(const std::string& dir, const std::string& symbol_filter) {
+bool DataSource::loadFromDbn(const std::string& symbol_filter) {
     bars_.clear();
-    std::error_code ec;
-    if (!fs::is_directory(dir, ec) || ec) return false;
-
-    for (const auto& entry : fs::directory_iterator(dir, ec)) {
-        if (ec || !entry.is_regular_file()) continue;
-        std::string filename = entry.path().filename().string();
-        if (filename.empty()) continue;
-
-        // Filter by symbol (last field). Case-insensitive match.
-        if (!symbol_filter.empty()) {
-            auto parts = split(filename, ',');
-            if (parts.size() < 10) continue;
-            std::string sym = parts[9];
-            std::string want = symbol_filter;
-            toLower(sym);
-            toLower(want);
-            if (sym != want) continue;
-        }
+    loaded_from_cache_ = false;
+    DatabentoIndex index;
+    if (!index.buildFromDbn(filepath_)) return false;
+    index.select(symbol_filter, bars_);
+    return true;
+}
 
-        auto bar = parseDatabentoFilename(filename);
-        if (!bar) continue;
-        bars_.push_back(*bar);
-    }
+bool DataSource::isDbnPath(const std::string& path) {
+    std::string p = path;
+    toLower(p);
+    auto endsWith = [&p](const std::string& suffix) {
+        return p.size() >= suffix.size() && p.compare(p.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    return endsWith(".dbn") || endsWith(".dbn.zst");
+}
 
-    std::sort(bars_.begin(), bars_.end(), [](const Bar& a, const Bar& b) {
-        return a.timestamp < b.timestamp;
-    });
-    return true;
+void DataSource::assign(BarSeries bars) {
+    bars_ = std::move(bars);
+    loaded_from_cache_ = false;
 }
 
-void DataSource::aggregateBars(const std::string& resolution) {
-    std::string r = resolution;
-    toLower(r);
-    if (r == "1m" || r.empty()) return;
-    int intervalMinutes = 0;
-    if (r == "15m") intervalMinutes = 15;
-    else if (r == "1h" || r == "1hr") intervalMinutes = 60;
-    else return;
-
-    std::map<std::string, Bar> keyToBar;
-    for (const Bar& b : bars_) {
-        int y, mo, d, h, mi;
-        if (!parseTimestamp(b.timestamp, y, mo, d, h, mi)) continue;
-        std::string key = periodKey(y, mo, d, h, mi, intervalMinutes);
-        auto it = keyToBar.find(key);
-        if (it == keyToBar.end()) {
-            Bar agg;
-            agg.timestamp = key;
-            agg.open = b.open;
-            agg.high = b.high;
-            agg.low = b.low;
-            agg.close = b.close;
-            agg.volume = b.volume;
-            keyToBar[key] = agg;
-        } else {
-            Bar& agg = it->second;
-            if (b.high > agg.high) agg.high = b.high;
-            if (b.low < agg.low) agg.low = b.low;
-            agg.close = b.close;
-            agg.volume += b.volume;
-        }
-    }
+BarSeries DataSource::release() {
+    BarSeries out = std::move(bars_);
     bars_.clear();
-    for (const auto& p : keyToBar)
-        bars_.push_back(p.second);
-    std::sort(bars_.begin(), bars_.end(), [](const Bar& a, const Bar& b) {
-        return a.timestamp < b.timestamp;
-    });
+    return out;
 }
 
-std::vector<std::string> DataSource::listSymbolsInDatabentoDir(const std::string& dir) {
-    std::set<std::string> symbols;
-    std::error_code ec;
-    if (!fs::is_directory(dir, ec) || ec) return {};
-
-    for (const auto& entry : fs::directory_iterator(dir, ec)) {
-        if (ec || !entry.is_regular_file()) continue;
-        std::string filename = entry.path().filename().string();
-        if (filename.empty()) continue;
-        auto parts = split(filename, ',');
-        if (parts.size() < 10) continue;
-        std::string sym = parts[9];
-        toLower(sym);
-        symbols.insert(sym);
-    }
-    return std::vector<std::string>(symbols.begin(), symbols.end());
+bool DataSource::aggregateBars(const std::string& resolution, IntrabarSeries* intrabar) {
+    std::string r = resolution;
+    toLower(r);
+    if (intrabar) *intrabar = IntrabarSeries();
+    if (r == "1m" || r.empty()) return true;
+    BarResolution res;
+    if (!parseBarResolution(r, res)) return false;
+    if (intrabar)
+        aggregateInPlace(bars_, res, *intrabar);
+    else
+        aggregateInPlace(bars_, res);
+    return true;
 }
 
 std::optional<Bar> DataSource::parseLine(const std::string& line,
@@ -251,7 +272,7 @@ std::optional<Bar> DataSource::parseLine(const std::string& line,
     int iVol = findColumn(headers, {"volume", "vol", "v"});
 
     Bar b;
-    b.timestamp = parts[static_cast<std::size_t>(iDate)];
+    if (!parseTimestamp(parts[static_cast<std::size_t>(iDate)], b.timestamp)) return std::nullopt;
     try {
         b.open = std::stod(parts[static_cast<std::size_t>(iOpen)]);
         b.high = std::stod(parts[static_cast<std::size_t>(iHigh)]);
@@ -0,0 +1,247 @@
+#include "databento_index.hpp"
+#include "dbn_decoder.hpp"
+#include "thread_pool.hpp"
+#include "timestamp.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace backtest {
+
+namespace {
+
+/// Filenames handed to one parse task.
+constexpr std::size_t SCAN_BATCH = 8192;
+
+std::string_view trimView(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+bool parseNumber(std::string_view s, double& out) {
+    s = trimView(s);
+    if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+    if (s.empty()) return false;
+    return std::from_chars(s.data(), s.data() + s.size(), out).ec == std::errc();
+}
+
+std::string lower(std::string_view s) {
+    std::string r(s);
+    for (auto& c : r) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return r;
+}
+
+/// Bars of one batch, partitioned by symbol (in filename order within each symbol).
+using SymbolBars = std::map<std::string, std::vector<Bar>>;
+
+SymbolBars parseBatch(const std::vector<std::string>& names) {
+    SymbolBars out;
+    Bar bar;
+    std::string_view sym;
+    for (const auto& name : names) {
+        if (DatabentoIndex::parseFilename(name, bar, sym)) out[lower(sym)].push_back(bar);
+    }
+    return out;
+}
+
+} // namespace
+
+bool DatabentoIndex::parseFilename(std::string_view filename, Bar& bar, std::string_view& symbol) {
+    std::string_view f[10];
+    std::size_t n = 0;
+    while (n < 10) {
+        std::size_t comma = filename.find(',');
+        f[n++] = filename.substr(0, comma);
+        if (comma == std::string_view::npos) break;
+        filename.remove_prefix(comma + 1);
+    }
+    if (n < 10) return false;
+
+    if (!parseTimestamp(trimView(f[0]), bar.timestamp)) return false;
+    if (!parseNumber(f[4], bar.open) || !parseNumber(f[5], bar.high) || !parseNumber(f[6], bar.low)
+        || !parseNumber(f[7], bar.close) || !parseNumber(f[8], bar.volume))
+        return false;
+    symbol = trimView(f[9]);
+    return true;
+}
+
+bool DatabentoIndex::build(const std::string& dir, bool use_cache, ThreadPool* pool) {
+    bars_.clear();
+    symbols_.clear();
+    loaded_from_cache_ = false;
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec) || ec) return false;
+
+    SourceFingerprint fp;
+    const bool cacheable = use_cache && fingerprintSource(dir, fp);
+    const std::string cache_path = cacheable ? barCachePath(dir) : std::string();
+    if (cacheable) {
+        BarCacheReader cache;
+        if (cache.open(cache_path, fp)) {
+            cache.copyTo(bars_);
+            symbols_ = cache.symbols();
+            loaded_from_cache_ = true;
+            return true;
+        }
+    }
+
+    std::unique_ptr<ThreadPool> own_pool;
+    if (!pool) {
+        own_pool = std::make_unique<ThreadPool>();
+        pool = own_pool.get();
+    }
+
+    // readdir is inherently serial; filenames are parsed in batches on the pool while the scan continues.
+    std::vector<std::future<SymbolBars>> batches;
+    std::vector<std::string> names;
+    names.reserve(SCAN_BATCH);
+    auto flush = [&]() {
+        batches.push_back(pool->submit([batch = std::move(names)]() { return parseBatch(batch); }));
+        names = {};
+        names.reserve(SCAN_BATCH);
+    };
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (ec || !entry.is_regular_file()) continue;
+        std::string filename = entry.path().filename().string();
+        if (filename.empty()) continue;
+        names.push_back(std::move(filename));
+        if (names.size() == SCAN_BATCH) flush();
+    }
+    if (!names.empty()) flush();
+
+    // Merge batches in scan order so equal timestamps keep directory order, as a serial scan would.
+    SymbolBars merged;
+    for (auto& f : batches) {
+        SymbolBars part = f.get();
+        for (auto& [sym, bars] : part) {
+            auto& dst = merged[sym];
+            if (dst.empty()) dst = std::move(bars);
+            else dst.insert(dst.end(), bars.begin(), bars.end());
+        }
+    }
+
+    assemble(merged, *pool);
+
+    if (cacheable) writeBarCache(cache_path, fp, symbols_, bars_);
+    return true;
+}
+
+bool DatabentoIndex::buildFromDbn(const std::string& path, ThreadPool* pool) {
+    bars_.clear();
+    symbols_.clear();
+    loaded_from_cache_ = false;
+    DbnDecoder dbn;
+    if (!dbn.open(path)) {
+        std::cerr << dbn.error() << "\n";
+        return false;
+    }
+
+    // Records arrive interleaved across instruments; route each to its symbol's vector. The symbol an id
+    // maps to can change by date, so the lookup is memoised per (id, day) with a last-hit fast path.
+    SymbolBars merged;
+    std::unordered_map<std::uint64_t, std::vector<Bar>*> route;
+    std::uint64_t last_key = ~std::uint64_t{0};
+    std::vector<Bar>* last = nullptr;
+    DbnOhlcv rec;
+    while (dbn.next(rec)) {
+        const std::uint64_t key = (static_cast<std::uint64_t>(rec.instrument_id) << 32)
+            ^ static_cast<std::uint32_t>(dayOf(rec.ts_event));
+        if (key != last_key) {
+            auto it = route.find(key);
+            if (it == route.end()) {
+                std::string_view sym = dbn.symbolFor(rec.instrument_id, rec.ts_event);
+                std::string name = sym.empty() ? std::to_string(rec.instrument_id) : lower(sym);
+                it = route.emplace(key, &merged[name]).first;
+            }
+            last_key = key;
+            last = it->second;
+        }
+        Bar b;
+        b.timestamp = rec.ts_event;
+        b.open = rec.open;
+        b.high = rec.high;
+        b.low = rec.low;
+        b.close = rec.close;
+        b.volume = rec.volume;
+        last->push_back(b);
+    }
+    if (!dbn.error().empty()) {
+        std::cerr << path << ": " << dbn.error() << "\n";
+        return false;
+    }
+
+    std::unique_ptr<ThreadPool> own_pool;
+    if (!pool) {
+        own_pool = std::make_unique<ThreadPool>();
+        pool = own_pool.get();
+    }
+    assemble(merged, *pool);
+    return true;
+}
+
+void DatabentoIndex::assemble(std::map<std::string, std::vector<Bar>>& merged, ThreadPool& pool) {
+    std::vector<std::vector<Bar>*> groups;
+    std::size_t total = 0;
+    for (auto& [sym, bars] : merged) {
+        symbols_.push_back({ sym, total, bars.size() });
+        groups.push_back(&bars);
+        total += bars.size();
+    }
+    pool.parallelFor(groups.size(), [&](std::size_t g) {
+        std::stable_sort(groups[g]->begin(), groups[g]->end(),
+                         [](const Bar& a, const Bar& b) { return a.timestamp < b.timestamp; });
+    });
+
+    bars_.resize(total);
+    pool.parallelFor(groups.size(), [&](std::size_t g) {
+        std::size_t i = symbols_[g].begin;
+        for (const Bar& b : *groups[g]) bars_.set(i++, b);
+    });
+}
+
+std::vector<std::string> DatabentoIndex::symbolNames() const {
+    std::vector<std::string> names;
+    names.reserve(symbols_.size());
+    for (const auto& r : symbols_) names.push_back(r.symbol);
+    return names;
+}
+
+bool DatabentoIndex::select(const std::string& symbol, BarSeries& out) const {
+    out.clear();
+    const std::string want = lower(symbol);
+
+    if (!want.empty()) {
+        auto it = std::find_if(symbols_.begin(), symbols_.end(),
+                               [&](const SymbolRange& r) { return r.symbol == want; });
+        if (it == symbols_.end()) return false;
+        const std::size_t n = it->count, b = it->begin;
+        out.resize(n);
+        std::copy_n(bars_.times().data() + b, n, out.timeData());
+        std::copy_n(bars_.opens().data() + b, n, out.openData());
+        std::copy_n(bars_.highs().data() + b, n, out.highData());
+        std::copy_n(bars_.lows().data() + b, n, out.lowData());
+        std::copy_n(bars_.closes().data() + b, n, out.closeData());
+        std::copy_n(bars_.volumes().data() + b, n, out.volumeData());
+        return true;
+    }
+
+    // Every symbol: merge by time, ties in symbol order.
+    std::vector<std::size_t> idx(bars_.size());
+    std::iota(idx.begin(), idx.end(), std::size_t{0});
+    const Column<std::int64_t> t = bars_.times();
+    std::stable_sort(idx.begin(), idx.end(), [&t](std::size_t a, std::size_t b) { return t[a] < t[b]; });
+    out.reserve(idx.size());
+    for (std::size_t i : idx) out.push_back(bars_[i]);
+    return true;
+}
+
+} // namespace backtest
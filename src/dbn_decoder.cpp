@@ -0,0 +1,242 @@
+#include "dbn_decoder.hpp"
+#include "timestamp.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#ifdef BACKTEST_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace backtest {
+
+namespace {
+
+constexpr std::uint32_t ZSTD_MAGIC = 0xFD2FB528u;
+constexpr std::size_t FIXED_METADATA_SIZE = 100;
+constexpr std::size_t V1_SYMBOL_CSTR_LEN = 22;
+
+// Little-endian reads that don't depend on host byte order or alignment.
+inline std::uint16_t rd16(const unsigned char* p) {
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+inline std::uint32_t rd32(const unsigned char* p) {
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8)
+        | (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+inline std::uint64_t rd64(const unsigned char* p) {
+    return static_cast<std::uint64_t>(rd32(p)) | (static_cast<std::uint64_t>(rd32(p + 4)) << 32);
+}
+
+/// Fixed-width, NUL-padded string field.
+std::string cstr(const unsigned char* p, std::size_t width) {
+    const char* s = reinterpret_cast<const char*>(p);
+    return std::string(s, std::find(s, s + width, '\0'));
+}
+
+bool parseU32(const std::string& s, std::uint32_t& out) {
+    if (s.empty()) return false;
+    auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+    return res.ec == std::errc() && res.ptr == s.data() + s.size();
+}
+
+bool isOhlcv(std::uint8_t rtype) {
+    return rtype == dbn::RTYPE_OHLCV_DEPRECATED || (rtype >= dbn::RTYPE_OHLCV_1S && rtype <= dbn::RTYPE_OHLCV_EOD);
+}
+
+/// ts (ns since epoch) -> YYYYMMDD, the date form used by symbology intervals.
+std::uint32_t yyyymmdd(std::int64_t ts) {
+    int y;
+    unsigned m, d;
+    civilFromDays(dayOf(ts), y, m, d);
+    return static_cast<std::uint32_t>(y * 10000 + static_cast<int>(m) * 100 + static_cast<int>(d));
+}
+
+#ifdef BACKTEST_HAVE_ZSTD
+/// Inflate every zstd frame in [data, data + size) into out.
+bool inflateZstd(const char* data, std::size_t size, std::vector<char>& out, std::string& err) {
+    ZSTD_DCtx* ctx = ZSTD_createDCtx();
+    if (!ctx) { err = "zstd: out of memory"; return false; }
+    out.clear();
+    std::vector<char> chunk(ZSTD_DStreamOutSize());
+    ZSTD_inBuffer in{ data, size, 0 };
+    std::size_t ret = 0;
+    while (in.pos < in.size) {
+        ZSTD_outBuffer o{ chunk.data(), chunk.size(), 0 };
+        ret = ZSTD_decompressStream(ctx, &o, &in);
+        if (ZSTD_isError(ret)) {
+            err = std::string("zstd: ") + ZSTD_getErrorName(ret);
+            ZSTD_freeDCtx(ctx);
+            return false;
+        }
+        out.insert(out.end(), chunk.data(), chunk.data() + o.pos);
+    }
+    // Flush whatever is still buffered for the last frame.
+    while (ret != 0) {
+        ZSTD_outBuffer o{ chunk.data(), chunk.size(), 0 };
+        ret = ZSTD_decompressStream(ctx, &o, &in);
+        if (ZSTD_isError(ret) || o.pos == 0) {
+            err = "zstd: truncated frame";
+            ZSTD_freeDCtx(ctx);
+            return false;
+        }
+        out.insert(out.end(), chunk.data(), chunk.data() + o.pos);
+    }
+    ZSTD_freeDCtx(ctx);
+    return true;
+}
+#endif
+
+} // namespace
+
+bool DbnDecoder::fail(const std::string& msg) {
+    error_ = msg;
+    pos_ = end_ = nullptr;
+    return false;
+}
+
+bool DbnDecoder::open(const std::string& path) {
+    if (!file_.open(path)) return fail("cannot open " + path);
+    const char* data = file_.data();
+    std::size_t size = file_.size();
+    if (size >= 4 && rd32(reinterpret_cast<const unsigned char*>(data)) == ZSTD_MAGIC) {
+#ifdef BACKTEST_HAVE_ZSTD
+        std::string err;
+        if (!inflateZstd(data, size, inflated_, err)) return fail(path + ": " + err);
+        file_.close();
+        data = inflated_.data();
+        size = inflated_.size();
+#else
+        return fail(path + " is zstd-compressed; decompress it (zstd -d) or rebuild with libzstd (BACKTEST_HAVE_ZSTD)");
+#endif
+    }
+    return openBuffer(data, size);
+}
+
+bool DbnDecoder::openBuffer(const char* data, std::size_t size) {
+    error_.clear();
+    meta_ = DbnMetadata();
+    by_id_.clear();
+    pos_ = reinterpret_cast<const unsigned char*>(data);
+    end_ = pos_ + size;
+    return parseMetadata();
+}
+
+bool DbnDecoder::parseMetadata() {
+    const unsigned char* p = pos_;
+    if (end_ - p < 8 || std::memcmp(p, "DBN", 3) != 0) return fail("not a DBN stream");
+    meta_.version = p[3];
+    if (meta_.version < 1 || meta_.version > 3)
+        return fail("unsupported DBN version " + std::to_string(meta_.version));
+    const std::uint32_t length = rd32(p + 4);
+    if (length < FIXED_METADATA_SIZE + 4 || static_cast<std::size_t>(end_ - p - 8) < length)
+        return fail("truncated DBN metadata");
+    const unsigned char* q = p + 8;
+    const unsigned char* meta_end = q + length;
+
+    meta_.dataset = cstr(q, 16);
+    meta_.schema = rd16(q + 16);
+    meta_.start = rd64(q + 18);
+    meta_.end = rd64(q + 26);
+    const unsigned char* f = q + 42;  // after limit
+    if (meta_.version == 1) f += 8;   // record_count
+    meta_.stype_in = f[0];
+    meta_.stype_out = f[1];
+    meta_.ts_out = f[2] != 0;
+    const std::size_t cstr_len = meta_.version == 1 ? V1_SYMBOL_CSTR_LEN : rd16(f + 3);
+    if (cstr_len == 0) return fail("bad DBN symbol width");
+    q += FIXED_METADATA_SIZE;
+
+    auto need = [&](std::size_t n) { return static_cast<std::size_t>(meta_end - q) >= n; };
+
+    const std::uint32_t schema_def_len = rd32(q);
+    q += 4;
+    if (!need(schema_def_len)) return fail("truncated DBN metadata");
+    q += schema_def_len;
+
+    // symbols, partial, not_found: u32 count + fixed-width strings. Only symbols is kept.
+    for (int list = 0; list < 3; ++list) {
+        if (!need(4)) return fail("truncated DBN metadata");
+        const std::uint32_t count = rd32(q);
+        q += 4;
+        if (!need(static_cast<std::size_t>(count) * cstr_len)) return fail("truncated DBN metadata");
+        for (std::uint32_t i = 0; i < count; ++i, q += cstr_len)
+            if (list == 0) meta_.symbols.push_back(cstr(q, cstr_len));
+    }
+
+    // mappings: raw symbol, then u32 interval count; interval = u32 start, u32 end, mapped symbol.
+    if (!need(4)) return fail("truncated DBN metadata");
+    const std::uint32_t n_mappings = rd32(q);
+    q += 4;
+    for (std::uint32_t m = 0; m < n_mappings; ++m) {
+        if (!need(cstr_len + 4)) return fail("truncated DBN metadata");
+        const std::string raw = cstr(q, cstr_len);
+        const std::uint32_t n_intervals = rd32(q + cstr_len);
+        q += cstr_len + 4;
+        for (std::uint32_t k = 0; k < n_intervals; ++k) {
+            if (!need(8 + cstr_len)) return fail("truncated DBN metadata");
+            DbnMapping map;
+            map.start_date = rd32(q);
+            map.end_date = rd32(q + 4);
+            const std::string mapped = cstr(q + 8, cstr_len);
+            q += 8 + cstr_len;
+            // Usually raw symbol -> instrument id; also accept the reverse direction.
+            if (parseU32(mapped, map.instrument_id)) map.symbol = raw;
+            else if (parseU32(raw, map.instrument_id)) map.symbol = mapped;
+            else continue;
+            if (map.symbol.empty()) continue;
+            by_id_[map.instrument_id].push_back(meta_.mappings.size());
+            meta_.mappings.push_back(std::move(map));
+        }
+    }
+
+    pos_ = meta_end;
+    return true;
+}
+
+bool DbnDecoder::next(DbnOhlcv& out) {
+    while (pos_ < end_) {
+        if (end_ - pos_ < static_cast<std::ptrdiff_t>(dbn::HEADER_SIZE)) return fail("truncated DBN record");
+        const std::size_t len = static_cast<std::size_t>(pos_[0]) * 4;
+        if (len < dbn::HEADER_SIZE || static_cast<std::size_t>(end_ - pos_) < len)
+            return fail("truncated DBN record");
+        const unsigned char* rec = pos_;
+        pos_ += len;
+
+        const std::uint8_t rtype = rec[1];
+        if (!isOhlcv(rtype) || len < dbn::OHLCV_SIZE) continue;
+
+        const auto o = static_cast<std::int64_t>(rd64(rec + 16));
+        const auto h = static_cast<std::int64_t>(rd64(rec + 24));
+        const auto l = static_cast<std::int64_t>(rd64(rec + 32));
+        const auto c = static_cast<std::int64_t>(rd64(rec + 40));
+        if (o == dbn::UNDEF_PRICE || h == dbn::UNDEF_PRICE || l == dbn::UNDEF_PRICE || c == dbn::UNDEF_PRICE)
+            continue;
+
+        out.rtype = rtype;
+        out.instrument_id = rd32(rec + 4);
+        out.ts_event = static_cast<std::int64_t>(rd64(rec + 8));
+        out.open = static_cast<double>(o) / dbn::PRICE_SCALE;
+        out.high = static_cast<double>(h) / dbn::PRICE_SCALE;
+        out.low = static_cast<double>(l) / dbn::PRICE_SCALE;
+        out.close = static_cast<double>(c) / dbn::PRICE_SCALE;
+        out.volume = static_cast<double>(rd64(rec + 48));
+        return true;
+    }
+    return false;
+}
+
+std::string_view DbnDecoder::symbolFor(std::uint32_t instrument_id, std::int64_t ts_event) const {
+    auto it = by_id_.find(instrument_id);
+    if (it == by_id_.end()) return {};
+    const auto& candidates = it->second;
+    if (candidates.size() == 1) return meta_.mappings[candidates[0]].symbol;
+    const std::uint32_t date = yyyymmdd(ts_event);
+    for (std::size_t i : candidates) {
+        const DbnMapping& m = meta_.mappings[i];
+        if (date >= m.start_date && date < m.end_date) return m.symbol;
+    }
+    return meta_.mappings[candidates[0]].symbol;
+}
+
+} // namespace backtest
@@ -0,0 +1,86 @@
+#include "indicator_cache.hpp"
+#include "indicators.hpp"
+
+namespace backtest {
+
+std::uint64_t IndicatorCache::newSeriesId() {
+    static std::atomic<std::uint64_t> next{1};
+    return next.fetch_add(1);
+}
+
+std::size_t IndicatorCache::bytesUsed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return used_;
+}
+
+IndicatorColumnPtr IndicatorCache::compute(BarSeriesView bars, IndicatorKind kind, std::size_t period) {
+    auto column = std::make_shared<IndicatorColumn>(bars.size());
+    const double* closes = bars.closes().data();
+    double* out = column->data();
+    if (kind == IndicatorKind::Ema) {
+        Ema ema(period);
+        for (std::size_t i = 0; i < bars.size(); ++i) out[i] = ema.update(closes[i]);
+    } else {
+        Sma sma(period);
+        for (std::size_t i = 0; i < bars.size(); ++i) out[i] = sma.update(closes[i]);
+    }
+    return column;
+}
+
+IndicatorColumnPtr IndicatorCache::get(std::uint64_t series_id, BarSeriesView bars,
+                                       IndicatorKind kind, std::size_t period) {
+    const Key key{ series_id, kind, period > 0 ? period : 1 };
+    std::promise<IndicatorColumnPtr> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+            ++hits_;
+            std::shared_future<IndicatorColumnPtr> column = it->second.column;
+            lock.unlock();
+            return column.get();  // waits if another thread is still computing it
+        }
+        ++misses_;
+        lru_.push_front(key);
+        entries_.emplace(key, Entry{ promise.get_future().share(), 0, lru_.begin() });
+    }
+
+    // Computed outside the lock; requests for the same key wait on the future meanwhile.
+    IndicatorColumnPtr column;
+    try {
+        column = compute(bars, key.kind, key.period);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+    promise.set_value(column);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        it->second.bytes = column->size() * sizeof(double);
+        used_ += it->second.bytes;
+        evictLocked();
+    }
+    return column;
+}
+
+void IndicatorCache::evictLocked() {
+    // Least recently used first; columns still being computed (bytes == 0) are skipped.
+    auto it = lru_.end();
+    while (used_ > budget_ && it != lru_.begin()) {
+        --it;
+        auto entry = entries_.find(*it);
+        if (entry->second.bytes == 0) continue;
+        used_ -= entry->second.bytes;
+        entries_.erase(entry);
+        it = lru_.erase(it);
+    }
+}
+
+} // namespace backtest
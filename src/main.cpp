@@ -5,6 +5,14 @@
 #include "orb_strategy.hpp"
 #include "one_point_oh_strategy.hpp"
 #include "data_source.hpp"
+#include "monte_carlo.hpp"
+#include "bar_aggregator.hpp"
+#include "databento_index.hpp"
+#include "portfolio.hpp"
+#include "sweep.hpp"
+#include "thread_pool.hpp"
+#include "timestamp.hpp"
+#include "walk_forward.hpp"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -12,8 +20,10 @@
 #include <iomanip>
 #include <vector>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <algorithm>
+#include <cmath>
 
 namespace fs = std::filesystem;
 
@@ -26,6 +36,7 @@ constexpr int CTM_SHORT_SLOW_LOOKBACK = 333;
 constexpr std::size_t MIN_BARS_CTM = 333u;
 constexpr std::size_t MIN_BARS_ORB = 10u;
 constexpr std::size_t MIN_BARS_SMA = 21u;
+constexpr std::size_t SWEEP_TOP_N = 20u;  // rows printed by --sweep (the CSV has every run)
 
 //-----------------------------------------------------------------------------
 // Config: all CLI and run options in one place
@@ -34,12 +45,15 @@ struct Config {
     std::string data_path = "data/sample_ohlc.csv";
     std::string strategy_name = "sma_crossover";
     std::string databento_dir;
+    std::string dbn_path;  // DBN OHLCV file (--dbn)
     std::string symbol_filter;
     std::string reports_dir = "reports";
     double initial_cash = 100000.0;
     double commission = 0.0;
     double slippage = 0.0;  // fraction of fill price, e.g. 0.001 = 0.1%
     std::string bar_resolution = "1m";
+    bool use_cache = true;  // .btc bar cache next to the data source
+    std::string session_format = "json,lod";  // chart viewer files: comma-separated json / lod / bin, or none
 
     // Strategy params (shared / repurposed by strategy)
     int sma_fast = DEFAULT_SMA_FAST;
@@ -50,6 +64,25 @@ struct Config {
     int orb_session_hour = 9;
     int orb_session_minute = 30;
     double one_point_oh_risk_reward = 3.0;  // R:R ratio (e.g. 1.3 = 1:1.3, 1.755 = 1:1.755)
+    bool resting_exits = false;  // orb / one_point_oh: stops and targets as resting orders
+    bool intrabar = false;       // fill resting orders on the 1m bars inside each --bar bar
+    bool portfolio = false;      // all-symbols runs: one shared account instead of one per symbol
+
+    // Parameter sweep (--sweep)
+    std::string sweep_spec;            // e.g. "fast=5:50:1,slow=20:400:5"
+    std::string sweep_rank = "return"; // return | sharpe | drawdown
+    int jobs = 0;                      // worker threads for --sweep / all-symbols runs; 0 = all cores
+    int indicator_cache_mb = 512;      // --sweep: indicator columns shared by the runs; 0 = off
+    double prune_dd = 0;               // --sweep: stop a run once drawdown exceeds this %; 0 = off
+    int prune_no_trades = 0;           // --sweep: stop a run that hasn't traded after this many bars; 0 = off
+    double prune_percentile = 0;       // --sweep: stop a run below this equity percentile of finished runs; 0 = off
+    std::string walk_forward;          // --sweep: "IS:OOS[:anchored]" windows, e.g. "90d:30d"; empty = off
+
+    // Monte Carlo trade resampling (single-symbol runs)
+    int monte_carlo = 0;                  // paths; 0 = off
+    std::string mc_method = "bootstrap";  // bootstrap | shuffle
+    bool mc_compound = false;             // resample returns on equity instead of cash P&L
+    int mc_seed = 1;
 };
 
 // Safe parse: on failure set error_msg and return false.
@@ -92,20 +125,87 @@ bool parseArgs(int argc, char* argv[], Config& cfg, std::string& error_msg) {
         else if (arg == "--slow") { if (!next() || !parseInt(argv[i], cfg.sma_slow, error_msg, "--slow")) return false; }
         else if (arg == "--size") { if (!next() || !parseDouble(argv[i], cfg.sma_size, error_msg, "--size")) return false; }
         else if (arg == "--databento-dir") { if (next()) cfg.databento_dir = argv[i]; }
+        else if (arg == "--dbn") { if (next()) cfg.dbn_path = argv[i]; }
         else if (arg == "--symbol") { if (next()) cfg.symbol_filter = argv[i]; }
         else if (arg == "--bar") { if (next()) cfg.bar_resolution = argv[i]; }
+        else if (arg == "--no-cache") { cfg.use_cache = false; }
+        else if (arg == "--session-format") { if (next()) cfg.session_format = argv[i]; }
         else if (arg == "-15m" || arg == "--15m") { cfg.bar_resolution = "15m"; }
         else if (arg == "-1h" || arg == "-1hr" || arg == "--1h" || arg == "--1hr") { cfg.bar_resolution = "1h"; }
         else if (arg == "--ctm-kalman-long") { cfg.ctm_kalman_long = true; }
         else if (arg == "--ctm-kalman-short") { cfg.ctm_kalman_short = true; }
+        else if (arg == "--resting-exits") { cfg.resting_exits = true; }
+        else if (arg == "--portfolio") { cfg.portfolio = true; }
+        else if (arg == "--intrabar") { cfg.intrabar = cfg.resting_exits = true; }
         else if (arg == "--ctm-kalman") { cfg.ctm_kalman_long = cfg.ctm_kalman_short = true; }
         else if (arg == "--orb-session-hour") { if (!next() || !parseInt(argv[i], cfg.orb_session_hour, error_msg, "--orb-session-hour")) return false; }
         else if (arg == "--orb-session-minute") { if (!next() || !parseInt(argv[i], cfg.orb_session_minute, error_msg, "--orb-session-minute")) return false; }
         else if (arg == "--risk-reward" || arg == "--rr") { if (!next() || !parseDouble(argv[i], cfg.one_point_oh_risk_reward, error_msg, arg.c_str())) return false; }
+        else if (arg == "--sweep") { if (next()) cfg.sweep_spec = argv[i]; }
+        else if (arg == "--rank") { if (next()) cfg.sweep_rank = argv[i]; }
+        else if (arg == "--jobs") { if (!next() || !parseInt(argv[i], cfg.jobs, error_msg, "--jobs")) return false; }
+        else if (arg == "--indicator-cache-mb") { if (!next() || !parseInt(argv[i], cfg.indicator_cache_mb, error_msg, "--indicator-cache-mb")) return false; }
+        else if (arg == "--prune-dd") { if (!next() || !parseDouble(argv[i], cfg.prune_dd, error_msg, "--prune-dd")) return false; }
+        else if (arg == "--prune-no-trades") { if (!next() || !parseInt(argv[i], cfg.prune_no_trades, error_msg, "--prune-no-trades")) return false; }
+        else if (arg == "--walk-forward") { if (next()) cfg.walk_forward = argv[i]; }
+        else if (arg == "--monte-carlo") { if (!next() || !parseInt(argv[i], cfg.monte_carlo, error_msg, "--monte-carlo")) return false; }
+        else if (arg == "--mc-method") { if (next()) cfg.mc_method = argv[i]; }
+        else if (arg == "--mc-compound") { cfg.mc_compound = true; }
+        else if (arg == "--mc-seed") { if (!next() || !parseInt(argv[i], cfg.mc_seed, error_msg, "--mc-seed")) return false; }
+        else if (arg == "--prune-percentile") { if (!next() || !parseDouble(argv[i], cfg.prune_percentile, error_msg, "--prune-percentile")) return false; }
     }
     return true;
 }
 
+/// Which chart viewer files a single-symbol run writes (--session-format).
+struct SessionFormats {
+    bool json = false;
+    bool lod = false;
+    bool bin = false;
+};
+
+/// "json", "lod", "bin" comma-separated, or "none". Returns false for anything else.
+bool parseSessionFormats(const std::string& text, SessionFormats& out) {
+    out = SessionFormats{};
+    if (text == "none") return true;
+    std::istringstream iss(text);
+    std::string name;
+    bool any = false;
+    while (std::getline(iss, name, ',')) {
+        if (name == "json") out.json = true;
+        else if (name == "lod") out.lod = true;
+        else if (name == "bin") out.bin = true;
+        else return false;
+        any = true;
+    }
+    return any;
+}
+
+/// Set the Config field a --sweep parameter name stands for. Returns false for an unknown name.
+bool applySweepParam(Config& cfg, const std::string& name, double value) {
+    if (name == "fast") cfg.sma_fast = static_cast<int>(std::lround(value));
+    else if (name == "slow") cfg.sma_slow = static_cast<int>(std::lround(value));
+    else if (name == "size") cfg.sma_size = value;
+    else if (name == "rr" || name == "risk-reward") cfg.one_point_oh_risk_reward = value;
+    else if (name == "orb-session-hour") cfg.orb_session_hour = static_cast<int>(std::lround(value));
+    else if (name == "orb-session-minute") cfg.orb_session_minute = static_cast<int>(std::lround(value));
+    else return false;
+    return true;
+}
+
+/// One sweep combination as a single run: cfg with values (in range order) applied and no --sweep /
+/// --prune-* / --walk-forward options, so validateConfig checks just this run's values.
+Config sweepRunConfig(const Config& cfg, const std::vector<backtest::SweepRange>& ranges, const std::vector<double>& values) {
+    Config run_cfg = cfg;
+    run_cfg.sweep_spec.clear();
+    run_cfg.prune_dd = run_cfg.prune_percentile = 0;
+    run_cfg.prune_no_trades = 0;
+    run_cfg.walk_forward.clear();
+    for (std::size_t k = 0; k < ranges.size(); ++k)
+        applySweepParam(run_cfg, ranges[k].name, values[k]);
+    return run_cfg;
+}
+
 /// Returns false and sets error_msg if config is invalid.
 bool validateConfig(const Config& cfg, std::string& error_msg) {
     if (cfg.initial_cash < 0) { error_msg = "initial cash (--cash) must be >= 0"; return false; }
@@ -116,7 +216,59 @@ bool validateConfig(const Config& cfg, std::string& error_msg) {
     if (cfg.sma_size < 0 || cfg.sma_size > 10) { error_msg = "--size must be between 0 and 10 (fraction of equity)"; return false; }
     if (cfg.orb_session_hour < 0 || cfg.orb_session_hour > 23) { error_msg = "--orb-session-hour must be 0-23"; return false; }
     if (cfg.orb_session_minute < 0 || cfg.orb_session_minute > 59) { error_msg = "--orb-session-minute must be 0-59"; return false; }
+    if (!cfg.dbn_path.empty() && !cfg.databento_dir.empty()) { error_msg = "use either --dbn or --databento-dir, not both"; return false; }
+    backtest::BarResolution res;
+    if (cfg.bar_resolution != "1m" && !backtest::parseBarResolution(cfg.bar_resolution, res)) {
+        error_msg = "--bar must be <N>s, <N>m, <N>h or <N>d, optionally @HH:MM (e.g. 15m, 4h, 1d@22:00)"; return false;
+    }
     if (cfg.one_point_oh_risk_reward <= 0 || cfg.one_point_oh_risk_reward > 100) { error_msg = "--risk-reward must be > 0 and <= 100 (e.g. 1.3 for 1:1.3)"; return false; }
+    SessionFormats formats;
+    if (!parseSessionFormats(cfg.session_format, formats)) {
+        error_msg = "--session-format must be json, lod and / or bin, comma-separated (e.g. lod,bin), or none"; return false;
+    }
+    if (cfg.jobs < 0) { error_msg = "--jobs must be >= 0 (0 = all cores)"; return false; }
+    if (cfg.portfolio && ((cfg.databento_dir.empty() && cfg.dbn_path.empty()) || !cfg.symbol_filter.empty() || !cfg.sweep_spec.empty())) {
+        error_msg = "--portfolio runs every symbol of --databento-dir / --dbn (no --symbol, no --sweep)"; return false;
+    }
+    if (cfg.indicator_cache_mb < 0) { error_msg = "--indicator-cache-mb must be >= 0 (0 = no cache)"; return false; }
+    if (cfg.prune_dd < 0 || cfg.prune_no_trades < 0 || cfg.prune_percentile < 0 || cfg.prune_percentile >= 100) {
+        error_msg = "--prune-dd / --prune-no-trades must be >= 0, --prune-percentile in [0, 100) (0 = off)"; return false;
+    }
+    if ((cfg.prune_dd > 0 || cfg.prune_no_trades > 0 || cfg.prune_percentile > 0) && cfg.sweep_spec.empty()) {
+        error_msg = "--prune-dd / --prune-no-trades / --prune-percentile apply to --sweep runs"; return false;
+    }
+    if (!cfg.walk_forward.empty()) {
+        if (cfg.sweep_spec.empty()) { error_msg = "--walk-forward optimizes a --sweep: give the parameter ranges"; return false; }
+        backtest::WalkForwardSpec spec;
+        if (!backtest::parseWalkForwardSpec(cfg.walk_forward, spec, error_msg)) return false;
+    }
+    if (cfg.monte_carlo < 0) { error_msg = "--monte-carlo must be >= 0 (paths; 0 = off)"; return false; }
+    backtest::MonteCarloMethod mc_method;
+    if (!backtest::parseMonteCarloMethod(cfg.mc_method, mc_method)) { error_msg = "--mc-method must be bootstrap or shuffle"; return false; }
+    if (cfg.monte_carlo > 0 && (!cfg.sweep_spec.empty() || ((!cfg.databento_dir.empty() || !cfg.dbn_path.empty()) && cfg.symbol_filter.empty()))) {
+        error_msg = "--monte-carlo resamples the trades of a single-symbol run (no --sweep; --symbol with --databento-dir / --dbn)"; return false;
+    }
+    if (!cfg.sweep_spec.empty()) {
+        std::vector<backtest::SweepRange> ranges;
+        if (!backtest::parseSweepSpec(cfg.sweep_spec, ranges, error_msg)) return false;
+        Config probe = cfg;
+        for (const auto& r : ranges) {
+            if (!applySweepParam(probe, r.name, r.start)) {
+                error_msg = "--sweep: unknown parameter \"" + r.name + "\" (fast, slow, size, rr, orb-session-hour, orb-session-minute)";
+                return false;
+            }
+        }
+        const std::size_t combinations = backtest::sweepSize(ranges);
+        if (combinations == 0 || combinations > backtest::MAX_SWEEP_COMBINATIONS) {
+            error_msg = "--sweep: too many combinations (at most " + std::to_string(backtest::MAX_SWEEP_COMBINATIONS) + ")";
+            return false;
+        }
+        backtest::SweepRank rank;
+        if (!backtest::parseSweepRank(cfg.sweep_rank, rank)) { error_msg = "--rank must be return, sharpe or drawdown"; return false; }
+        if ((!cfg.databento_dir.empty() || !cfg.dbn_path.empty()) && cfg.symbol_filter.empty()) {
+            error_msg = "--sweep with --databento-dir or --dbn needs --symbol"; return false;
+        }
+    }
     return true;
 }
 
@@ -149,17 +301,21 @@ std::pair<std::unique_ptr<backtest::IStrategy>, std::string> createStrategy(cons
         orb.position_equity_pct = (cfg.sma_size >= 0.01 && cfg.sma_size < 1.0) ? cfg.sma_size : 0.15;
         orb.session_start_hour = cfg.orb_session_hour;
         orb.session_start_minute = cfg.orb_session_minute;
+        orb.resting_exits = cfg.resting_exits;
         strat = createOrbStrategy(orb);
         params = "session=" + std::to_string(orb.session_start_hour) + ":" + std::to_string(orb.session_start_minute) + " " + std::to_string(static_cast<int>(orb.position_equity_pct * 100)) + "% equity EOD exit";
+        if (orb.resting_exits) params += " resting-exits";
     } else if (cfg.strategy_name == "one_point_oh") {
         OnePointOhParams op;
         op.lookback = cfg.sma_fast;
         op.stop_lookback = cfg.sma_slow;
         op.position_fraction = (cfg.sma_size >= 0.01 && cfg.sma_size <= 1.0) ? cfg.sma_size : 0.15;
         op.risk_reward_ratio = cfg.one_point_oh_risk_reward;
+        op.resting_exits = cfg.resting_exits;
         strat = createOnePointOhStrategy(op);
         params = "lookback=" + std::to_string(op.lookback) + " stop_lookback=" + std::to_string(op.stop_lookback)
             + " 1:" + std::to_string(op.risk_reward_ratio) + " R:R";
+        if (op.resting_exits) params += " resting-exits";
     }
 
     return { std::move(strat), params };
@@ -172,6 +328,15 @@ std::size_t minBarsForStrategy(const std::string& name) {
     return MIN_BARS_SMA;
 }
 
+/// Bars a run with cfg's parameters sees before the strategy can trade (its longest lookback).
+std::size_t warmupBars(const Config& cfg) {
+    const auto slow = static_cast<std::size_t>(std::max(cfg.sma_slow, 0));
+    if (cfg.strategy_name == "sma_crossover") return slow;
+    if (cfg.strategy_name == "ctm") return std::max<std::size_t>(slow, CTM_SHORT_SLOW_LOOKBACK);
+    if (cfg.strategy_name == "one_point_oh") return static_cast<std::size_t>(std::max(cfg.sma_fast, 0)) + slow;
+    return minBarsForStrategy(cfg.strategy_name);
+}
+
 //-----------------------------------------------------------------------------
 // Single-symbol backtest: run, report, write files
 //-----------------------------------------------------------------------------
@@ -182,6 +347,8 @@ int runSingle(const Config& cfg,
     std::string data_path = cfg.databento_dir.empty() ? cfg.data_path : "";
     Backtester bt(std::move(strategy), data_path, cfg.initial_cash, cfg.commission,
                   cfg.databento_dir, cfg.symbol_filter, cfg.bar_resolution, cfg.slippage);
+    bt.setUseCache(cfg.use_cache);
+    bt.setIntrabarFills(cfg.intrabar);
 
     if (!bt.run()) {
         if (!cfg.databento_dir.empty())
@@ -191,58 +358,181 @@ int runSingle(const Config& cfg,
         return 1;
     }
 
-    Report report(bt.simulator(), bt.data(), cfg.initial_cash, cfg.strategy_name, strategy_params);
+    Report report(bt.simulator(), bt.bars(), cfg.initial_cash, cfg.strategy_name, strategy_params);
     report.setMetrics(report.computeMetrics());
     if (bt.stoppedEarly())
         report.setStoppedReason(bt.stopReason());
+    if (cfg.monte_carlo > 0) {
+        MonteCarloOptions mc;
+        mc.paths = static_cast<std::size_t>(cfg.monte_carlo);
+        parseMonteCarloMethod(cfg.mc_method, mc.method);  // validated in validateConfig
+        mc.compound = cfg.mc_compound;
+        mc.seed = static_cast<std::uint64_t>(cfg.mc_seed);
+        const std::vector<Trade>& trades = bt.simulator().trades();
+        ThreadPool pool(static_cast<std::size_t>(cfg.jobs));
+        report.setMonteCarlo(summarizeMonteCarlo(runMonteCarlo(trades, cfg.initial_cash, mc, pool), trades.size(), mc));
+        if (report.monteCarlo().paths == 0)
+            std::cerr << "--monte-carlo: no closed trades to resample\n";
+    }
     report.printSummary(std::cout);
 
     fs::create_directories(cfg.reports_dir);
     report.writeTradeLog((fs::path(cfg.reports_dir) / "trades.csv").string());
     report.writeEquityCurve((fs::path(cfg.reports_dir) / "equity_curve.csv").string());
     report.writeReport((fs::path(cfg.reports_dir) / "report.txt").string());
-    report.writeSessionJson((fs::path(cfg.reports_dir) / "session.json").string(),
-                            cfg.symbol_filter.empty() ? "backtest" : cfg.symbol_filter);
+    const std::string session_label = cfg.symbol_filter.empty() ? "backtest" : cfg.symbol_filter;
+    SessionFormats formats;
+    parseSessionFormats(cfg.session_format, formats);  // validated in validateConfig
+    if (formats.json) report.writeSessionJson((fs::path(cfg.reports_dir) / "session.json").string(), session_label);
+    if (formats.lod) report.writeSessionLod((fs::path(cfg.reports_dir) / "session.lod").string(), session_label);
+    if (formats.bin) report.writeSessionBinary((fs::path(cfg.reports_dir) / "session.bin").string(), session_label);
     std::cout << "Reports written to " << cfg.reports_dir << "/\n";
     return 0;
 }
 
+//-----------------------------------------------------------------------------
+// Portfolio backtest: every symbol on one account, bars merged by time
+//-----------------------------------------------------------------------------
+int runPortfolio(const Config& cfg, const std::string& strategy_params, const backtest::DatabentoIndex& index,
+                 const std::vector<std::string>& symbols, backtest::ThreadPool& pool) {
+    using namespace backtest;
+    const std::size_t min_bars = minBarsForStrategy(cfg.strategy_name);
+
+    // Select + aggregate each symbol's series on the pool; the engine shares them read-only.
+    std::vector<std::shared_ptr<const BarSeries>> series(symbols.size());
+    pool.parallelFor(symbols.size(), [&](std::size_t i) {
+        BarSeries sym_bars;
+        index.select(symbols[i], sym_bars);
+        DataSource data("");
+        data.assign(std::move(sym_bars));
+        if (data.aggregateBars(cfg.bar_resolution) && data.size() >= min_bars)
+            series[i] = std::make_shared<const BarSeries>(data.release());
+    });
+
+    PortfolioBacktester pb(createPerSymbolStrategy([&cfg](const std::string&) { return createStrategy(cfg).first; }),
+                           cfg.initial_cash, cfg.commission, cfg.slippage);
+    for (std::size_t i = 0; i < symbols.size(); ++i) {
+        if (series[i])
+            pb.addSymbol(symbols[i], series[i]);
+        else
+            std::cerr << "Skipped " << symbols[i] << ": fewer than " << min_bars << " bars\n";
+    }
+    if (pb.symbolCount() == 0 || !pb.run()) {
+        std::cerr << "All symbols skipped (no bars or load failed).\n";
+        return 1;
+    }
+    const BacktestMetrics m = pb.computeMetrics();
+
+    auto writeTable = [&](std::ostream& out) {
+        out << "Strategy: " << cfg.strategy_name << " (" << strategy_params << ")\n";
+        if (pb.stoppedEarly()) out << "*** Stopped: " << pb.stopReason() << " ***\n";
+        out << "\n" << std::fixed << std::setprecision(2);
+        out << std::setw(10) << "Symbol" << std::setw(10) << "Bars" << std::setw(8) << "Trades"
+            << std::setw(16) << "Realized P&L" << std::setw(12) << "Position" << "\n";
+        out << std::string(56, '-') << "\n";
+        for (std::size_t s = 0; s < pb.symbolCount(); ++s) {
+            const Simulator& sim = pb.simulator(s);
+            double realized = 0;
+            for (const auto& t : sim.trades()) realized += t.pnl;
+            out << std::setw(10) << pb.symbolName(s) << std::setw(10) << pb.bars(s).size()
+                << std::setw(8) << sim.trades().size() << std::setw(16) << realized
+                << std::setw(12) << sim.position() << "\n";
+        }
+        out << std::string(56, '-') << "\n";
+        out << "Initial equity:  " << m.initial_equity << "\n";
+        out << "Final equity:    " << m.final_equity << "\n";
+        out << "Total return:    " << m.total_return_pct << "%\n";
+        out << "Max drawdown:    " << std::min(m.max_drawdown_pct, 100.0) << "%\n";
+        out << "Sharpe ratio:    " << std::setprecision(3) << m.sharpe_ratio << std::setprecision(2) << "\n";
+        out << "Closed trades:   " << m.num_trades << " (win rate " << m.win_rate_pct << "%)\n";
+        out << "Unrealized P&L:  " << m.unrealized_pnl << "\n";
+    };
+
+    std::cout << "\n========== Portfolio backtest (" << pb.symbolCount() << " symbols, one account) ==========\n";
+    writeTable(std::cout);
+    std::cout << "=====================================\n\n";
+
+    fs::create_directories(cfg.reports_dir);
+    std::ofstream f(fs::path(cfg.reports_dir) / "portfolio_summary.txt");
+    if (f) {
+        f << "Portfolio backtest\n";
+        writeTable(f);
+    }
+    std::ofstream eq(fs::path(cfg.reports_dir) / "portfolio_equity.csv");
+    if (eq) {
+        eq << "timestamp,equity\n" << std::fixed << std::setprecision(2);
+        for (std::size_t i = 0; i < pb.equityCurve().size(); ++i)
+            eq << '"' << formatTimestamp(pb.equityTimes()[i]) << "\"," << pb.equityCurve()[i] << "\n";
+    }
+    if (f && eq) std::cout << "Portfolio reports written to " << cfg.reports_dir << "/\n";
+    return 0;
+}
+
 //-----------------------------------------------------------------------------
 // All-symbols backtest: run per symbol, print table, write summary
 //-----------------------------------------------------------------------------
 int runAllSymbols(const Config& cfg, const std::string& strategy_params) {
     using namespace backtest;
-    std::vector<std::string> symbols = DataSource::listSymbolsInDatabentoDir(cfg.databento_dir);
+    // One scan of the directory (or its .btc cache), or one pass over the DBN file, serves every symbol below.
+    const std::string& source = cfg.dbn_path.empty() ? cfg.databento_dir : cfg.dbn_path;
+    ThreadPool pool(static_cast<std::size_t>(cfg.jobs));
+    DatabentoIndex index;
+    const bool loaded = cfg.dbn_path.empty() ? index.build(cfg.databento_dir, cfg.use_cache, &pool)
+                                             : index.buildFromDbn(cfg.dbn_path, &pool);
+    if (!loaded) {
+        std::cerr << "Failed to load " << source << "\n";
+        return 1;
+    }
+    std::vector<std::string> symbols = index.symbolNames();
     if (symbols.empty()) {
-        std::cerr << "No symbols found in " << cfg.databento_dir << "\n";
+        std::cerr << "No symbols found in " << source << "\n";
         return 1;
     }
 
+    if (cfg.portfolio)
+        return runPortfolio(cfg, strategy_params, index, symbols, pool);
+
     struct SymbolResult {
         std::string symbol;
         BacktestMetrics metrics;
         std::string stop_reason;
+        std::string skipped;  // reason the symbol was skipped; empty = ran
     };
-    std::vector<SymbolResult> results;
     const std::size_t min_bars = minBarsForStrategy(cfg.strategy_name);
 
-    for (const std::string& sym : symbols) {
+    // Symbols run concurrently, each into its own slot; the table below keeps index order.
+    std::vector<SymbolResult> slots(symbols.size());
+    pool.parallelFor(symbols.size(), [&](std::size_t i) {
+        const std::string& sym = symbols[i];
+        SymbolResult& out = slots[i];
+        out.symbol = sym;
         auto [sym_strategy, params] = createStrategy(cfg);
-        Backtester bt(std::move(sym_strategy), "", cfg.initial_cash, cfg.commission,
-                      cfg.databento_dir, sym, cfg.bar_resolution, cfg.slippage);
-
-        if (!bt.run() || bt.data().empty()) {
-            std::cerr << "Skipped " << sym << ": no bars or load failed\n";
-            continue;
+        BarSeries sym_bars;
+        index.select(sym, sym_bars);
+        Backtester bt(std::move(sym_strategy), std::move(sym_bars), cfg.initial_cash, cfg.commission,
+                      cfg.bar_resolution, cfg.slippage);
+        bt.setIntrabarFills(cfg.intrabar);
+
+        if (!bt.run() || bt.bars().empty()) {
+            out.skipped = "no bars or load failed";
+            return;
         }
-        if (bt.data().size() < min_bars) {
-            std::cerr << "Skipped " << sym << ": only " << bt.data().size() << " bars (need " << min_bars << ")\n";
-            continue;
+        if (bt.bars().size() < min_bars) {
+            out.skipped = "only " + std::to_string(bt.bars().size()) + " bars (need " + std::to_string(min_bars) + ")";
+            return;
         }
 
-        Report r(bt.simulator(), bt.data(), cfg.initial_cash, cfg.strategy_name, strategy_params);
-        r.setMetrics(r.computeMetrics());
-        results.push_back({ sym, r.metrics(), bt.stoppedEarly() ? bt.stopReason() : "" });
+        Report r(bt.simulator(), bt.bars(), cfg.initial_cash, cfg.strategy_name, strategy_params);
+        out.metrics = r.computeMetrics();
+        out.stop_reason = bt.stoppedEarly() ? bt.stopReason() : "";
+    });
+
+    std::vector<SymbolResult> results;
+    for (auto& slot : slots) {
+        if (!slot.skipped.empty())
+            std::cerr << "Skipped " << slot.symbol << ": " << slot.skipped << "\n";
+        else
+            results.push_back(std::move(slot));
     }
 
     if (results.empty()) {
@@ -300,6 +590,196 @@ int runAllSymbols(const Config& cfg, const std::string& strategy_params) {
     return 0;
 }
 
+//-----------------------------------------------------------------------------
+// Walk-forward (--sweep + --walk-forward): optimize each in-sample window, run the winner out of sample
+//-----------------------------------------------------------------------------
+int runWalkForwardMode(const Config& cfg, const std::shared_ptr<const backtest::BarSeries>& bars,
+                       const std::vector<backtest::SweepRange>& ranges, backtest::SweepRank rank,
+                       const backtest::SweepStrategyFactory& factory, const backtest::SweepOptions& options,
+                       backtest::ThreadPool& pool) {
+    using namespace backtest;
+    WalkForwardSpec spec;
+    std::string error_msg;
+    parseWalkForwardSpec(cfg.walk_forward, spec, error_msg);  // validated in validateConfig
+    const std::vector<WalkForwardWindow> windows = walkForwardWindows(*bars, spec);
+    if (windows.empty()) {
+        std::cerr << "--walk-forward " << cfg.walk_forward << ": no in-sample / out-of-sample windows fit the "
+                  << bars->size() << " bars\n";
+        return 1;
+    }
+    // Each out-of-sample run starts cold (runWalkForward): reject windows too short for the strategy to
+    // trade at all. The last of several windows may be cut short by the end of the series.
+    std::vector<double> longest(ranges.size());
+    for (std::size_t k = 0; k < ranges.size(); ++k) longest[k] = ranges[k].value(ranges[k].count() - 1);
+    const std::size_t warmup = warmupBars(sweepRunConfig(cfg, ranges, longest));
+    const std::size_t full_windows = windows.size() > 1 ? windows.size() - 1 : 1;
+    for (std::size_t k = 0; k < full_windows; ++k) {
+        const std::size_t oos_bars = windows[k].oos_end - windows[k].oos_begin;
+        if (oos_bars > warmup) continue;
+        std::cerr << "--walk-forward " << cfg.walk_forward << ": out-of-sample window " << k << " has " << oos_bars
+                  << " bars, but " << cfg.strategy_name << " needs " << warmup << " before it can trade (the sweep's"
+                  << " longest lookback); each out-of-sample run starts cold, so use a longer out-of-sample length\n";
+        return 1;
+    }
+    std::cout << "Walk-forward: " << windows.size() << " windows of " << sweepSize(ranges) << " combinations over "
+              << bars->size() << " bars on " << pool.size() << " threads...\n";
+
+    const WalkForwardReport report = runWalkForward(bars, windows, ranges, factory, options, rank, pool);
+    if (report.windows.empty()) {
+        std::cerr << "No valid parameter combinations in --sweep " << cfg.sweep_spec << "\n";
+        return 1;
+    }
+
+    std::cout << "\n========== Walk-forward ==========\n";
+    std::cout << "Strategy: " << cfg.strategy_name << "  " << (spec.anchored ? "anchored" : "rolling")
+              << " windows " << cfg.walk_forward << ", in-sample winner by " << cfg.sweep_rank << "\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(4) << "#" << std::setw(22) << "OOS start";
+    for (const auto& r : ranges) std::cout << std::setw(10) << r.name;
+    std::cout << std::setw(10) << "IS ret %" << std::setw(11) << "OOS ret %" << std::setw(10) << "MaxDD %"
+              << std::setw(8) << "Trades" << std::setw(14) << "Final equity" << "\n";
+    const std::size_t width = ranges.size() * 10 + 79;
+    std::cout << std::string(width, '-') << "\n";
+    for (std::size_t k = 0; k < report.windows.size(); ++k) {
+        const auto& r = report.windows[k];
+        std::cout << std::setw(4) << k << std::setw(22) << formatTimestamp(bars->times()[r.window.oos_begin]);
+        for (double v : r.best.values) std::cout << std::setw(10) << v;
+        std::cout << std::setw(10) << r.best.metrics.total_return_pct << std::setw(11) << r.oos.total_return_pct
+                  << std::setw(10) << std::min(r.oos.max_drawdown_pct, 100.0) << std::setw(8) << r.oos.num_trades
+                  << std::setw(14) << r.oos.final_equity << "\n";
+    }
+    std::cout << std::string(width, '-') << "\n";
+    const double final_equity = report.oos_equity.empty() ? cfg.initial_cash : report.oos_equity.back();
+    std::cout << "Stitched out-of-sample: " << report.oos_equity.size() << " bars, return "
+              << (final_equity - cfg.initial_cash) / cfg.initial_cash * 100.0 << "%, final equity " << final_equity << "\n";
+    std::cout << "==================================\n\n";
+
+    fs::create_directories(cfg.reports_dir);
+    const std::string csv_path = (fs::path(cfg.reports_dir) / "walk_forward.csv").string();
+    const std::string equity_path = (fs::path(cfg.reports_dir) / "walk_forward_equity.csv").string();
+    if (writeWalkForwardCsv(csv_path, *bars, ranges, report) && writeWalkForwardEquity(equity_path, *bars, report))
+        std::cout << "Walk-forward results written to " << csv_path << " and " << equity_path << "\n";
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// Parameter sweep: load + aggregate once, run every combination on a thread pool
+//-----------------------------------------------------------------------------
+int runSweepMode(const Config& cfg) {
+    using namespace backtest;
+    std::vector<SweepRange> ranges;
+    std::string error_msg;
+    SweepRank rank = SweepRank::Return;
+    parseSweepSpec(cfg.sweep_spec, ranges, error_msg);  // validated in validateConfig
+    parseSweepRank(cfg.sweep_rank, rank);
+
+    DataSource data(cfg.databento_dir.empty() ? cfg.data_path : "");
+    data.setUseCache(cfg.use_cache);
+    bool ok;
+    if (!cfg.databento_dir.empty())
+        ok = data.loadFromDatabentoDir(cfg.databento_dir, cfg.symbol_filter);
+    else if (DataSource::isDbnPath(cfg.data_path))
+        ok = data.loadFromDbn(cfg.symbol_filter);
+    else
+        ok = data.load();
+    IntrabarSeries intrabar;
+    if (!ok || data.empty() || !data.aggregateBars(cfg.bar_resolution, cfg.intrabar ? &intrabar : nullptr)) {
+        std::cerr << "Failed to load bars for sweep (check data source and --symbol)\n";
+        return 1;
+    }
+    const std::size_t min_bars = minBarsForStrategy(cfg.strategy_name);
+    if (data.size() < min_bars) {
+        std::cerr << "Only " << data.size() << " bars (need " << min_bars << ")\n";
+        return 1;
+    }
+    // Every run reads this one series; nothing below copies or mutates it.
+    const std::shared_ptr<const BarSeries> bars = std::make_shared<const BarSeries>(data.release());
+
+    const bool fast_below_slow = (cfg.strategy_name == "sma_crossover" || cfg.strategy_name == "ctm");
+    SweepStrategyFactory factory = [&](const std::vector<double>& values) -> std::unique_ptr<IStrategy> {
+        const Config run_cfg = sweepRunConfig(cfg, ranges, values);
+        std::string run_error;
+        if (!validateConfig(run_cfg, run_error)) return nullptr;
+        if (fast_below_slow && run_cfg.sma_fast >= run_cfg.sma_slow) return nullptr;
+        return createStrategy(run_cfg).first;
+    };
+
+    PruneCriteria prune;
+    prune.max_drawdown_pct = cfg.prune_dd;
+    prune.no_trade_bars = static_cast<std::size_t>(cfg.prune_no_trades);
+    prune.equity_percentile = cfg.prune_percentile;
+
+    // sma_crossover sweeps over fast / slow / size run all combinations in lockstep (sma_lockstep.hpp),
+    // unless runs are pruned (the lockstep lanes only have the built-in stops).
+    bool lockstep = (cfg.strategy_name == "sma_crossover") && !prune.any();
+    for (const auto& r : ranges)
+        lockstep = lockstep && (r.name == "fast" || r.name == "slow" || r.name == "size");
+    SmaLaneFactory lane_factory = [&](const std::vector<double>& values, SmaLane& lane) {
+        const Config run_cfg = sweepRunConfig(cfg, ranges, values);
+        std::string run_error;
+        if (!validateConfig(run_cfg, run_error) || run_cfg.sma_fast >= run_cfg.sma_slow) return false;
+        lane.fast = run_cfg.sma_fast;
+        lane.slow = run_cfg.sma_slow;
+        lane.size = run_cfg.sma_size;
+        return true;
+    };
+
+    const std::size_t total = sweepSize(ranges);
+    ThreadPool pool(static_cast<std::size_t>(cfg.jobs));
+    SweepOptions options;
+    options.initial_cash = cfg.initial_cash;
+    options.commission = cfg.commission;
+    options.slippage = cfg.slippage;
+    options.indicator_cache_bytes = static_cast<std::size_t>(cfg.indicator_cache_mb) << 20;
+    if (!intrabar.empty()) options.intrabar = std::make_shared<const IntrabarSeries>(std::move(intrabar));
+    options.prune = prune;
+    if (!cfg.walk_forward.empty())
+        return runWalkForwardMode(cfg, bars, ranges, rank, factory, options, pool);
+
+    std::cout << "Sweeping " << total << " combinations over " << bars->size() << " bars on "
+              << pool.size() << " threads" << (lockstep ? std::string(" (lockstep, ") + smaLockstepIsa() + ")" : "")
+              << "...\n";
+    std::vector<SweepResult> results = lockstep ? runSmaSweep(*bars, ranges, lane_factory, options, pool)
+                                                : runSweep(bars, ranges, factory, options, pool);
+    if (results.empty()) {
+        std::cerr << "No valid parameter combinations in --sweep " << cfg.sweep_spec << "\n";
+        return 1;
+    }
+    rankSweepResults(results, rank);
+
+    // Console table: best SWEEP_TOP_N by --rank
+    std::cout << "\n========== Parameter sweep ==========\n";
+    std::cout << "Strategy: " << cfg.strategy_name << "  runs: " << results.size() << " of " << total
+              << " (" << (total - results.size()) << " skipped";
+    if (prune.any()) {
+        const auto pruned = std::count_if(results.begin(), results.end(), [](const SweepResult& r) { return r.pruned(); });
+        std::cout << ", " << pruned << " pruned";
+    }
+    std::cout << ")  ranked by " << cfg.sweep_rank << "\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& r : ranges) std::cout << std::setw(10) << r.name;
+    std::cout << std::setw(12) << "Return %" << std::setw(10) << "MaxDD %" << std::setw(10) << "Sharpe"
+              << std::setw(8) << "Trades" << std::setw(14) << "Final equity" << "\n";
+    const std::size_t width = ranges.size() * 10 + 54;
+    std::cout << std::string(width, '-') << "\n";
+    const std::size_t shown = std::min(results.size(), SWEEP_TOP_N);
+    for (std::size_t i = 0; i < shown; ++i) {
+        const auto& m = results[i].metrics;
+        for (double v : results[i].values) std::cout << std::setw(10) << v;
+        std::cout << std::setw(12) << m.total_return_pct << std::setw(10) << std::min(m.max_drawdown_pct, 100.0)
+                  << std::setw(10) << m.sharpe_ratio << std::setw(8) << m.num_trades
+                  << std::setw(14) << m.final_equity << "\n";
+    }
+    std::cout << std::string(width, '-') << "\n";
+    std::cout << "=====================================\n\n";
+
+    fs::create_directories(cfg.reports_dir);
+    const std::string csv_path = (fs::path(cfg.reports_dir) / "sweep_results.csv").string();
+    if (writeSweepCsv(csv_path, ranges, results))
+        std::cout << "Sweep results written to " << csv_path << "\n";
+    return 0;
+}
+
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -329,7 +809,11 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    if (!cfg.databento_dir.empty() && cfg.symbol_filter.empty())
+    if (!cfg.dbn_path.empty())
+        cfg.data_path = cfg.dbn_path;
+    if (!cfg.sweep_spec.empty())
+        return runSweepMode(cfg);
+    if ((!cfg.databento_dir.empty() || !cfg.dbn_path.empty()) && cfg.symbol_filter.empty())
         return runAllSymbols(cfg, strategy_params);
 
     return runSingle(cfg, std::move(strategy), strategy_params);
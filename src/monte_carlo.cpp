@@ -0,0 +1,166 @@
+#include "monte_carlo.hpp"
+#include "bar_series.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace backtest {
+
+namespace {
+
+constexpr std::size_t LANES = 16;            // paths advanced together, one array slot each
+constexpr std::size_t PATHS_PER_TASK = 512;  // paths per parallelFor index (32 lane groups)
+constexpr std::uint64_t GOLDEN = 0x9E3779B97F4A7C15ull;
+
+/// splitmix64's output function.
+inline std::uint64_t mix64(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/// Per-lane state of one group of paths.
+struct alignas(64) LaneGroup {
+    std::uint64_t rng[LANES];
+    double equity[LANES];
+    double peak[LANES];
+    double max_dd[LANES];  // fraction of peak
+    std::uint32_t pick[LANES];
+    double value[LANES];
+
+    void reset(std::uint64_t seed, std::size_t first_path, double initial_cash) {
+        for (std::size_t l = 0; l < LANES; ++l) {
+            rng[l] = mix64(seed ^ mix64(static_cast<std::uint64_t>(first_path + l) + 1));
+            equity[l] = initial_cash;
+            peak[l] = initial_cash;
+            max_dd[l] = 0;
+        }
+    }
+
+    /// pick[l] = a uniform draw from [lo, lo + n) per lane (n < 2^32, multiply-shift instead of a modulo).
+    void draw(std::uint32_t lo, std::uint32_t n) {
+        for (std::size_t l = 0; l < LANES; ++l) {
+            rng[l] += GOLDEN;
+            const std::uint64_t hi = mix64(rng[l]) >> 32;
+            pick[l] = lo + static_cast<std::uint32_t>((hi * n) >> 32);
+        }
+    }
+
+    /// Apply value[l] (a P&L, or a return when Compound) to each lane's equity, peak and drawdown.
+    /// Equity stops at 0: a ruined path stays ruined, as a Backtester run stops on zero equity.
+    template <bool Compound>
+    void step() {
+        for (std::size_t l = 0; l < LANES; ++l) {
+            const double next = Compound ? equity[l] * (1.0 + value[l]) : equity[l] + value[l];
+            const double eq = equity[l] > 0 ? std::max(next, 0.0) : 0.0;
+            const double pk = std::max(peak[l], eq);
+            equity[l] = eq;
+            peak[l] = pk;
+            max_dd[l] = std::max(max_dd[l], (pk - eq) / pk);
+        }
+    }
+};
+
+/// Paths [first, first + count) into out.
+template <bool Compound>
+void runPaths(const std::vector<double>& values, double initial_cash, const MonteCarloOptions& options,
+              std::size_t first, std::size_t count, MonteCarloPaths& out) {
+    const std::size_t n = values.size();
+    const auto n32 = static_cast<std::uint32_t>(n);
+    const bool shuffle = options.method == MonteCarloMethod::Shuffle;
+    // Shuffle: each lane's own copy of the values, interleaved (value k of lane l at k * LANES + l), and
+    // permuted as it is walked (step k swaps a random later value into slot k: Fisher-Yates).
+    AlignedVector<double> deck(shuffle ? n * LANES : 0);
+    LaneGroup g;
+
+    for (std::size_t group = first; group < first + count; group += LANES) {
+        g.reset(options.seed, group, initial_cash);
+        if (shuffle) {
+            for (std::size_t k = 0; k < n; ++k)
+                std::fill(deck.begin() + static_cast<std::ptrdiff_t>(k * LANES),
+                          deck.begin() + static_cast<std::ptrdiff_t>((k + 1) * LANES), values[k]);
+        }
+        for (std::size_t k = 0; k < n; ++k) {
+            if (shuffle) {
+                g.draw(static_cast<std::uint32_t>(k), n32 - static_cast<std::uint32_t>(k));
+                double* const slot = deck.data() + k * LANES;
+                for (std::size_t l = 0; l < LANES; ++l) {
+                    double* const other = deck.data() + std::size_t(g.pick[l]) * LANES + l;
+                    g.value[l] = *other;
+                    *other = slot[l];
+                }
+            } else {
+                g.draw(0, n32);
+                for (std::size_t l = 0; l < LANES; ++l) g.value[l] = values[g.pick[l]];
+            }
+            g.step<Compound>();
+        }
+        const std::size_t valid = std::min(LANES, first + count - group);
+        for (std::size_t l = 0; l < valid; ++l) {
+            out.return_pct[group + l] = (g.equity[l] - initial_cash) / initial_cash * 100.0;
+            out.max_drawdown_pct[group + l] = g.max_dd[l] * 100.0;
+        }
+    }
+}
+
+} // namespace
+
+bool parseMonteCarloMethod(const std::string& name, MonteCarloMethod& out) {
+    if (name == "bootstrap") { out = MonteCarloMethod::Bootstrap; return true; }
+    if (name == "shuffle") { out = MonteCarloMethod::Shuffle; return true; }
+    return false;
+}
+
+MonteCarloPaths runMonteCarlo(const std::vector<Trade>& trades, double initial_cash,
+                              const MonteCarloOptions& options, ThreadPool& pool) {
+    MonteCarloPaths out;
+    if (trades.empty() || initial_cash <= 0 || options.paths == 0 || trades.size() >= (std::size_t(1) << 32))
+        return out;
+
+    // What a path draws: each trade's P&L, or its return on the closed-trade equity before it
+    std::vector<double> values(trades.size());
+    double equity = initial_cash;
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+        values[i] = options.compound ? (equity > 0 ? trades[i].pnl / equity : 0.0) : trades[i].pnl;
+        equity += trades[i].pnl;
+    }
+
+    out.return_pct.resize(options.paths);
+    out.max_drawdown_pct.resize(options.paths);
+    const std::size_t tasks = (options.paths + PATHS_PER_TASK - 1) / PATHS_PER_TASK;
+    pool.parallelFor(tasks, [&](std::size_t t) {
+        const std::size_t first = t * PATHS_PER_TASK;
+        const std::size_t count = std::min(PATHS_PER_TASK, options.paths - first);
+        if (options.compound) runPaths<true>(values, initial_cash, options, first, count, out);
+        else runPaths<false>(values, initial_cash, options, first, count, out);
+    });
+    return out;
+}
+
+MonteCarloSummary summarizeMonteCarlo(const MonteCarloPaths& paths, std::size_t trades, const MonteCarloOptions& options) {
+    MonteCarloSummary s;
+    s.paths = paths.return_pct.size();
+    s.trades = trades;
+    s.method = options.method;
+    s.compound = options.compound;
+    if (s.paths == 0) return s;
+
+    std::vector<double> returns = paths.return_pct;
+    std::vector<double> drawdowns = paths.max_drawdown_pct;
+    std::sort(returns.begin(), returns.end());
+    std::sort(drawdowns.begin(), drawdowns.end());
+    for (std::size_t k = 0; k < MONTE_CARLO_PERCENTILE_COUNT; ++k) {
+        const auto i = static_cast<std::size_t>(MONTE_CARLO_PERCENTILES[k] / 100.0 * static_cast<double>(s.paths - 1));
+        s.return_pct[k] = returns[i];
+        s.max_drawdown_pct[k] = drawdowns[i];
+    }
+    const double n = static_cast<double>(s.paths);
+    s.mean_return_pct = std::accumulate(returns.begin(), returns.end(), 0.0) / n;
+    const auto losses = std::lower_bound(returns.begin(), returns.end(), 0.0) - returns.begin();
+    const auto ruined = drawdowns.end() - std::lower_bound(drawdowns.begin(), drawdowns.end(), 100.0);
+    s.loss_probability_pct = 100.0 * static_cast<double>(losses) / n;
+    s.ruin_probability_pct = 100.0 * static_cast<double>(ruined) / n;
+    return s;
+}
+
+} // namespace backtest
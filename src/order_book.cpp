@@ -0,0 +1,193 @@
+#include "order_book.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace backtest {
+
+namespace {
+
+constexpr double NEVER = std::numeric_limits<double>::infinity();
+
+/// Assumed price path through a bar: p[0] = open, p[3] = close, extremes in between.
+/// Positions run from 0 (open) to 3 (close); segment k goes from p[k] to p[k + 1].
+struct IntrabarPath {
+    double p[4];
+
+    explicit IntrabarPath(const Bar& bar) {
+        const bool up = bar.close >= bar.open;
+        p[0] = bar.open;
+        p[1] = up ? bar.low : bar.high;
+        p[2] = up ? bar.high : bar.low;
+        p[3] = bar.close;
+    }
+
+    /// First position >= from where price is >= level (rising) or <= level (falling); NEVER if the bar
+    /// doesn't get there. price = the price there (from_price if already through, else level).
+    double reach(double level, bool rising, double from, double from_price, double& price) const {
+        if (rising ? from_price >= level : from_price <= level) {
+            price = from_price;
+            return from;
+        }
+        for (std::size_t k = static_cast<std::size_t>(from); k < 3; ++k) {
+            const double b = p[k + 1];
+            if (rising ? b >= level : b <= level) {
+                price = level;
+                return std::max(from, static_cast<double>(k) + (level - p[k]) / (b - p[k]));
+            }
+        }
+        return NEVER;
+    }
+};
+
+/// Path position where the order fills and its price before slippage; NEVER if not this bar.
+double trigger(const IntrabarPath& path, const Order& o, double from, double from_price, double& price) {
+    const bool buy = o.side == Side::Long;
+    switch (o.type) {
+    case OrderType::Market:
+        price = from_price;
+        return from;
+    case OrderType::Limit:
+        return path.reach(o.limit_price, !buy, from, from_price, price);
+    case OrderType::Stop:
+        return path.reach(o.stop_price, buy, from, from_price, price);
+    case OrderType::StopLimit: {
+        double armed_price = 0;
+        const double armed = path.reach(o.stop_price, buy, from, from_price, armed_price);
+        if (armed == NEVER) return NEVER;
+        return path.reach(o.limit_price, !buy, armed, armed_price, price);
+    }
+    }
+    return NEVER;
+}
+
+/// Market and stop orders pay slippage; limits fill at their price or better.
+bool paysSlippage(OrderType type) { return type == OrderType::Market || type == OrderType::Stop; }
+
+} // namespace
+
+OrderId OrderBook::submit(Order order) {
+    if (order.quantity <= 0) return 0;
+    if ((order.type == OrderType::Limit || order.type == OrderType::StopLimit) && order.limit_price <= 0) return 0;
+    if ((order.type == OrderType::Stop || order.type == OrderType::StopLimit) && order.stop_price <= 0) return 0;
+    if (order.parent_id != 0 && !contains(order.parent_id)) return 0;
+    order.id = next_id_++;
+    orders_.push_back({ order, 0, 0 });
+    return order.id;
+}
+
+BracketOrderIds OrderBook::submitBracket(const Order& entry, double stop_price, double target_price) {
+    BracketOrderIds ids;
+    ids.entry = submit(entry);
+    if (ids.entry == 0) return ids;
+
+    Order exit;
+    exit.side = entry.side == Side::Long ? Side::Short : Side::Long;
+    exit.quantity = entry.quantity;
+    exit.parent_id = ids.entry;
+    exit.oco_group = ids.entry;
+    exit.reduce_only = true;
+    if (stop_price > 0) {
+        exit.type = OrderType::Stop;
+        exit.stop_price = stop_price;
+        ids.stop = submit(exit);
+    }
+    if (target_price > 0) {
+        exit.type = OrderType::Limit;
+        exit.stop_price = 0;
+        exit.limit_price = target_price;
+        ids.target = submit(exit);
+    }
+    return ids;
+}
+
+const Order* OrderBook::find(OrderId id) const {
+    for (const auto& r : orders_)
+        if (r.order.id == id) return &r.order;
+    return nullptr;
+}
+
+bool OrderBook::cancel(OrderId id) {
+    auto it = std::find_if(orders_.begin(), orders_.end(), [id](const Resting& r) { return r.order.id == id; });
+    if (it == orders_.end()) return false;
+    orders_.erase(it);
+    cancelChildren(id);
+    return true;
+}
+
+void OrderBook::cancelChildren(OrderId parent) {
+    for (std::size_t i = 0; i < orders_.size();) {
+        if (orders_[i].order.parent_id == parent) {
+            const OrderId child = orders_[i].order.id;
+            orders_.erase(orders_.begin() + static_cast<std::ptrdiff_t>(i));
+            cancelChildren(child);
+            i = 0;  // the recursion may have removed earlier entries
+        } else {
+            ++i;
+        }
+    }
+}
+
+void OrderBook::removeGroup(OrderId oco_group) {
+    for (std::size_t i = 0; i < orders_.size();) {
+        if (orders_[i].order.oco_group == oco_group) {
+            const OrderId id = orders_[i].order.id;
+            orders_.erase(orders_.begin() + static_cast<std::ptrdiff_t>(i));
+            cancelChildren(id);
+            i = 0;
+        } else {
+            ++i;
+        }
+    }
+}
+
+void OrderBook::match(const Bar& bar, double slippage, const FillFn& fill) {
+    if (orders_.empty()) return;
+    const IntrabarPath path(bar);
+    for (auto& r : orders_) {
+        r.from = 0;
+        r.from_price = bar.open;
+    }
+
+    for (;;) {
+        // Next fill along the path: earliest position, then stops / market before limits, then oldest.
+        std::size_t best = orders_.size();
+        double best_t = NEVER, best_price = 0;
+        int best_rank = 0;
+        for (std::size_t i = 0; i < orders_.size(); ++i) {
+            const Resting& r = orders_[i];
+            if (r.order.parent_id != 0) continue;
+            double price = 0;
+            const double t = trigger(path, r.order, r.from, r.from_price, price);
+            if (t == NEVER) continue;
+            const int rank = paysSlippage(r.order.type) ? 0 : 1;
+            if (t < best_t || (t == best_t && rank < best_rank)) {
+                best = i;
+                best_t = t;
+                best_price = price;
+                best_rank = rank;
+            }
+        }
+        if (best == orders_.size()) break;
+
+        const Order order = orders_[best].order;
+        orders_.erase(orders_.begin() + static_cast<std::ptrdiff_t>(best));
+        double fill_price = best_price;
+        if (slippage > 0 && paysSlippage(order.type))
+            fill_price *= order.side == Side::Long ? (1.0 + slippage) : (1.0 - slippage);
+
+        const bool filled = fill(order, fill_price);
+        if (order.oco_group != 0) removeGroup(order.oco_group);
+        if (!filled) {
+            cancelChildren(order.id);
+            continue;
+        }
+        for (auto& r : orders_) {
+            if (r.order.parent_id != order.id) continue;
+            r.order.parent_id = 0;
+            r.from = best_t;
+            r.from_price = best_price;
+        }
+    }
+}
+
+} // namespace backtest
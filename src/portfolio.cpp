@@ -0,0 +1,257 @@
+#include "portfolio.hpp"
+#include "context.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace backtest {
+
+//-----------------------------------------------------------------------------
+// Context handed to the portfolio strategy
+//-----------------------------------------------------------------------------
+class PortfolioBacktester::Context : public IPortfolioContext {
+public:
+    explicit Context(PortfolioBacktester& pb) : pb_(pb) {}
+
+    std::size_t symbolCount() const override { return pb_.symbols_.size(); }
+    const std::string& symbolName(std::size_t symbol) const override { return pb_.symbols_[symbol].name; }
+    std::int64_t time() const override { return pb_.now_; }
+
+    void placeOrder(std::size_t symbol, Side side, double quantity) override {
+        sim(symbol).placeOrder(side, quantity);
+    }
+    OrderId submitOrder(std::size_t symbol, const Order& order) override { return sim(symbol).submitOrder(order); }
+    BracketOrderIds submitBracket(std::size_t symbol, const Order& entry, double stop_price, double target_price) override {
+        return sim(symbol).submitBracket(entry, stop_price, target_price);
+    }
+    bool cancelOrder(std::size_t symbol, OrderId id) override { return sim(symbol).cancelOrder(id); }
+    bool isOrderOpen(std::size_t symbol, OrderId id) const override {
+        return pb_.symbols_[symbol].sim.orderBook().contains(id);
+    }
+
+    double position(std::size_t symbol) const override { return pb_.symbols_[symbol].sim.position(); }
+    double lastClose(std::size_t symbol) const override { return pb_.symbols_[symbol].sim.lastClose(); }
+    std::size_t barIndex(std::size_t symbol) const override {
+        const std::size_t n = pb_.symbols_[symbol].next;
+        return n > 0 ? n - 1 : 0;
+    }
+    BarSeriesView bars(std::size_t symbol) const override {
+        const Symbol& s = pb_.symbols_[symbol];
+        return s.bars->view(0, s.next);
+    }
+
+    double equity() const override { return pb_.equity_; }
+    double cash() const override { return pb_.cash_; }
+
+private:
+    Simulator& sim(std::size_t symbol) { return pb_.symbols_[symbol].sim; }
+
+    PortfolioBacktester& pb_;
+};
+
+//-----------------------------------------------------------------------------
+// One IStrategy per symbol
+//-----------------------------------------------------------------------------
+namespace {
+
+/// IContext of one symbol inside a portfolio: orders and position are the symbol's, equity and cash
+/// the account's.
+class SymbolContext : public IContext {
+public:
+    SymbolContext(IPortfolioContext& ctx, std::size_t symbol) : ctx_(ctx), symbol_(symbol) {}
+
+    void placeOrder(Side side, double quantity) override { ctx_.placeOrder(symbol_, side, quantity); }
+    OrderId submitOrder(const Order& order) override { return ctx_.submitOrder(symbol_, order); }
+    BracketOrderIds submitBracket(const Order& entry, double stop_price, double target_price) override {
+        return ctx_.submitBracket(symbol_, entry, stop_price, target_price);
+    }
+    bool cancelOrder(OrderId id) override { return ctx_.cancelOrder(symbol_, id); }
+    bool isOrderOpen(OrderId id) const override { return ctx_.isOrderOpen(symbol_, id); }
+
+    double position() const override { return ctx_.position(symbol_); }
+    double equity() const override { return ctx_.equity(); }
+    double cash() const override { return ctx_.cash(); }
+    double lastClose() const override { return ctx_.lastClose(symbol_); }
+    std::size_t barIndex() const override { return ctx_.barIndex(symbol_); }
+    BarSeriesView bars() const override { return ctx_.bars(symbol_); }
+
+private:
+    IPortfolioContext& ctx_;
+    std::size_t symbol_;
+};
+
+class PerSymbolStrategy : public IPortfolioStrategy {
+public:
+    explicit PerSymbolStrategy(SymbolStrategyFactory factory) : factory_(std::move(factory)) {}
+
+    void onStart(IPortfolioContext& ctx) override {
+        strategies_.clear();
+        contexts_.clear();
+        contexts_.reserve(ctx.symbolCount());
+        for (std::size_t s = 0; s < ctx.symbolCount(); ++s) {
+            strategies_.push_back(factory_(ctx.symbolName(s)));
+            contexts_.emplace_back(ctx, s);
+            if (strategies_.back()) strategies_.back()->onStart(contexts_.back());
+        }
+    }
+
+    void onBar(std::size_t symbol, const Bar& bar, IPortfolioContext& /*ctx*/) override {
+        if (strategies_[symbol]) strategies_[symbol]->onBar(bar, contexts_[symbol]);
+    }
+
+    void onEnd(IPortfolioContext& /*ctx*/) override {
+        for (std::size_t s = 0; s < strategies_.size(); ++s)
+            if (strategies_[s]) strategies_[s]->onEnd(contexts_[s]);
+    }
+
+private:
+    SymbolStrategyFactory factory_;
+    std::vector<std::unique_ptr<IStrategy>> strategies_;
+    std::vector<SymbolContext> contexts_;
+};
+
+} // namespace
+
+std::unique_ptr<IPortfolioStrategy> createPerSymbolStrategy(SymbolStrategyFactory factory) {
+    return std::make_unique<PerSymbolStrategy>(std::move(factory));
+}
+
+//-----------------------------------------------------------------------------
+// PortfolioBacktester
+//-----------------------------------------------------------------------------
+PortfolioBacktester::PortfolioBacktester(std::unique_ptr<IPortfolioStrategy> strategy,
+                                         double initial_cash,
+                                         double commission,
+                                         double slippage)
+    : strategy_(std::move(strategy))
+    , initial_cash_(initial_cash)
+    , commission_(commission)
+    , slippage_(slippage)
+    , cash_(initial_cash)
+    , equity_(initial_cash)
+{
+}
+
+PortfolioBacktester::~PortfolioBacktester() = default;
+
+std::size_t PortfolioBacktester::addSymbol(const std::string& name, std::shared_ptr<const BarSeries> bars) {
+    // Each symbol's simulator starts with no cash: its cash is its contribution to the pooled account.
+    symbols_.push_back(Symbol{ name, std::move(bars), Simulator(0.0, commission_, slippage_), 0, 0 });
+    return symbols_.size() - 1;
+}
+
+bool PortfolioBacktester::run() {
+    // Min-heap on (next bar time, symbol): equal timestamps come out in symbol order.
+    const auto later = std::greater<std::pair<std::int64_t, std::size_t>>();
+    heap_.clear();
+    heap_.reserve(symbols_.size());
+    due_.clear();
+    due_.reserve(symbols_.size());
+    std::size_t total_bars = 0;  // upper bound on distinct timestamps (the curve's length)
+    for (std::size_t i = 0; i < symbols_.size(); ++i) {
+        Symbol& s = symbols_[i];
+        s.sim.reserve(s.bars->size());
+        total_bars += s.bars->size();
+        if (!s.bars->empty()) heap_.emplace_back(s.bars->times()[0], i);
+    }
+    if (heap_.empty()) return false;
+    std::make_heap(heap_.begin(), heap_.end(), later);
+    equity_curve_.reserve(total_bars);
+    equity_times_.reserve(total_bars);
+
+    Context ctx(*this);
+    strategy_->onStart(ctx);
+
+    // Cash and equity are kept as running sums: only the symbols with a bar now change.
+    auto revalue = [this](Symbol& s, double price) {
+        const double v = symbolValue(s, price);
+        equity_ += v - s.value;
+        s.value = v;
+    };
+    auto markToClose = [&]() {
+        for (std::size_t i : due_) {
+            Symbol& s = symbols_[i];
+            const Bar bar = (*s.bars)[s.next - 1];
+            s.sim.updateEquity(bar);
+            revalue(s, bar.close);
+        }
+        equity_curve_.push_back(equity_);
+        equity_times_.push_back(now_);
+    };
+
+    double peak_equity = initial_cash_;
+    while (!heap_.empty()) {
+        now_ = heap_.front().first;
+        due_.clear();
+        while (!heap_.empty() && heap_.front().first == now_) {
+            std::pop_heap(heap_.begin(), heap_.end(), later);
+            due_.push_back(heap_.back().second);
+            heap_.pop_back();
+        }
+
+        // 1. Orders from earlier bars fill at each due symbol's open
+        for (std::size_t i : due_) {
+            Symbol& s = symbols_[i];
+            const Bar bar = (*s.bars)[s.next++];
+            const double cash_before = s.sim.cash();
+            s.sim.processOrders(bar);
+            cash_ += s.sim.cash() - cash_before;
+            revalue(s, bar.open);
+        }
+        if (equity_ <= 0) {
+            stopped_early_ = true;
+            stop_reason_ = "no more equity";
+            markToClose();  // record final equity at the closes for the report
+            break;
+        }
+
+        // 2. Strategy sees each symbol's bar (orders fill at that symbol's next bar)
+        for (std::size_t i : due_) {
+            Symbol& s = symbols_[i];
+            strategy_->onBar(i, (*s.bars)[s.next - 1], ctx);
+        }
+
+        // 3. Mark to the closes: one account equity point per timestamp
+        markToClose();
+
+        if (equity_ > peak_equity) peak_equity = equity_;
+        double drawdown_pct = (peak_equity > 0) ? ((peak_equity - equity_) / peak_equity * 100.0) : 100.0;
+        if (equity_ <= 0) {
+            stopped_early_ = true;
+            stop_reason_ = "no more equity";
+            break;
+        }
+        if (drawdown_pct >= 100.0) {
+            stopped_early_ = true;
+            stop_reason_ = "max drawdown 100%";
+            break;
+        }
+
+        for (std::size_t i : due_) {
+            const Symbol& s = symbols_[i];
+            if (s.next < s.bars->size()) {
+                heap_.emplace_back(s.bars->times()[s.next], i);
+                std::push_heap(heap_.begin(), heap_.end(), later);
+            }
+        }
+    }
+
+    strategy_->onEnd(ctx);
+    return true;
+}
+
+BacktestMetrics PortfolioBacktester::computeMetrics() const {
+    std::vector<Trade> trades;
+    double unrealized = 0;
+    for (const auto& s : symbols_) {
+        trades.insert(trades.end(), s.sim.trades().begin(), s.sim.trades().end());
+        const double pos = s.sim.position();
+        if (std::abs(pos) >= 1e-9 && s.sim.lastClose() > 0)
+            unrealized += pos * (s.sim.lastClose() - s.sim.avgEntryPrice());
+    }
+    BacktestMetrics m = computeCurveMetrics(equity_curve_, trades, initial_cash_, equity_);
+    m.unrealized_pnl = unrealized;
+    return m;
+}
+
+} // namespace backtest
@@ -0,0 +1,77 @@
+#include "pruning.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace backtest {
+
+namespace {
+
+constexpr std::size_t NO_CHECKPOINT = std::numeric_limits<std::size_t>::max();
+
+/// Bar index of checkpoint k of n over `bars` bars: evenly spaced, none on the last bar.
+std::size_t checkpointBar(std::size_t k, std::size_t n, std::size_t bars) {
+    return static_cast<std::size_t>(static_cast<std::uint64_t>(bars) * (k + 1) / (n + 1));
+}
+
+} // namespace
+
+void PruneBoard::record(const std::vector<double>& equities) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::size_t n = std::min(equities.size(), equities_.size());
+    for (std::size_t k = 0; k < n; ++k) {
+        std::vector<double>& v = equities_[k];
+        v.insert(std::upper_bound(v.begin(), v.end(), equities[k]), equities[k]);
+    }
+}
+
+bool PruneBoard::percentile(std::size_t k, double pct, std::size_t min_runs, double& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (k >= equities_.size()) return false;
+    const std::vector<double>& v = equities_[k];
+    if (v.empty() || v.size() < min_runs) return false;
+    const double clamped = std::min(100.0, std::max(0.0, pct));
+    out = v[static_cast<std::size_t>(clamped / 100.0 * static_cast<double>(v.size() - 1))];
+    return true;
+}
+
+RunPruner::RunPruner(const PruneCriteria& criteria, std::size_t bars, PruneBoard* board)
+    : criteria_(criteria)
+    , bars_(bars)
+    , board_(criteria.equity_percentile > 0 ? board : nullptr)
+    , next_checkpoint_(NO_CHECKPOINT)
+{
+    if (board_ && criteria_.checkpoints > 0 && board_->checkpoints() == criteria_.checkpoints) {
+        equities_.reserve(criteria_.checkpoints);
+        next_checkpoint_ = checkpointBar(0, criteria_.checkpoints, bars_);
+    } else {
+        board_ = nullptr;
+    }
+}
+
+bool RunPruner::checkpoint(double equity, std::string& reason) {
+    const std::size_t k = equities_.size();
+    const std::size_t bar = next_checkpoint_;
+    equities_.push_back(equity);
+    // Next checkpoint after this bar (small series can map several checkpoints to one bar: skip those)
+    next_checkpoint_ = NO_CHECKPOINT;
+    for (std::size_t j = k + 1; j < criteria_.checkpoints; ++j) {
+        const std::size_t b = checkpointBar(j, criteria_.checkpoints, bars_);
+        if (b > bar) {
+            next_checkpoint_ = b;
+            break;
+        }
+        equities_.push_back(equity);
+    }
+
+    double threshold = 0;
+    if (board_->percentile(k, criteria_.equity_percentile, criteria_.min_completed, threshold) && equity < threshold)
+        return prune(reason, "pruned: below equity percentile");
+    return false;
+}
+
+void RunPruner::finish() {
+    if (board_ && !pruned_ && !equities_.empty()) board_->record(equities_);
+}
+
+} // namespace backtest
@@ -1,16 +1,20 @@
 #include "report.hpp"
+#include "bar_aggregator.hpp"
+#include "buffered_writer.hpp"
+#include "timestamp.hpp"
 #include <fstream>
 #include <iomanip>
 #include <cmath>
 #include <numeric>
 #include <algorithm>
 #include <iostream>
+#include <cstring>
 
 namespace backtest {
 
-Report::Report(const Simulator& sim, const DataSource& data, double initial_cash,
+Report::Report(const Simulator& sim, const BarSeries& bars, double initial_cash,
                const std::string& strategy_name, const std::string& strategy_params)
-    : sim_(sim), data_(data), initial_cash_(initial_cash)
+    : sim_(sim), bars_(bars), initial_cash_(initial_cash)
     , strategy_name_(strategy_name), strategy_params_(strategy_params) {}
 
 void Report::printReportHeader(std::ostream& out) const {
@@ -21,15 +25,33 @@ void Report::printReportHeader(std::ostream& out) const {
     }
 }
 
-BacktestMetrics Report::computeMetrics() {
+void Report::printMonteCarlo(std::ostream& out) const {
+    const MonteCarloSummary& mc = monte_carlo_;
+    if (mc.paths == 0) return;
+    out << "Monte Carlo (" << monteCarloMethodName(mc.method) << (mc.compound ? ", compounded" : "") << ", "
+        << mc.paths << " paths of " << mc.trades << " trades):\n";
+    out << std::fixed << std::setprecision(2);
+    out << "  Percentile   ";
+    for (double p : MONTE_CARLO_PERCENTILES) out << ' ' << std::setw(8) << std::setprecision(0) << p << "%";
+    out << std::setprecision(2);
+    out << "\n  Return %     ";
+    for (double v : mc.return_pct) out << ' ' << std::setw(9) << v;
+    out << "\n  Max DD %     ";
+    for (double v : mc.max_drawdown_pct) out << ' ' << std::setw(9) << std::min(v, 100.0);
+    out << "\n  Mean return:  " << mc.mean_return_pct << "%\n";
+    out << "  P(loss):      " << mc.loss_probability_pct << "%\n";
+    out << "  P(ruin):      " << mc.ruin_probability_pct << "%\n";
+}
+
+BacktestMetrics computeCurveMetrics(const std::vector<double>& curve, const std::vector<Trade>& trades,
+                                    double initial_cash, double final_equity) {
     BacktestMetrics m;
-    m.initial_equity = initial_cash_;
-    m.final_equity = sim_.equity();
-    m.total_return_pct = (initial_cash_ != 0)
-        ? ((m.final_equity - initial_cash_) / initial_cash_) * 100.0
+    m.initial_equity = initial_cash;
+    m.final_equity = final_equity;
+    m.total_return_pct = (initial_cash != 0)
+        ? ((m.final_equity - initial_cash) / initial_cash) * 100.0
         : 0;
 
-    const auto& curve = sim_.equityCurve();
     if (curve.empty()) return m;
 
     double peak = curve[0];
@@ -42,7 +64,6 @@ BacktestMetrics Report::computeMetrics() {
     m.max_drawdown_pct = max_dd;
 
     // Sharpe: mean and std of period returns, annualized (trading days per year)
-    constexpr double TRADING_DAYS_PER_YEAR = 252.0;
     if (curve.size() >= 2) {
         std::vector<double> returns;
         returns.reserve(curve.size() - 1);
@@ -57,9 +78,16 @@ BacktestMetrics Report::computeMetrics() {
         for (double r : returns) sq_sum += (r - mean) * (r - mean);
         double stddev = (returns.size() > 1) ? std::sqrt(sq_sum / (returns.size() - 1)) : 0;
         m.sharpe_ratio = (stddev != 0) ? (mean / stddev) * std::sqrt(TRADING_DAYS_PER_YEAR) : 0;
+        // Sortino: same mean over the downside deviation (root mean square of the negative returns)
+        double down_sq = 0;
+        for (double r : returns) {
+            if (r < 0) down_sq += r * r;
+        }
+        double down_dev = std::sqrt(down_sq / static_cast<double>(returns.size()));
+        m.sortino_ratio = (down_dev != 0) ? (mean / down_dev) * std::sqrt(TRADING_DAYS_PER_YEAR) : 0;
     }
+    m.calmar_ratio = (max_dd != 0) ? m.total_return_pct / max_dd : 0;
 
-    const auto& trades = sim_.trades();
     m.num_trades = static_cast<int>(trades.size());
     int wins = 0;
     double total_pnl = 0;
@@ -70,16 +98,15 @@ BacktestMetrics Report::computeMetrics() {
     m.winning_trades = wins;
     m.win_rate_pct = (m.num_trades > 0) ? (100.0 * wins / m.num_trades) : 0;
     m.avg_trade_pnl = (m.num_trades > 0) ? (total_pnl / m.num_trades) : 0;
+    return m;
+}
 
-    // Open position at end (only closed trades counted in num_trades)
-    double pos = sim_.position();
-    double avg_entry = sim_.avgEntryPrice();
-    double last_close = sim_.lastClose();
-    m.open_position = pos;
-    if (std::abs(pos) >= 1e-9 && last_close > 0)
-        m.unrealized_pnl = pos * (last_close - avg_entry);
+BacktestMetrics Report::computeMetrics() {
+    BacktestMetrics m = computeCurveMetrics(sim_.equityCurve(), sim_.trades(), initial_cash_, sim_.equity());
+    if (sim_.equityCurve().empty()) return m;
 
-    return m;
+    // Open position at end (only closed trades counted in num_trades)
+    return withOpenPosition(m, sim_);
 }
 
 void Report::printSummary(std::ostream& out) const {
@@ -88,7 +115,7 @@ void Report::printSummary(std::ostream& out) const {
         out << "*** Backtest stopped: " << stopped_reason_ << " ***\n\n";
     printReportHeader(out);
     out << std::fixed << std::setprecision(2);
-    out << "Bars loaded:   " << data_.size() << "\n";
+    out << "Bars loaded:   " << bars_.size() << "\n";
     out << "Initial equity:  " << metrics_.initial_equity << "\n";
     out << "Final equity:   " << metrics_.final_equity << "\n";
     out << "Total return:   " << metrics_.total_return_pct << "%\n";
@@ -104,50 +131,36 @@ void Report::printSummary(std::ostream& out) const {
             << (metrics_.open_position > 0 ? " (long)" : " (short)") << "\n";
         out << "Unrealized P&L:  " << metrics_.unrealized_pnl << "\n";
     }
+    printMonteCarlo(out);
     out << "======================================\n\n";
 }
 
-namespace {
-    void writeCsvQuoted(std::ostream& out, const std::string& s) {
-        out << '"';
-        for (char c : s) {
-            if (c == '"') out << "\"\"";
-            else out << c;
-        }
-        out << '"';
-    }
-
-    void writeJsonString(std::ostream& out, const std::string& s) {
-        out << '"';
-        for (char c : s) {
-            if (c == '"') out << "\\\"";
-            else if (c == '\\') out << "\\\\";
-            else if (c == '\n') out << "\\n";
-            else if (c == '\r') out << "\\r";
-            else out << c;
-        }
-        out << '"';
-    }
-}
-
 bool Report::writeTradeLog(const std::string& filepath) const {
-    std::ofstream f(filepath);
-    if (!f) {
+    BufferedWriter f;
+    if (!f.open(filepath)) {
         std::cerr << "Failed to open for writing: " << filepath << "\n";
         return false;
     }
-    f << static_cast<char>(0xEF) << static_cast<char>(0xBB) << static_cast<char>(0xBF);
-    f << "entry_time,exit_time,side,quantity,entry_price,exit_price,pnl,pnl_pct\n";
-    f << std::fixed << std::setprecision(2);
+    f.write("\xEF\xBB\xBF");
+    f.write("entry_time,exit_time,side,quantity,entry_price,exit_price,pnl,pnl_pct\n");
     for (const auto& t : sim_.trades()) {
-        writeCsvQuoted(f, t.entry_time);
-        f << ',';
-        writeCsvQuoted(f, t.exit_time);
-        f << ',' << (t.side == Side::Long ? "long" : "short") << ','
-          << t.quantity << ',' << t.entry_price << ',' << t.exit_price << ','
-          << t.pnl << ',' << t.pnl_pct << "\n";
+        f.put('"');
+        f.timestamp(t.entry_time);
+        f.write("\",\"");
+        f.timestamp(t.exit_time);
+        f.write(t.side == Side::Long ? "\",long," : "\",short,");
+        f.fixed(t.quantity, 2);
+        f.put(',');
+        f.fixed(t.entry_price, 2);
+        f.put(',');
+        f.fixed(t.exit_price, 2);
+        f.put(',');
+        f.fixed(t.pnl, 2);
+        f.put(',');
+        f.fixed(t.pnl_pct, 2);
+        f.put('\n');
     }
-    if (!f) {
+    if (!f.close()) {
         std::cerr << "Failed to write trade log: " << filepath << "\n";
         return false;
     }
@@ -155,24 +168,31 @@ bool Report::writeTradeLog(const std::string& filepath) const {
 }
 
 bool Report::writeEquityCurve(const std::string& filepath) const {
-    std::ofstream f(filepath);
-    if (!f) {
+    BufferedWriter f;
+    if (!f.open(filepath)) {
         std::cerr << "Failed to open for writing: " << filepath << "\n";
         return false;
     }
-    f << static_cast<char>(0xEF) << static_cast<char>(0xBB) << static_cast<char>(0xBF);
-    f << "bar_index,timestamp,equity\n";
-    f << std::fixed << std::setprecision(2);
+    f.write("\xEF\xBB\xBF");
+    f.write("bar_index,timestamp,equity\n");
     const auto& curve = sim_.equityCurve();
-    const std::size_t n = std::min(curve.size(), data_.size());
+    const std::size_t n = std::min(curve.size(), bars_.size());
+    const auto times = bars_.times();
     for (std::size_t i = 0; i < n; ++i) {
-        f << i << ',';
-        writeCsvQuoted(f, data_.at(i).timestamp);
-        f << ',' << curve[i] << "\n";
+        f.integer(static_cast<std::uint64_t>(i));
+        f.write(",\"");
+        f.timestamp(times[i]);
+        f.write("\",");
+        f.fixed(curve[i], 2);
+        f.put('\n');
     }
-    for (std::size_t i = n; i < curve.size(); ++i)
-        f << i << ",\"\"," << curve[i] << "\n";
-    if (!f) {
+    for (std::size_t i = n; i < curve.size(); ++i) {
+        f.integer(static_cast<std::uint64_t>(i));
+        f.write(",\"\",");
+        f.fixed(curve[i], 2);
+        f.put('\n');
+    }
+    if (!f.close()) {
         std::cerr << "Failed to write equity curve: " << filepath << "\n";
         return false;
     }
@@ -211,54 +231,336 @@ bool Report::writeReport(const std::string& filepath) const {
           << (metrics_.open_position > 0 ? " (long)" : " (short)") << "\n";
         f << "Unrealized P&L:  " << metrics_.unrealized_pnl << "\n";
     }
+    if (monte_carlo_.paths > 0) f << "\n";
+    printMonteCarlo(f);
     return f ? true : (std::cerr << "Failed to write report: " << filepath << "\n", false);
 }
 
 bool Report::writeSessionJson(const std::string& filepath, const std::string& symbol_or_label) const {
-    std::ofstream f(filepath);
-    if (!f) {
+    BufferedWriter f;
+    if (!f.open(filepath)) {
         std::cerr << "Failed to open for writing: " << filepath << "\n";
         return false;
     }
-    f << std::fixed << std::setprecision(4);
-    f << "{\n  \"symbol\": ";
-    writeJsonString(f, symbol_or_label.empty() ? "backtest" : symbol_or_label);
-    f << ",\n  \"strategy\": ";
-    writeJsonString(f, strategy_name_);
-    f << ",\n  \"params\": ";
-    writeJsonString(f, strategy_params_);
-    f << ",\n  \"bars\": [\n";
-    const auto& bars = data_.bars();
-    for (std::size_t i = 0; i < bars.size(); ++i) {
-        const auto& b = bars[i];
-        f << "    {\"t\":";
-        writeJsonString(f, b.timestamp);
-        f << ",\"o\":" << b.open << ",\"h\":" << b.high << ",\"l\":" << b.low << ",\"c\":" << b.close;
-        if (b.volume != 0) f << ",\"v\":" << b.volume;
-        f << "}";
-        if (i + 1 < bars.size()) f << ",";
-        f << "\n";
+    f.write("{\n  \"symbol\": ");
+    f.jsonString(symbol_or_label.empty() ? "backtest" : symbol_or_label);
+    f.write(",\n  \"strategy\": ");
+    f.jsonString(strategy_name_);
+    f.write(",\n  \"params\": ");
+    f.jsonString(strategy_params_);
+    f.write(",\n  \"bars\": [\n");
+    const std::size_t nbars = bars_.size();
+    const auto times = bars_.times();
+    const auto open = bars_.opens();
+    const auto high = bars_.highs();
+    const auto low = bars_.lows();
+    const auto close = bars_.closes();
+    const auto volume = bars_.volumes();
+    for (std::size_t i = 0; i < nbars; ++i) {
+        f.write("    {\"t\":\"");
+        f.timestamp(times[i]);
+        f.write("\",\"o\":");
+        f.fixed(open[i], 4);
+        f.write(",\"h\":");
+        f.fixed(high[i], 4);
+        f.write(",\"l\":");
+        f.fixed(low[i], 4);
+        f.write(",\"c\":");
+        f.fixed(close[i], 4);
+        if (volume[i] != 0) {
+            f.write(",\"v\":");
+            f.fixed(volume[i], 4);
+        }
+        f.write(i + 1 < nbars ? "},\n" : "}\n");
     }
-    f << "  ],\n  \"trades\": [\n";
+    f.write("  ],\n  \"trades\": [\n");
     const auto& trades = sim_.trades();
     for (std::size_t i = 0; i < trades.size(); ++i) {
         const auto& t = trades[i];
-        f << "    {\"entry_time\":";
-        writeJsonString(f, t.entry_time);
-        f << ",\"exit_time\":";
-        writeJsonString(f, t.exit_time);
-        f << ",\"side\":\"" << (t.side == Side::Long ? "long" : "short") << "\""
-          << ",\"entry_price\":" << t.entry_price << ",\"exit_price\":" << t.exit_price
-          << ",\"quantity\":" << t.quantity << ",\"pnl\":" << t.pnl << "}";
-        if (i + 1 < trades.size()) f << ",";
-        f << "\n";
+        f.write("    {\"entry_time\":\"");
+        f.timestamp(t.entry_time);
+        f.write("\",\"exit_time\":\"");
+        f.timestamp(t.exit_time);
+        f.write(t.side == Side::Long ? "\",\"side\":\"long\"" : "\",\"side\":\"short\"");
+        f.write(",\"entry_price\":");
+        f.fixed(t.entry_price, 4);
+        f.write(",\"exit_price\":");
+        f.fixed(t.exit_price, 4);
+        f.write(",\"quantity\":");
+        f.fixed(t.quantity, 4);
+        f.write(",\"pnl\":");
+        f.fixed(t.pnl, 4);
+        f.write(i + 1 < trades.size() ? "},\n" : "}\n");
     }
-    f << "  ]\n}\n";
-    if (!f) {
+    f.write("  ]\n}\n");
+    if (!f.close()) {
         std::cerr << "Failed to write session JSON: " << filepath << "\n";
         return false;
     }
     return true;
 }
 
+namespace {
+
+// session.lod layout (all offsets are bytes from the start of the file, which is written in binary mode):
+//   "BACKTEST-SESSION-LOD 1\n"
+//   chunks, one per line: JSON arrays of bars [t,o,h,l,c] or trades
+//     [entry_t,exit_t,side(1 long, -1 short),entry_price,exit_price,quantity,pnl], times in Unix seconds
+//   the index, one line of JSON: metadata, per level its period and chunks, the trade chunks
+//   a 32-byte trailer "LOD-INDEX <index offset>", space padded, ending in '\n'
+// A chunk entry is [first time, last time, offset, length] (trade chunks add the first trade's number).
+constexpr std::size_t LOD_TOP_BARS = 4096;
+constexpr std::size_t LOD_CHUNK_BARS = 4096;
+constexpr std::size_t LOD_CHUNK_TRADES = 1024;
+constexpr std::size_t LOD_TRAILER_BYTES = 32;
+
+struct LodChunk {
+    std::int64_t first_s;
+    std::int64_t last_s;
+    std::uint64_t offset;
+    std::uint64_t length;
+    std::size_t first_index;
+};
+
+std::int64_t unixSeconds(std::int64_t ns) { return ns / NS_PER_SECOND; }
+
+std::vector<LodChunk> writeBarChunks(BufferedWriter& f, const BarSeries& bars) {
+    std::vector<LodChunk> chunks;
+    const auto times = bars.times();
+    const auto open = bars.opens();
+    const auto high = bars.highs();
+    const auto low = bars.lows();
+    const auto close = bars.closes();
+    for (std::size_t begin = 0; begin < bars.size(); begin += LOD_CHUNK_BARS) {
+        const std::size_t end = std::min(bars.size(), begin + LOD_CHUNK_BARS);
+        LodChunk c{ unixSeconds(times[begin]), unixSeconds(times[end - 1]), f.bytesWritten(), 0, begin };
+        f.put('[');
+        for (std::size_t i = begin; i < end; ++i) {
+            f.put('[');
+            f.integer(unixSeconds(times[i]));
+            f.put(',');
+            f.fixed(open[i], 4);
+            f.put(',');
+            f.fixed(high[i], 4);
+            f.put(',');
+            f.fixed(low[i], 4);
+            f.put(',');
+            f.fixed(close[i], 4);
+            f.write(i + 1 < end ? "]," : "]");
+        }
+        f.put(']');
+        c.length = f.bytesWritten() - c.offset;
+        f.put('\n');
+        chunks.push_back(c);
+    }
+    return chunks;
+}
+
+std::vector<LodChunk> writeTradeChunks(BufferedWriter& f, const std::vector<Trade>& trades) {
+    std::vector<LodChunk> chunks;
+    for (std::size_t begin = 0; begin < trades.size(); begin += LOD_CHUNK_TRADES) {
+        const std::size_t end = std::min(trades.size(), begin + LOD_CHUNK_TRADES);
+        LodChunk c{ unixSeconds(trades[begin].entry_time), unixSeconds(trades[begin].exit_time), f.bytesWritten(), 0,
+                    begin };
+        f.put('[');
+        for (std::size_t i = begin; i < end; ++i) {
+            const auto& t = trades[i];
+            c.first_s = std::min(c.first_s, unixSeconds(t.entry_time));
+            c.last_s = std::max(c.last_s, unixSeconds(t.exit_time));
+            f.put('[');
+            f.integer(unixSeconds(t.entry_time));
+            f.put(',');
+            f.integer(unixSeconds(t.exit_time));
+            f.write(t.side == Side::Long ? ",1," : ",-1,");
+            f.fixed(t.entry_price, 4);
+            f.put(',');
+            f.fixed(t.exit_price, 4);
+            f.put(',');
+            f.fixed(t.quantity, 4);
+            f.put(',');
+            f.fixed(t.pnl, 4);
+            f.write(i + 1 < end ? "]," : "]");
+        }
+        f.put(']');
+        c.length = f.bytesWritten() - c.offset;
+        f.put('\n');
+        chunks.push_back(c);
+    }
+    return chunks;
+}
+
+void writeChunkIndex(BufferedWriter& f, const std::vector<LodChunk>& chunks, bool with_first_index) {
+    f.put('[');
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        const auto& c = chunks[i];
+        f.put('[');
+        f.integer(c.first_s);
+        f.put(',');
+        f.integer(c.last_s);
+        f.put(',');
+        f.integer(c.offset);
+        f.put(',');
+        f.integer(c.length);
+        if (with_first_index) {
+            f.put(',');
+            f.integer(static_cast<std::uint64_t>(c.first_index));
+        }
+        f.write(i + 1 < chunks.size() ? "]," : "]");
+    }
+    f.put(']');
+}
+
+} // namespace
+
+bool Report::writeSessionLod(const std::string& filepath, const std::string& symbol_or_label) const {
+    BufferedWriter f;
+    if (!f.open(filepath, true)) {
+        std::cerr << "Failed to open for writing: " << filepath << "\n";
+        return false;
+    }
+    const LodPyramid pyramid = buildLodPyramid(bars_, LOD_TOP_BARS);
+
+    f.write("BACKTEST-SESSION-LOD 1\n");
+    std::vector<std::vector<LodChunk>> level_chunks;
+    level_chunks.push_back(writeBarChunks(f, bars_));
+    for (const auto& level : pyramid.levels) level_chunks.push_back(writeBarChunks(f, level.bars));
+    const std::vector<LodChunk> trade_chunks = writeTradeChunks(f, sim_.trades());
+
+    const std::uint64_t index_offset = f.bytesWritten();
+    f.write("{\"symbol\":");
+    f.jsonString(symbol_or_label.empty() ? "backtest" : symbol_or_label);
+    f.write(",\"strategy\":");
+    f.jsonString(strategy_name_);
+    f.write(",\"params\":");
+    f.jsonString(strategy_params_);
+    f.write(",\"bars\":");
+    f.integer(static_cast<std::uint64_t>(bars_.size()));
+    f.write(",\"trades\":");
+    f.integer(static_cast<std::uint64_t>(sim_.trades().size()));
+    f.write(",\"levels\":[");
+    for (std::size_t k = 0; k < level_chunks.size(); ++k) {
+        const std::int64_t period_ns = k == 0 ? pyramid.base_period_ns : pyramid.levels[k - 1].period_ns;
+        const std::size_t nbars = k == 0 ? bars_.size() : pyramid.levels[k - 1].bars.size();
+        f.write("{\"seconds\":");
+        f.integer(std::max<std::int64_t>(1, unixSeconds(period_ns)));
+        f.write(",\"bars\":");
+        f.integer(static_cast<std::uint64_t>(nbars));
+        f.write(",\"chunks\":");
+        writeChunkIndex(f, level_chunks[k], false);
+        f.write(k + 1 < level_chunks.size() ? "}," : "}");
+    }
+    f.write("],\"trade_chunks\":");
+    writeChunkIndex(f, trade_chunks, true);
+    f.write("}\n");
+
+    char trailer[LOD_TRAILER_BYTES];
+    std::fill(trailer, trailer + LOD_TRAILER_BYTES, ' ');
+    std::memcpy(trailer, "LOD-INDEX ", 10);
+    std::to_chars(trailer + 10, trailer + LOD_TRAILER_BYTES - 1, index_offset);
+    trailer[LOD_TRAILER_BYTES - 1] = '\n';
+    f.write(std::string_view(trailer, LOD_TRAILER_BYTES));
+
+    if (!f.close()) {
+        std::cerr << "Failed to write session LOD: " << filepath << "\n";
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+constexpr char SESSION_MAGIC[8] = { 'B', 'T', 'S', 'E', 'S', 'S', '\0', '\0' };
+constexpr std::uint32_t SESSION_VERSION = 1;
+constexpr std::uint32_t SESSION_ENDIAN_MARKER = 0x01020304u;
+constexpr std::size_t SESSION_HEADER_SIZE = 64;
+constexpr std::size_t SESSION_COLUMN_ALIGN = 64;
+
+struct SessionHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endian;
+    std::uint64_t bar_count;
+    std::uint64_t trade_count;
+    std::uint64_t equity_count;
+    std::uint32_t symbol_bytes;
+    std::uint32_t strategy_bytes;
+    std::uint32_t params_bytes;
+    std::uint32_t reserved;
+    std::uint64_t columns_offset;
+};
+static_assert(sizeof(SessionHeader) == SESSION_HEADER_SIZE, "session header must stay 64 bytes");
+
+std::uint64_t alignColumn(std::uint64_t n) {
+    return (n + SESSION_COLUMN_ALIGN - 1) / SESSION_COLUMN_ALIGN * SESSION_COLUMN_ALIGN;
+}
+
+/// n values of T from p, then zeros up to the next column boundary.
+template <typename T>
+void writeColumn(BufferedWriter& f, const T* p, std::size_t n) {
+    f.write(std::string_view(reinterpret_cast<const char*>(p), n * sizeof(T)));
+    for (std::uint64_t i = n * sizeof(T); i < alignColumn(n * sizeof(T)); ++i) f.put('\0');
+}
+
+/// The column of field over trades (AoS in the simulator), written a value at a time.
+template <typename T, typename Field>
+void writeTradeColumn(BufferedWriter& f, const std::vector<Trade>& trades, Field field) {
+    for (const auto& t : trades) {
+        const T v = field(t);
+        f.write(std::string_view(reinterpret_cast<const char*>(&v), sizeof(v)));
+    }
+    for (std::uint64_t i = trades.size() * sizeof(T); i < alignColumn(trades.size() * sizeof(T)); ++i) f.put('\0');
+}
+
+} // namespace
+
+bool Report::writeSessionBinary(const std::string& filepath, const std::string& symbol_or_label) const {
+    BufferedWriter f;
+    if (!f.open(filepath, true)) {
+        std::cerr << "Failed to open for writing: " << filepath << "\n";
+        return false;
+    }
+    const std::string symbol = symbol_or_label.empty() ? "backtest" : symbol_or_label;
+    const auto& trades = sim_.trades();
+    const auto& curve = sim_.equityCurve();
+    const std::size_t n = bars_.size();
+
+    SessionHeader h{};
+    std::memcpy(h.magic, SESSION_MAGIC, sizeof(SESSION_MAGIC));
+    h.version = SESSION_VERSION;
+    h.endian = SESSION_ENDIAN_MARKER;
+    h.bar_count = n;
+    h.trade_count = trades.size();
+    h.equity_count = curve.size();
+    h.symbol_bytes = static_cast<std::uint32_t>(symbol.size());
+    h.strategy_bytes = static_cast<std::uint32_t>(strategy_name_.size());
+    h.params_bytes = static_cast<std::uint32_t>(strategy_params_.size());
+    h.columns_offset = alignColumn(SESSION_HEADER_SIZE + symbol.size() + strategy_name_.size() + strategy_params_.size());
+
+    f.write(std::string_view(reinterpret_cast<const char*>(&h), sizeof(h)));
+    f.write(symbol);
+    f.write(strategy_name_);
+    f.write(strategy_params_);
+    while (f.bytesWritten() < h.columns_offset) f.put('\0');
+
+    writeColumn(f, bars_.times().data(), n);
+    for (Column<double> col : { bars_.opens(), bars_.highs(), bars_.lows(), bars_.closes(), bars_.volumes() })
+        writeColumn(f, col.data(), n);
+
+    writeTradeColumn<std::int64_t>(f, trades, [](const Trade& t) { return t.entry_time; });
+    writeTradeColumn<std::int64_t>(f, trades, [](const Trade& t) { return t.exit_time; });
+    writeTradeColumn<std::int64_t>(f, trades, [](const Trade& t) { return t.side == Side::Long ? 1 : -1; });
+    writeTradeColumn<double>(f, trades, [](const Trade& t) { return t.entry_price; });
+    writeTradeColumn<double>(f, trades, [](const Trade& t) { return t.exit_price; });
+    writeTradeColumn<double>(f, trades, [](const Trade& t) { return t.quantity; });
+    writeTradeColumn<double>(f, trades, [](const Trade& t) { return t.pnl; });
+
+    writeColumn(f, curve.data(), curve.size());
+
+    if (!f.close()) {
+        std::cerr << "Failed to write session binary: " << filepath << "\n";
+        return false;
+    }
+    return true;
+}
+
 } // namespace backtest
@@ -29,8 +29,31 @@ void Simulator::placeOrder(Side side, double quantity) {
 }
 
 void Simulator::processOrders(const Bar& bar) {
-    if (!has_pending_) return;
+    fillPending(bar);
+    if (!book_.empty()) {
+        book_.match(bar, slippage_, [this, &bar](const Order& order, double fill_price) {
+            return fillResting(order, fill_price, bar.timestamp);
+        });
+    }
+    last_bar_time_ = bar.timestamp;
+}
 
+void Simulator::processOrders(const Bar& bar, const BarSeriesView& intrabar) {
+    if (intrabar.empty()) {
+        processOrders(bar);
+        return;
+    }
+    fillPending(bar);
+    const OrderBook::FillFn fill = [this, &bar](const Order& order, double fill_price) {
+        return fillResting(order, fill_price, bar.timestamp);
+    };
+    for (std::size_t i = 0; i < intrabar.size() && !book_.empty(); ++i)
+        book_.match(intrabar[i], slippage_, fill);
+    last_bar_time_ = bar.timestamp;
+}
+
+void Simulator::fillPending(const Bar& bar) {
+    if (!has_pending_) return;
     double fill_price = bar.open;  // fill at bar open (no look-ahead)
     if (slippage_ > 0) {
         if (pending_order_.side == Side::Long)
@@ -38,9 +61,22 @@ void Simulator::processOrders(const Bar& bar) {
         else
             fill_price *= (1.0 - slippage_);
     }
-    double qty = pending_order_.quantity;
-    Side side = pending_order_.side;
+    has_pending_ = false;
+    execute(pending_order_.side, pending_order_.quantity, fill_price, bar.timestamp);
+}
+
+bool Simulator::fillResting(const Order& order, double fill_price, std::int64_t time) {
+    double qty = order.quantity;
+    if (order.reduce_only) {
+        const bool reduces = (order.side == Side::Long && position_ < 0) || (order.side == Side::Short && position_ > 0);
+        if (!reduces) return false;
+        qty = std::min(qty, std::abs(position_));
+    }
+    execute(order.side, qty, fill_price, time);
+    return true;
+}
 
+void Simulator::execute(Side side, double qty, double fill_price, std::int64_t time) {
     // Close or reduce opposite position first
     if ((side == Side::Long && position_ < 0) || (side == Side::Short && position_ > 0)) {
         double close_qty = std::min(qty, std::abs(position_));
@@ -52,7 +88,7 @@ void Simulator::processOrders(const Bar& bar) {
 
         Trade t;
         t.entry_time = last_bar_time_;
-        t.exit_time = bar.timestamp;
+        t.exit_time = time;
         t.side = position_ > 0 ? Side::Long : Side::Short;
         t.quantity = close_qty;
         t.entry_price = avg_entry_;
@@ -69,11 +105,7 @@ void Simulator::processOrders(const Bar& bar) {
             if (std::abs(position_) < POSITION_ZERO_EPS) position_ = 0;
         }
         qty -= close_qty;
-        if (qty <= 0) {
-            has_pending_ = false;
-            last_bar_time_ = bar.timestamp;
-            return;
-        }
+        if (qty <= 0) return;
         if (std::abs(position_) < POSITION_ZERO_EPS) avg_entry_ = 0;
     }
 
@@ -92,15 +124,12 @@ void Simulator::processOrders(const Bar& bar) {
             position_ += (side == Side::Long) ? qty : -qty;
         }
     }
-
-    has_pending_ = false;
-    last_bar_time_ = bar.timestamp;
 }
 
 void Simulator::updateEquity(const Bar& bar) {
     last_close_ = bar.close;
     equity_ = cash_ + position_ * bar.close;
-    equity_curve_.push_back(equity_);
+    if (record_curve_) equity_curve_.push_back(equity_);
     last_bar_time_ = bar.timestamp;
 }
 
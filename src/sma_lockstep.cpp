@@ -0,0 +1,543 @@
+#include "sma_lockstep.hpp"
+#include "indicators.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace backtest {
+
+namespace {
+
+constexpr double POSITION_ZERO_EPS = 1e-9;  // as in Simulator
+
+enum StopCode : std::uint8_t { RUNNING = 0, NO_EQUITY = 1, MAX_DRAWDOWN = 2 };
+
+/// Hot per-lane state, one array per field, indexed by active slot (see Lockstep::retire).
+struct LaneArrays {
+    AlignedVector<double> cash, pos, equity;
+    AlignedVector<double> curve_last;            // last equity-curve point (Report's returns)
+    AlignedVector<double> peak, trough, max_dd;  // Report's drawdown (peak starts at curve[0]), see epochDrawdown
+    AlignedVector<double> bt_peak;               // Backtester's stop check (peak starts at initial cash)
+    AlignedVector<double> ret_mean, ret_m2;      // Welford over the curve's bar-to-bar returns
+    AlignedVector<double> pending;               // pending order quantity; 0 = none
+    AlignedVector<double> slow_period;           // bars needed before the strategy trades
+    AlignedVector<std::int64_t> fast_sma, slow_sma;  // indices into the shared SMA values
+    AlignedVector<std::uint8_t> stop;
+
+    void resize(std::size_t n, double initial_cash) {
+        cash.assign(n, initial_cash);
+        pos.assign(n, 0.0);
+        equity.assign(n, initial_cash);
+        curve_last.assign(n, 0.0);
+        peak.assign(n, 0.0);
+        trough.assign(n, 0.0);
+        max_dd.assign(n, 0.0);
+        bt_peak.assign(n, initial_cash);
+        ret_mean.assign(n, 0.0);
+        ret_m2.assign(n, 0.0);
+        pending.assign(n, 0.0);
+        slow_period.assign(n, 0.0);
+        fast_sma.assign(n, 0);
+        slow_sma.assign(n, 0);
+        stop.assign(n, RUNNING);
+    }
+
+    void swapSlots(std::size_t a, std::size_t b) {
+        std::swap(cash[a], cash[b]);
+        std::swap(pos[a], pos[b]);
+        std::swap(equity[a], equity[b]);
+        std::swap(curve_last[a], curve_last[b]);
+        std::swap(peak[a], peak[b]);
+        std::swap(trough[a], trough[b]);
+        std::swap(max_dd[a], max_dd[b]);
+        std::swap(bt_peak[a], bt_peak[b]);
+        std::swap(ret_mean[a], ret_mean[b]);
+        std::swap(ret_m2[a], ret_m2[b]);
+        std::swap(pending[a], pending[b]);
+        std::swap(slow_period[a], slow_period[b]);
+        std::swap(fast_sma[a], fast_sma[b]);
+        std::swap(slow_sma[a], slow_sma[b]);
+        std::swap(stop[a], stop[b]);
+    }
+};
+
+/// Cold per-lane state: only touched on signals and fills.
+struct LaneInfo {
+    std::size_t id{0};          // index into the caller's lanes / results
+    double size{1.0};
+    double avg_entry{0};
+    bool pending_long{false};
+    int num_trades{0};
+    int winning_trades{0};
+    double total_pnl{0};
+};
+
+/// Report's drawdown for one peak epoch: (peak - trough) / peak * 100, 0 when peak == 0. Within an epoch
+/// the peak is fixed and rounding is monotone, so the deepest point gives the same maximum Report finds
+/// bar by bar; the division runs once per new peak instead of once per bar.
+inline double epochDrawdown(double peak, double trough) {
+    return (peak != 0) ? (peak - trough) / peak * 100.0 : 0.0;
+}
+
+/// Backtester stops once (peak - eq) / peak * 100 >= 100 (peak from initial cash). Only a tiny equity
+/// relative to the peak can get there, so the exact check runs just for those lanes.
+constexpr double STOP_CHECK_RATIO = 1e-6;
+
+inline std::uint8_t stopCode(double eq, double bt_peak) {
+    if (eq <= 0) return NO_EQUITY;
+    if (bt_peak > 0 && eq > bt_peak * STOP_CHECK_RATIO) return RUNNING;
+    const double bt_dd = (bt_peak > 0) ? (bt_peak - eq) / bt_peak * 100.0 : 100.0;
+    return bt_dd >= 100.0 ? MAX_DRAWDOWN : RUNNING;
+}
+
+/// Updates curve point `point` (0-based) for active slots [begin, n): equity = cash + position * close,
+/// Report's drawdown and return statistics, and the Backtester stop check. One lane at a time.
+void updateEquityScalar(LaneArrays& a, std::size_t begin, std::size_t n, double close, std::size_t point) {
+    const double inv_count = point > 0 ? 1.0 / static_cast<double>(point) : 0.0;
+    for (std::size_t j = begin; j < n; ++j) {
+        const double eq = a.cash[j] + a.pos[j] * close;
+        a.equity[j] = eq;
+        if (point == 0) {
+            a.peak[j] = a.trough[j] = eq;
+        } else {
+            const double prev = a.curve_last[j];
+            const double r = (prev != 0) ? (eq - prev) / prev : 0.0;
+            const double delta = r - a.ret_mean[j];
+            a.ret_mean[j] += delta * inv_count;
+            a.ret_m2[j] += delta * (r - a.ret_mean[j]);
+            if (eq > a.peak[j]) {
+                const double dd = epochDrawdown(a.peak[j], a.trough[j]);
+                if (dd > a.max_dd[j]) a.max_dd[j] = dd;
+                a.peak[j] = a.trough[j] = eq;
+            } else if (eq < a.trough[j]) {
+                a.trough[j] = eq;
+            }
+        }
+        a.curve_last[j] = eq;
+
+        if (eq > a.bt_peak[j]) a.bt_peak[j] = eq;
+        if (a.stop[j] == RUNNING) a.stop[j] = stopCode(eq, a.bt_peak[j]);
+    }
+}
+
+/// Appends to todo the active slots in [begin, n) that have something to do this bar: a pending
+/// order to fill, equity at the open <= 0 (Backtester stop), or an SMA signal the strategy would act
+/// on. Every other lane is left alone, exactly as Simulator / SmaCrossoverStrategy would leave it.
+/// seen = bars fed so far including this one.
+std::size_t scanLanesScalar(const LaneArrays& a, std::size_t begin, std::size_t n, double open, double close,
+                            double seen, const double* sma, std::uint32_t* todo, std::size_t count) {
+    for (std::size_t j = begin; j < n; ++j) {
+        bool act = a.pending[j] > 0 || a.cash[j] + a.pos[j] * open <= 0;
+        if (!act && close > 0 && a.slow_period[j] <= seen) {
+            const double f = sma[a.fast_sma[j]];
+            const double s = sma[a.slow_sma[j]];
+            const double p = a.pos[j];
+            act = (p > 0 && f < s) || (p < 0 && f > s) || (p == 0 && f != s);
+        }
+        if (act) todo[count++] = static_cast<std::uint32_t>(j);
+    }
+    return count;
+}
+
+#if defined(__AVX512F__)
+
+std::size_t scanLanes(const LaneArrays& a, std::size_t n, double open, double close, double seen,
+                      const double* sma, std::uint32_t* todo) {
+    const __m512d vopen = _mm512_set1_pd(open);
+    const __m512d vseen = _mm512_set1_pd(seen);
+    const __m512d zero = _mm512_setzero_pd();
+    const __mmask8 price_ok = close > 0 ? 0xFF : 0;
+    std::size_t count = 0;
+    std::size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        const __m512d pos = _mm512_load_pd(&a.pos[j]);
+        __mmask8 act = _mm512_cmp_pd_mask(_mm512_load_pd(&a.pending[j]), zero, _CMP_GT_OQ)
+                     | _mm512_cmp_pd_mask(_mm512_add_pd(_mm512_load_pd(&a.cash[j]), _mm512_mul_pd(pos, vopen)), zero, _CMP_LE_OQ);
+        const __mmask8 warm = price_ok & _mm512_cmp_pd_mask(_mm512_load_pd(&a.slow_period[j]), vseen, _CMP_LE_OQ);
+        if (warm) {
+            // Only the warmed-up lanes are gathered (the rest stay 0 and are masked out of act below).
+            const __m512d f = _mm512_mask_i64gather_pd(zero, warm, _mm512_load_si512(&a.fast_sma[j]), sma, 8);
+            const __m512d s = _mm512_mask_i64gather_pd(zero, warm, _mm512_load_si512(&a.slow_sma[j]), sma, 8);
+            const __mmask8 signal =
+                  (_mm512_cmp_pd_mask(pos, zero, _CMP_GT_OQ) & _mm512_cmp_pd_mask(f, s, _CMP_LT_OQ))
+                | (_mm512_cmp_pd_mask(pos, zero, _CMP_LT_OQ) & _mm512_cmp_pd_mask(f, s, _CMP_GT_OQ))
+                | (_mm512_cmp_pd_mask(pos, zero, _CMP_EQ_OQ) & _mm512_cmp_pd_mask(f, s, _CMP_NEQ_UQ));
+            act |= warm & signal;
+        }
+        if (act) {
+            for (int k = 0; k < 8; ++k) {
+                if (act & (1u << k)) todo[count++] = static_cast<std::uint32_t>(j + static_cast<std::size_t>(k));
+            }
+        }
+    }
+    return scanLanesScalar(a, j, n, open, close, seen, sma, todo, count);
+}
+
+void updateEquity(LaneArrays& a, std::size_t n, double close, std::size_t point) {
+    if (point == 0) { updateEquityScalar(a, 0, n, close, point); return; }
+    const __m512d vclose = _mm512_set1_pd(close);
+    const __m512d inv_count = _mm512_set1_pd(1.0 / static_cast<double>(point));
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d hundred = _mm512_set1_pd(100.0);
+    const __m512d stop_ratio = _mm512_set1_pd(STOP_CHECK_RATIO);
+    std::size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        const __m512d eq = _mm512_add_pd(_mm512_load_pd(&a.cash[j]), _mm512_mul_pd(_mm512_load_pd(&a.pos[j]), vclose));
+        _mm512_store_pd(&a.equity[j], eq);
+
+        const __m512d prev = _mm512_load_pd(&a.curve_last[j]);
+        const __mmask8 prev_nz = _mm512_cmp_pd_mask(prev, zero, _CMP_NEQ_UQ);
+        const __m512d r = _mm512_maskz_div_pd(prev_nz, _mm512_sub_pd(eq, prev), prev);
+        __m512d mean = _mm512_load_pd(&a.ret_mean[j]);
+        const __m512d delta = _mm512_sub_pd(r, mean);
+        mean = _mm512_add_pd(mean, _mm512_mul_pd(delta, inv_count));
+        _mm512_store_pd(&a.ret_mean[j], mean);
+        _mm512_store_pd(&a.ret_m2[j], _mm512_add_pd(_mm512_load_pd(&a.ret_m2[j]), _mm512_mul_pd(delta, _mm512_sub_pd(r, mean))));
+        _mm512_store_pd(&a.curve_last[j], eq);
+
+        const __m512d peak = _mm512_load_pd(&a.peak[j]);
+        const __m512d trough = _mm512_load_pd(&a.trough[j]);
+        const __mmask8 new_peak = _mm512_cmp_pd_mask(eq, peak, _CMP_GT_OQ);
+        if (new_peak) {
+            const __mmask8 peak_nz = _mm512_cmp_pd_mask(peak, zero, _CMP_NEQ_UQ);
+            const __m512d dd = _mm512_maskz_mul_pd(peak_nz, _mm512_div_pd(_mm512_sub_pd(peak, trough), peak), hundred);
+            const __m512d max_dd = _mm512_load_pd(&a.max_dd[j]);
+            _mm512_store_pd(&a.max_dd[j], _mm512_mask_blend_pd(new_peak & _mm512_cmp_pd_mask(dd, max_dd, _CMP_GT_OQ), max_dd, dd));
+            _mm512_store_pd(&a.peak[j], _mm512_mask_blend_pd(new_peak, peak, eq));
+        }
+        const __mmask8 new_trough = new_peak | _mm512_cmp_pd_mask(eq, trough, _CMP_LT_OQ);
+        _mm512_store_pd(&a.trough[j], _mm512_mask_blend_pd(new_trough, trough, eq));
+
+        __m512d bt_peak = _mm512_load_pd(&a.bt_peak[j]);
+        bt_peak = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(eq, bt_peak, _CMP_GT_OQ), bt_peak, eq);
+        _mm512_store_pd(&a.bt_peak[j], bt_peak);
+        // Lanes that may have to stop: eq <= 0, peak <= 0, or eq tiny next to the peak (see stopCode).
+        const __mmask8 check = _mm512_cmp_pd_mask(eq, zero, _CMP_LE_OQ)
+                             | _mm512_cmp_pd_mask(bt_peak, zero, _CMP_LE_OQ)
+                             | _mm512_cmp_pd_mask(eq, _mm512_mul_pd(bt_peak, stop_ratio), _CMP_LE_OQ);
+        if (check) {
+            for (int k = 0; k < 8; ++k) {
+                if ((check & (1u << k)) && a.stop[j + k] == RUNNING)
+                    a.stop[j + k] = stopCode(a.equity[j + k], a.bt_peak[j + k]);
+            }
+        }
+    }
+    updateEquityScalar(a, j, n, close, point);
+}
+
+const char* const ISA_NAME = "avx512";
+
+#elif defined(__AVX2__)
+
+std::size_t scanLanes(const LaneArrays& a, std::size_t n, double open, double close, double seen,
+                      const double* sma, std::uint32_t* todo) {
+    const __m256d vopen = _mm256_set1_pd(open);
+    const __m256d vseen = _mm256_set1_pd(seen);
+    const __m256d zero = _mm256_setzero_pd();
+    const int price_ok = close > 0 ? 0xF : 0;
+    std::size_t count = 0;
+    std::size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const __m256d pos = _mm256_load_pd(&a.pos[j]);
+        int act = _mm256_movemask_pd(_mm256_or_pd(
+            _mm256_cmp_pd(_mm256_load_pd(&a.pending[j]), zero, _CMP_GT_OQ),
+            _mm256_cmp_pd(_mm256_add_pd(_mm256_load_pd(&a.cash[j]), _mm256_mul_pd(pos, vopen)), zero, _CMP_LE_OQ)));
+        const int warm = price_ok & _mm256_movemask_pd(_mm256_cmp_pd(_mm256_load_pd(&a.slow_period[j]), vseen, _CMP_LE_OQ));
+        if (warm) {
+            const __m256d f = _mm256_i64gather_pd(sma, _mm256_load_si256(reinterpret_cast<const __m256i*>(&a.fast_sma[j])), 8);
+            const __m256d s = _mm256_i64gather_pd(sma, _mm256_load_si256(reinterpret_cast<const __m256i*>(&a.slow_sma[j])), 8);
+            const __m256d signal = _mm256_or_pd(_mm256_or_pd(
+                _mm256_and_pd(_mm256_cmp_pd(pos, zero, _CMP_GT_OQ), _mm256_cmp_pd(f, s, _CMP_LT_OQ)),
+                _mm256_and_pd(_mm256_cmp_pd(pos, zero, _CMP_LT_OQ), _mm256_cmp_pd(f, s, _CMP_GT_OQ))),
+                _mm256_and_pd(_mm256_cmp_pd(pos, zero, _CMP_EQ_OQ), _mm256_cmp_pd(f, s, _CMP_NEQ_UQ)));
+            act |= warm & _mm256_movemask_pd(signal);
+        }
+        if (act) {
+            for (int k = 0; k < 4; ++k) {
+                if (act & (1 << k)) todo[count++] = static_cast<std::uint32_t>(j + static_cast<std::size_t>(k));
+            }
+        }
+    }
+    return scanLanesScalar(a, j, n, open, close, seen, sma, todo, count);
+}
+
+void updateEquity(LaneArrays& a, std::size_t n, double close, std::size_t point) {
+    if (point == 0) { updateEquityScalar(a, 0, n, close, point); return; }
+    const __m256d vclose = _mm256_set1_pd(close);
+    const __m256d inv_count = _mm256_set1_pd(1.0 / static_cast<double>(point));
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d hundred = _mm256_set1_pd(100.0);
+    const __m256d stop_ratio = _mm256_set1_pd(STOP_CHECK_RATIO);
+    std::size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const __m256d eq = _mm256_add_pd(_mm256_load_pd(&a.cash[j]), _mm256_mul_pd(_mm256_load_pd(&a.pos[j]), vclose));
+        _mm256_store_pd(&a.equity[j], eq);
+
+        // r = prev != 0 ? (eq - prev) / prev : 0  (the and() clears the lanes that divided by zero)
+        const __m256d prev = _mm256_load_pd(&a.curve_last[j]);
+        const __m256d r = _mm256_and_pd(_mm256_div_pd(_mm256_sub_pd(eq, prev), prev), _mm256_cmp_pd(prev, zero, _CMP_NEQ_UQ));
+        __m256d mean = _mm256_load_pd(&a.ret_mean[j]);
+        const __m256d delta = _mm256_sub_pd(r, mean);
+        mean = _mm256_add_pd(mean, _mm256_mul_pd(delta, inv_count));
+        _mm256_store_pd(&a.ret_mean[j], mean);
+        _mm256_store_pd(&a.ret_m2[j], _mm256_add_pd(_mm256_load_pd(&a.ret_m2[j]), _mm256_mul_pd(delta, _mm256_sub_pd(r, mean))));
+        _mm256_store_pd(&a.curve_last[j], eq);
+
+        const __m256d peak = _mm256_load_pd(&a.peak[j]);
+        const __m256d trough = _mm256_load_pd(&a.trough[j]);
+        const __m256d new_peak = _mm256_cmp_pd(eq, peak, _CMP_GT_OQ);
+        if (_mm256_movemask_pd(new_peak)) {
+            const __m256d dd = _mm256_and_pd(_mm256_mul_pd(_mm256_div_pd(_mm256_sub_pd(peak, trough), peak), hundred),
+                                             _mm256_cmp_pd(peak, zero, _CMP_NEQ_UQ));
+            const __m256d max_dd = _mm256_load_pd(&a.max_dd[j]);
+            _mm256_store_pd(&a.max_dd[j], _mm256_blendv_pd(max_dd, dd, _mm256_and_pd(new_peak, _mm256_cmp_pd(dd, max_dd, _CMP_GT_OQ))));
+            _mm256_store_pd(&a.peak[j], _mm256_blendv_pd(peak, eq, new_peak));
+        }
+        const __m256d new_trough = _mm256_or_pd(new_peak, _mm256_cmp_pd(eq, trough, _CMP_LT_OQ));
+        _mm256_store_pd(&a.trough[j], _mm256_blendv_pd(trough, eq, new_trough));
+
+        __m256d bt_peak = _mm256_load_pd(&a.bt_peak[j]);
+        bt_peak = _mm256_blendv_pd(bt_peak, eq, _mm256_cmp_pd(eq, bt_peak, _CMP_GT_OQ));
+        _mm256_store_pd(&a.bt_peak[j], bt_peak);
+        // Lanes that may have to stop: eq <= 0, peak <= 0, or eq tiny next to the peak (see stopCode).
+        const int check = _mm256_movemask_pd(_mm256_or_pd(_mm256_or_pd(
+            _mm256_cmp_pd(eq, zero, _CMP_LE_OQ),
+            _mm256_cmp_pd(bt_peak, zero, _CMP_LE_OQ)),
+            _mm256_cmp_pd(eq, _mm256_mul_pd(bt_peak, stop_ratio), _CMP_LE_OQ)));
+        if (check) {
+            for (int k = 0; k < 4; ++k) {
+                if ((check & (1 << k)) && a.stop[j + k] == RUNNING)
+                    a.stop[j + k] = stopCode(a.equity[j + k], a.bt_peak[j + k]);
+            }
+        }
+    }
+    updateEquityScalar(a, j, n, close, point);
+}
+
+const char* const ISA_NAME = "avx2";
+
+#else
+
+std::size_t scanLanes(const LaneArrays& a, std::size_t n, double open, double close, double seen,
+                      const double* sma, std::uint32_t* todo) {
+    return scanLanesScalar(a, 0, n, open, close, seen, sma, todo, 0);
+}
+
+void updateEquity(LaneArrays& a, std::size_t n, double close, std::size_t point) {
+    updateEquityScalar(a, 0, n, close, point);
+}
+
+const char* const ISA_NAME = "scalar";
+
+#endif
+
+class Lockstep {
+public:
+    Lockstep(const std::vector<SmaLane>& lanes, double initial_cash, double commission, double slippage)
+        : initial_cash_(initial_cash), commission_(commission), slippage_(slippage)
+    {
+        std::map<std::size_t, std::size_t> period_index;
+        auto smaFor = [&](int period) {
+            const std::size_t p = static_cast<std::size_t>(period);
+            auto it = period_index.find(p);
+            if (it != period_index.end()) return it->second;
+            const std::size_t idx = smas_.size();
+            smas_.emplace_back(p);
+            period_index.emplace(p, idx);
+            return idx;
+        };
+        arrays_.resize(lanes.size(), initial_cash);
+        info_.resize(lanes.size());
+        for (std::size_t i = 0; i < lanes.size(); ++i) {
+            info_[i].id = i;
+            info_[i].size = lanes[i].size;
+            arrays_.fast_sma[i] = static_cast<std::int64_t>(smaFor(lanes[i].fast));
+            arrays_.slow_sma[i] = static_cast<std::int64_t>(smaFor(lanes[i].slow));
+            arrays_.slow_period[i] = static_cast<double>(lanes[i].slow);
+        }
+        sma_values_.assign(smas_.size(), 0.0);
+        todo_.resize(lanes.size());
+        active_ = lanes.size();
+        results_.resize(lanes.size());
+    }
+
+    std::vector<SmaLaneResult> run(const BarSeries& bars) {
+        const double* opens = bars.opens().data();
+        const double* closes = bars.closes().data();
+        double last_close = 0;
+        std::size_t i = 0;
+        for (; i < bars.size() && active_ > 0; ++i) {
+            const double open = opens[i];
+            const double close = closes[i];
+
+            // Every lane's strategy would feed its SMAs this close; each period is updated once here.
+            for (std::size_t p = 0; p < smas_.size(); ++p) sma_values_[p] = smas_[p].update(close);
+
+            const std::size_t todo = scanLanes(arrays_, active_, open, close, static_cast<double>(i + 1),
+                                               sma_values_.data(), todo_.data());
+            for (std::size_t k = 0; k < todo; ++k) {
+                const std::size_t j = todo_[k];
+                if (arrays_.pending[j] > 0) fill(j, open);
+                // Backtester: equity at the fill price <= 0 stops the run before the strategy sees the bar.
+                if (arrays_.cash[j] + arrays_.pos[j] * open <= 0) {
+                    arrays_.stop[j] = NO_EQUITY;
+                    continue;
+                }
+                signal(j, i, close);
+            }
+
+            updateEquity(arrays_, active_, close, i);
+            last_close = close;
+
+            for (std::size_t j = active_; j-- > 0;) {
+                if (arrays_.stop[j] != RUNNING) retire(j, i + 1, last_close);
+            }
+        }
+        while (active_ > 0) retire(active_ - 1, i, last_close);
+        return std::move(results_);
+    }
+
+private:
+    /// Simulator::processOrders for the lane's pending order at this bar's open.
+    void fill(std::size_t j, double open) {
+        LaneInfo& lane = info_[j];
+        double& cash = arrays_.cash[j];
+        double& pos = arrays_.pos[j];
+        const bool buy = lane.pending_long;
+        double qty = arrays_.pending[j];
+        arrays_.pending[j] = 0;
+        double fill_price = open;
+        if (slippage_ > 0) fill_price *= buy ? (1.0 + slippage_) : (1.0 - slippage_);
+
+        if ((buy && pos < 0) || (!buy && pos > 0)) {
+            const double close_qty = std::min(qty, std::abs(pos));
+            const double pnl = buy ? (lane.avg_entry - fill_price) * close_qty
+                                   : (fill_price - lane.avg_entry) * close_qty;
+            cash += pnl - commission_;
+            arrays_.equity[j] = cash + pos * fill_price;
+            const double trade_pnl = pnl - commission_;
+            ++lane.num_trades;
+            if (trade_pnl > 0) ++lane.winning_trades;
+            lane.total_pnl += trade_pnl;
+
+            if (pos > 0) pos -= close_qty;
+            else pos += close_qty;
+            if (std::abs(pos) < POSITION_ZERO_EPS) pos = 0;
+            qty -= close_qty;
+            if (qty <= 0) return;
+            if (std::abs(pos) < POSITION_ZERO_EPS) lane.avg_entry = 0;
+        }
+
+        if (qty > 0) {
+            double cost = fill_price * qty;
+            if (!buy) cost = -cost;
+            cash -= cost - commission_;
+            if (pos == 0) {
+                lane.avg_entry = fill_price;
+                pos = buy ? qty : -qty;
+            } else {
+                const double total_qty = std::abs(pos) + qty;
+                lane.avg_entry = (lane.avg_entry * std::abs(pos) + fill_price * qty) / total_qty;
+                pos += buy ? qty : -qty;
+            }
+        }
+    }
+
+    /// SmaCrossoverStrategy::onBar for bar i.
+    void signal(std::size_t j, std::size_t i, double price) {
+        if (static_cast<double>(i + 1) < arrays_.slow_period[j]) return;
+        if (price <= 0) return;
+        const LaneInfo& lane = info_[j];
+        const double fast = sma_values_[static_cast<std::size_t>(arrays_.fast_sma[j])];
+        const double slow = sma_values_[static_cast<std::size_t>(arrays_.slow_sma[j])];
+        const double pos = arrays_.pos[j];
+
+        double units = lane.size * (arrays_.equity[j] / price);
+        if (units < 1.0) units = 1.0;
+
+        if (pos > 0 && fast < slow) {
+            place(j, false, static_cast<double>(static_cast<int>(pos)));
+            return;
+        }
+        if (pos < 0 && fast > slow) {
+            place(j, true, static_cast<double>(static_cast<int>(-pos)));
+            return;
+        }
+        if (pos != 0) return;
+        if (fast > slow) place(j, true, std::floor(units));
+        else if (fast < slow) place(j, false, std::floor(units));
+    }
+
+    void place(std::size_t j, bool buy, double qty) {
+        if (qty <= 0) return;
+        info_[j].pending_long = buy;
+        arrays_.pending[j] = qty;
+    }
+
+    /// Record slot j's metrics (curve_points = equity-curve length) and move the last active slot into it.
+    void retire(std::size_t j, std::size_t curve_points, double last_close) {
+        const LaneInfo& lane = info_[j];
+        SmaLaneResult& out = results_[lane.id];
+        BacktestMetrics& m = out.metrics;
+        m.initial_equity = initial_cash_;
+        m.final_equity = arrays_.equity[j];
+        m.total_return_pct = (initial_cash_ != 0) ? ((m.final_equity - initial_cash_) / initial_cash_) * 100.0 : 0;
+        if (curve_points > 0) {
+            m.max_drawdown_pct = std::max(arrays_.max_dd[j], epochDrawdown(arrays_.peak[j], arrays_.trough[j]));
+            if (curve_points >= 2) {
+                const std::size_t returns = curve_points - 1;
+                const double stddev = (returns > 1) ? std::sqrt(arrays_.ret_m2[j] / static_cast<double>(returns - 1)) : 0;
+                m.sharpe_ratio = (stddev != 0) ? (arrays_.ret_mean[j] / stddev) * std::sqrt(TRADING_DAYS_PER_YEAR) : 0;
+            }
+            m.calmar_ratio = (m.max_drawdown_pct != 0) ? m.total_return_pct / m.max_drawdown_pct : 0;
+            m.num_trades = lane.num_trades;
+            m.winning_trades = lane.winning_trades;
+            m.win_rate_pct = (m.num_trades > 0) ? (100.0 * m.winning_trades / m.num_trades) : 0;
+            m.avg_trade_pnl = (m.num_trades > 0) ? (lane.total_pnl / m.num_trades) : 0;
+            const double pos = arrays_.pos[j];
+            m.open_position = pos;
+            if (std::abs(pos) >= 1e-9 && last_close > 0)
+                m.unrealized_pnl = pos * (last_close - lane.avg_entry);
+        }
+        if (arrays_.stop[j] == NO_EQUITY) out.stop_reason = "no more equity";
+        else if (arrays_.stop[j] == MAX_DRAWDOWN) out.stop_reason = "max drawdown 100%";
+
+        const std::size_t last = --active_;
+        if (j != last) {
+            arrays_.swapSlots(j, last);
+            std::swap(info_[j], info_[last]);
+        }
+    }
+
+    double initial_cash_;
+    double commission_;
+    double slippage_;
+    std::vector<Sma> smas_;            // one per distinct period
+    std::vector<double> sma_values_;   // this bar's value of each
+    LaneArrays arrays_;
+    std::vector<LaneInfo> info_;
+    std::vector<std::uint32_t> todo_;  // slots scanLanes() flagged this bar
+    std::size_t active_{0};
+    std::vector<SmaLaneResult> results_;
+};
+
+} // namespace
+
+std::vector<SmaLaneResult> runSmaCrossoverLockstep(const BarSeries& bars,
+                                                   const std::vector<SmaLane>& lanes,
+                                                   double initial_cash,
+                                                   double commission,
+                                                   double slippage) {
+    Lockstep kernel(lanes, initial_cash, commission, slippage < 0 ? 0 : slippage);
+    return kernel.run(bars);
+}
+
+const char* smaLockstepIsa() { return ISA_NAME; }
+
+} // namespace backtest
@@ -0,0 +1,232 @@
+#include "sweep.hpp"
+#include "backtester.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+
+namespace backtest {
+
+namespace {
+
+bool parseNumber(const std::string& s, double& out) {
+    try {
+        std::size_t pos = 0;
+        out = std::stod(s, &pos);
+        return pos == s.size() && std::isfinite(out);
+    } catch (...) {
+        return false;
+    }
+}
+
+} // namespace
+
+std::size_t SweepRange::count() const {
+    if (step <= 0 || end < start) return 0;
+    // Small tolerance so 0.1:0.5:0.1 includes 0.5 despite rounding.
+    return static_cast<std::size_t>(std::floor((end - start) / step + 1e-9)) + 1;
+}
+
+bool parseSweepSpec(const std::string& spec, std::vector<SweepRange>& ranges, std::string& error_msg) {
+    ranges.clear();
+    std::istringstream iss(spec);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        if (item.empty()) continue;
+        auto eq = item.find('=');
+        if (eq == std::string::npos || eq == 0) {
+            error_msg = "--sweep: expected name=start:end[:step], got \"" + item + "\"";
+            return false;
+        }
+        SweepRange r;
+        r.name = item.substr(0, eq);
+        for (const auto& other : ranges) {
+            if (other.name == r.name) { error_msg = "--sweep: \"" + r.name + "\" given twice"; return false; }
+        }
+
+        std::vector<std::string> parts;
+        std::istringstream vs(item.substr(eq + 1));
+        std::string part;
+        while (std::getline(vs, part, ':')) parts.push_back(part);
+        if (parts.empty() || parts.size() > 3) {
+            error_msg = "--sweep: expected name=start:end[:step], got \"" + item + "\"";
+            return false;
+        }
+        bool ok = parseNumber(parts[0], r.start);
+        r.end = r.start;
+        if (ok && parts.size() >= 2) ok = parseNumber(parts[1], r.end);
+        if (ok && parts.size() == 3) ok = parseNumber(parts[2], r.step);
+        if (!ok) {
+            error_msg = "--sweep: invalid number in \"" + item + "\"";
+            return false;
+        }
+        if (r.step <= 0 || r.end < r.start) {
+            error_msg = "--sweep: \"" + item + "\" needs start <= end and step > 0";
+            return false;
+        }
+        ranges.push_back(r);
+    }
+    if (ranges.empty()) {
+        error_msg = "--sweep: no parameters given";
+        return false;
+    }
+    return true;
+}
+
+std::size_t sweepSize(const std::vector<SweepRange>& ranges) {
+    if (ranges.empty()) return 0;
+    std::size_t total = 1;
+    for (const auto& r : ranges) {
+        std::size_t n = r.count();
+        if (n == 0 || total > std::numeric_limits<std::size_t>::max() / n) return 0;
+        total *= n;
+    }
+    return total;
+}
+
+std::vector<double> sweepValues(const std::vector<SweepRange>& ranges, std::size_t index) {
+    std::vector<double> values(ranges.size());
+    for (std::size_t k = ranges.size(); k-- > 0;) {
+        const std::size_t n = ranges[k].count();
+        values[k] = ranges[k].value(index % n);
+        index /= n;
+    }
+    return values;
+}
+
+std::vector<SweepResult> runSweep(const std::shared_ptr<const BarSeries>& bars,
+                                  const std::vector<SweepRange>& ranges,
+                                  const SweepStrategyFactory& factory,
+                                  const SweepOptions& options,
+                                  ThreadPool& pool) {
+    const std::size_t total = sweepSize(ranges);
+    if (total > MAX_SWEEP_COMBINATIONS) return {};
+    // One slot per combination: workers never share a slot, and order doesn't depend on scheduling.
+    std::vector<std::optional<SweepResult>> slots(total);
+    std::shared_ptr<IndicatorCache> cache;
+    if (options.indicator_cache_bytes > 0) cache = std::make_shared<IndicatorCache>(options.indicator_cache_bytes);
+    const std::uint64_t series_id = IndicatorCache::newSeriesId();
+    std::shared_ptr<PruneBoard> board;
+    if (options.prune.equity_percentile > 0) board = std::make_shared<PruneBoard>(options.prune.checkpoints);
+
+    pool.parallelFor(total, [&](std::size_t i) {
+        std::vector<double> values = sweepValues(ranges, i);
+        std::unique_ptr<IStrategy> strategy = factory(values);
+        if (!strategy) return;
+
+        Backtester bt(std::move(strategy), bars, options.initial_cash, options.commission, options.slippage);
+        if (cache) bt.setIndicatorCache(cache, series_id);
+        if (options.intrabar) bt.setIntrabar(options.intrabar);
+        bt.setRecordEquityCurve(false);  // metrics are accumulated during the run
+        if (options.prune.any()) bt.setPruning(options.prune, board);
+        bt.setRange(options.range_begin, options.range_end);
+        if (!bt.run()) return;
+
+        SweepResult result;
+        result.index = i;
+        result.values = std::move(values);
+        result.metrics = bt.metrics();
+        if (bt.stoppedEarly()) result.stop_reason = bt.stopReason();
+        slots[i] = std::move(result);
+    });
+
+    std::vector<SweepResult> results;
+    results.reserve(total);
+    for (auto& s : slots) {
+        if (s) results.push_back(std::move(*s));
+    }
+    return results;
+}
+
+std::vector<SweepResult> runSmaSweep(const BarSeries& bars,
+                                     const std::vector<SweepRange>& ranges,
+                                     const SmaLaneFactory& lane_factory,
+                                     const SweepOptions& options,
+                                     ThreadPool& pool) {
+    const std::size_t total = sweepSize(ranges);
+    if (total > MAX_SWEEP_COMBINATIONS) return {};
+
+    // Big chunks share more SMA work; a few per thread keep the pool balanced when lanes stop early.
+    // Each task builds its own chunk's lanes, so only the chunks in flight hold lanes at once.
+    constexpr std::size_t MIN_CHUNK = 64;
+    const std::size_t chunks = std::max<std::size_t>(1, std::min(pool.size() * 4, total / MIN_CHUNK));
+    const std::size_t per_chunk = (total + chunks - 1) / chunks;
+
+    std::vector<std::vector<SweepResult>> chunk_results(chunks);
+    pool.parallelFor(chunks, [&](std::size_t c) {
+        const std::size_t begin = c * per_chunk;
+        const std::size_t end = std::min(total, begin + per_chunk);
+        std::vector<SmaLane> lanes;
+        std::vector<std::size_t> lane_index;  // combination index of each lane
+        for (std::size_t i = begin; i < end; ++i) {
+            SmaLane lane;
+            if (!lane_factory(sweepValues(ranges, i), lane)) continue;
+            lanes.push_back(lane);
+            lane_index.push_back(i);
+        }
+        if (lanes.empty()) return;
+        std::vector<SmaLaneResult> out = runSmaCrossoverLockstep(bars, lanes, options.initial_cash,
+                                                                 options.commission, options.slippage);
+        std::vector<SweepResult>& results = chunk_results[c];
+        results.resize(out.size());
+        for (std::size_t k = 0; k < out.size(); ++k) {
+            SweepResult& r = results[k];
+            r.index = lane_index[k];
+            r.values = sweepValues(ranges, r.index);
+            r.metrics = out[k].metrics;
+            r.stop_reason = std::move(out[k].stop_reason);
+        }
+    });
+
+    std::vector<SweepResult> results;
+    for (auto& chunk : chunk_results) {
+        for (auto& r : chunk) results.push_back(std::move(r));
+    }
+    return results;
+}
+
+bool parseSweepRank(const std::string& name, SweepRank& out) {
+    if (name == "return") { out = SweepRank::Return; return true; }
+    if (name == "sharpe") { out = SweepRank::Sharpe; return true; }
+    if (name == "drawdown") { out = SweepRank::Drawdown; return true; }
+    return false;
+}
+
+void rankSweepResults(std::vector<SweepResult>& results, SweepRank rank) {
+    auto better = [rank](const SweepResult& a, const SweepResult& b) {
+        if (a.pruned() != b.pruned()) return b.pruned();
+        switch (rank) {
+        case SweepRank::Sharpe: return a.metrics.sharpe_ratio > b.metrics.sharpe_ratio;
+        case SweepRank::Drawdown: return a.metrics.max_drawdown_pct < b.metrics.max_drawdown_pct;
+        case SweepRank::Return: break;
+        }
+        return a.metrics.total_return_pct > b.metrics.total_return_pct;
+    };
+    std::stable_sort(results.begin(), results.end(), better);
+}
+
+bool writeSweepCsv(const std::string& filepath, const std::vector<SweepRange>& ranges,
+                   const std::vector<SweepResult>& results) {
+    std::ofstream f(filepath);
+    if (!f) {
+        std::cerr << "Failed to write sweep results: " << filepath << "\n";
+        return false;
+    }
+    for (const auto& r : ranges) f << r.name << ",";
+    f << "return_pct,max_drawdown_pct,sharpe,trades,win_rate_pct,final_equity,stopped\n";
+    f.precision(10);
+    for (const auto& r : results) {
+        for (double v : r.values) f << v << ",";
+        const auto& m = r.metrics;
+        f << m.total_return_pct << "," << m.max_drawdown_pct << "," << m.sharpe_ratio << ","
+          << m.num_trades << "," << m.win_rate_pct << "," << m.final_equity << ","
+          << (r.stop_reason.empty() ? "-" : r.stop_reason) << "\n";
+    }
+    return true;
+}
+
+} // namespace backtest
@@ -0,0 +1,95 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace backtest {
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    if (threads == 0) threads = defaultThreads();
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        workers_.emplace_back([this]() { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& w : workers_) w.join();
+}
+
+std::size_t ThreadPool::defaultThreads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;  // stopping and drained
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn) {
+    if (count == 0) return;
+
+    // Shared with helper tasks, which may start after this call has returned (they then find no work).
+    struct State {
+        std::atomic<std::size_t> next{0};
+        std::size_t count{0};
+        const std::function<void(std::size_t)>* fn{nullptr};
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        std::size_t done{0};
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    state->count = count;
+    state->fn = &fn;
+
+    auto drain = [](State& s) {
+        std::size_t finished = 0;
+        std::exception_ptr error;
+        for (std::size_t i; (i = s.next.fetch_add(1)) < s.count; ++finished) {
+            try {
+                (*s.fn)(i);
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+        if (finished == 0) return;
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (error && !s.error) s.error = error;
+        s.done += finished;
+        if (s.done == s.count) s.done_cv.notify_all();
+    };
+
+    const std::size_t helpers = std::min(size(), count - 1);
+    for (std::size_t h = 0; h < helpers; ++h)
+        enqueue([state, drain]() { drain(*state); });
+    drain(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done_cv.wait(lock, [&]() { return state->done == state->count; });
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+} // namespace backtest
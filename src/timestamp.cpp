@@ -0,0 +1,139 @@
+#include "timestamp.hpp"
+
+namespace backtest {
+
+namespace {
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+/// Parse exactly n digits at s[pos]. Advances pos.
+bool readDigits(std::string_view s, std::size_t& pos, int n, int& out) {
+    if (pos + static_cast<std::size_t>(n) > s.size()) return false;
+    int v = 0;
+    for (int k = 0; k < n; ++k) {
+        char c = s[pos + static_cast<std::size_t>(k)];
+        if (!isDigit(c)) return false;
+        v = v * 10 + (c - '0');
+    }
+    pos += static_cast<std::size_t>(n);
+    out = v;
+    return true;
+}
+
+inline bool isTimeSep(char c) { return c == ':' || c == '_'; }
+
+inline void put2(char* p, unsigned v) {
+    p[0] = static_cast<char>('0' + v / 10);
+    p[1] = static_cast<char>('0' + v % 10);
+}
+
+} // namespace
+
+void civilFromDays(std::int64_t days, int& y, unsigned& m, unsigned& d) {
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int>(static_cast<std::int64_t>(yoe) + era * 400) + (m <= 2);
+}
+
+bool parseTimestamp(std::string_view s, std::int64_t& out_ns) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '"')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '"' || s.back() == '\r')) s.remove_suffix(1);
+
+    std::size_t pos = 0;
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (!readDigits(s, pos, 4, year)) return false;
+    if (pos >= s.size() || isDigit(s[pos])) return false;
+    ++pos;
+    if (!readDigits(s, pos, 2, month)) return false;
+    if (pos >= s.size() || isDigit(s[pos])) return false;
+    ++pos;
+    if (!readDigits(s, pos, 2, day)) return false;
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+    std::int64_t frac_ns = 0;
+    if (pos < s.size() && (s[pos] == 'T' || s[pos] == ' ')) {
+        ++pos;
+        if (!readDigits(s, pos, 2, hour)) return false;
+        if (pos >= s.size() || !isTimeSep(s[pos])) return false;
+        ++pos;
+        if (!readDigits(s, pos, 2, minute)) return false;
+        if (pos < s.size() && isTimeSep(s[pos])) {
+            ++pos;
+            if (!readDigits(s, pos, 2, second)) return false;
+            if (pos < s.size() && s[pos] == '.') {
+                ++pos;
+                std::int64_t scale = NS_PER_SECOND;
+                while (pos < s.size() && isDigit(s[pos])) {
+                    scale /= 10;
+                    frac_ns += (s[pos] - '0') * scale;  // digits past nanoseconds add 0
+                    ++pos;
+                }
+            }
+        }
+        if (hour > 23 || minute > 59 || second > 60) return false;
+    }
+    if (pos < s.size() && s[pos] == 'Z') ++pos;
+    if (pos != s.size()) return false;
+
+    out_ns = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * NS_PER_DAY
+           + hour * NS_PER_HOUR + minute * NS_PER_MINUTE + second * NS_PER_SECOND + frac_ns;
+    return true;
+}
+
+std::size_t formatTimestamp(std::int64_t ns, char* buf) {
+    std::int64_t days = ns / NS_PER_DAY;
+    std::int64_t rem = ns % NS_PER_DAY;
+    if (rem < 0) {
+        rem += NS_PER_DAY;
+        --days;
+    }
+    int y;
+    unsigned m, d;
+    civilFromDays(days, y, m, d);
+    const unsigned hour = static_cast<unsigned>(rem / NS_PER_HOUR);
+    const unsigned minute = static_cast<unsigned>(rem % NS_PER_HOUR / NS_PER_MINUTE);
+    const unsigned second = static_cast<unsigned>(rem % NS_PER_MINUTE / NS_PER_SECOND);
+    const std::int64_t frac = rem % NS_PER_SECOND;
+
+    unsigned uy = static_cast<unsigned>(y < 0 ? 0 : y) % 10000;
+    buf[0] = static_cast<char>('0' + uy / 1000);
+    buf[1] = static_cast<char>('0' + uy / 100 % 10);
+    put2(buf + 2, uy % 100);
+    buf[4] = '-';
+    put2(buf + 5, m);
+    buf[7] = '-';
+    put2(buf + 8, d);
+    buf[10] = ' ';
+    put2(buf + 11, hour);
+    buf[13] = ':';
+    put2(buf + 14, minute);
+    buf[16] = ':';
+    put2(buf + 17, second);
+    std::size_t len = 19;
+    if (frac != 0) {
+        buf[len++] = '.';
+        std::int64_t f = frac;
+        for (int k = 8; k >= 0; --k) {
+            buf[len + static_cast<std::size_t>(k)] = static_cast<char>('0' + f % 10);
+            f /= 10;
+        }
+        len += 9;
+    }
+    buf[len++] = 'Z';
+    buf[len] = '\0';
+    return len;
+}
+
+std::string formatTimestamp(std::int64_t ns) {
+    char buf[32];
+    std::size_t n = formatTimestamp(ns, buf);
+    return std::string(buf, n);
+}
+
+} // namespace backtest
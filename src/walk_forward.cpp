@@ -0,0 +1,193 @@
+#include "walk_forward.hpp"
+#include "backtester.hpp"
+#include "bar_aggregator.hpp"
+#include "buffered_writer.hpp"
+#include "timestamp.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace backtest {
+
+namespace {
+
+/// A bar count ("20000") or a duration ("90d"); exactly one of bars / ns is set on success.
+bool parseLength(const std::string& s, std::size_t& bars, std::int64_t& ns) {
+    bars = 0;
+    ns = 0;
+    if (s.empty()) return false;
+    if (std::all_of(s.begin(), s.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; })) {
+        if (s.size() > 12) return false;
+        bars = static_cast<std::size_t>(std::stoull(s));
+        return bars > 0;
+    }
+    BarResolution res;
+    if (s.find('@') != std::string::npos || !parseBarResolution(s, res)) return false;
+    ns = res.period_ns;
+    return true;
+}
+
+std::size_t firstAtOrAfter(const Column<std::int64_t>& times, std::int64_t t) {
+    return static_cast<std::size_t>(std::lower_bound(times.begin(), times.end(), t) - times.begin());
+}
+
+} // namespace
+
+bool parseWalkForwardSpec(const std::string& text, WalkForwardSpec& out, std::string& error_msg) {
+    std::vector<std::string> parts;
+    std::istringstream iss(text);
+    std::string part;
+    while (std::getline(iss, part, ':')) parts.push_back(part);
+    const std::string usage = "--walk-forward: expected IS:OOS[:anchored] (bar counts or durations, e.g. 90d:30d), got \"" + text + "\"";
+    if (parts.size() < 2 || parts.size() > 3 || (parts.size() == 3 && parts[2] != "anchored")) {
+        error_msg = usage;
+        return false;
+    }
+    WalkForwardSpec spec;
+    spec.anchored = parts.size() == 3;
+    if (!parseLength(parts[0], spec.in_sample_bars, spec.in_sample_ns) ||
+        !parseLength(parts[1], spec.out_of_sample_bars, spec.out_of_sample_ns)) {
+        error_msg = usage;
+        return false;
+    }
+    if ((spec.in_sample_bars > 0) != (spec.out_of_sample_bars > 0)) {
+        error_msg = "--walk-forward: give both lengths as bar counts or both as durations";
+        return false;
+    }
+    out = spec;
+    return true;
+}
+
+std::vector<WalkForwardWindow> walkForwardWindows(const BarSeries& bars, const WalkForwardSpec& spec) {
+    std::vector<WalkForwardWindow> windows;
+    const std::size_t n = bars.size();
+    if (n == 0) return windows;
+
+    if (spec.in_sample_bars > 0 && spec.out_of_sample_bars > 0) {
+        for (std::size_t start = 0; start + spec.in_sample_bars < n; start += spec.out_of_sample_bars) {
+            WalkForwardWindow w;
+            w.is_begin = spec.anchored ? 0 : start;
+            w.is_end = start + spec.in_sample_bars;
+            w.oos_begin = w.is_end;
+            w.oos_end = std::min(n, w.oos_begin + spec.out_of_sample_bars);
+            windows.push_back(w);
+        }
+        return windows;
+    }
+    if (spec.in_sample_ns <= 0 || spec.out_of_sample_ns <= 0) return windows;
+
+    const Column<std::int64_t> times = bars.times();
+    const std::int64_t first = times[0];
+    for (std::int64_t start = first; start + spec.in_sample_ns <= times[n - 1]; start += spec.out_of_sample_ns) {
+        WalkForwardWindow w;
+        w.is_begin = spec.anchored ? 0 : firstAtOrAfter(times, start);
+        w.is_end = firstAtOrAfter(times, start + spec.in_sample_ns);
+        w.oos_begin = w.is_end;
+        w.oos_end = firstAtOrAfter(times, start + spec.in_sample_ns + spec.out_of_sample_ns);
+        if (w.is_begin < w.is_end && w.oos_begin < w.oos_end) windows.push_back(w);
+    }
+    return windows;
+}
+
+WalkForwardReport runWalkForward(const std::shared_ptr<const BarSeries>& bars,
+                                 const std::vector<WalkForwardWindow>& windows,
+                                 const std::vector<SweepRange>& ranges,
+                                 const SweepStrategyFactory& factory,
+                                 const SweepOptions& options,
+                                 SweepRank rank,
+                                 ThreadPool& pool) {
+    WalkForwardReport report;
+    double cash = options.initial_cash;
+    for (const auto& w : windows) {
+        SweepOptions is_options = options;
+        is_options.range_begin = w.is_begin;
+        is_options.range_end = w.is_end;
+        std::vector<SweepResult> results = runSweep(bars, ranges, factory, is_options, pool);
+        rankSweepResults(results, rank);
+        if (results.empty() || results.front().pruned()) continue;  // pruned runs sort last: none finished
+
+        WalkForwardResult out;
+        out.window = w;
+        out.candidates = results.size();
+        out.best = std::move(results.front());
+
+        Backtester bt(factory(out.best.values), bars, cash, options.commission, options.slippage);
+        if (options.intrabar) bt.setIntrabar(options.intrabar);
+        bt.setRange(w.oos_begin, w.oos_end);
+        if (!bt.run()) continue;
+        out.oos = bt.metrics();
+        if (bt.stoppedEarly()) out.oos_stop_reason = bt.stopReason();
+
+        const auto& curve = bt.simulator().equityCurve();
+        for (std::size_t j = 0; j < curve.size(); ++j) {
+            report.oos_equity.push_back(curve[j]);
+            report.oos_bar.push_back(w.oos_begin + j);
+        }
+        report.windows.push_back(std::move(out));
+        cash = report.windows.back().oos.final_equity;
+        if (cash <= 0) break;
+    }
+    return report;
+}
+
+bool writeWalkForwardCsv(const std::string& filepath, const BarSeries& bars, const std::vector<SweepRange>& ranges,
+                         const WalkForwardReport& report) {
+    std::ofstream f(filepath);
+    if (!f) {
+        std::cerr << "Failed to write walk-forward results: " << filepath << "\n";
+        return false;
+    }
+    f << "window,is_begin,is_end,oos_begin,oos_end,is_start,oos_start,oos_last,";
+    for (const auto& r : ranges) f << r.name << ",";
+    f << "candidates,is_return_pct,is_max_drawdown_pct,is_sharpe,oos_return_pct,oos_max_drawdown_pct,oos_sharpe,"
+         "oos_trades,oos_final_equity,oos_stopped\n";
+    f.precision(10);
+    const Column<std::int64_t> times = bars.times();
+    for (std::size_t k = 0; k < report.windows.size(); ++k) {
+        const auto& r = report.windows[k];
+        const auto& w = r.window;
+        f << k << "," << w.is_begin << "," << w.is_end << "," << w.oos_begin << "," << w.oos_end << ","
+          << formatTimestamp(times[w.is_begin]) << "," << formatTimestamp(times[w.oos_begin]) << ","
+          << formatTimestamp(times[w.oos_end - 1]) << ",";
+        for (double v : r.best.values) f << v << ",";
+        const auto& is = r.best.metrics;
+        const auto& oos = r.oos;
+        f << r.candidates << "," << is.total_return_pct << "," << is.max_drawdown_pct << "," << is.sharpe_ratio << ","
+          << oos.total_return_pct << "," << oos.max_drawdown_pct << "," << oos.sharpe_ratio << ","
+          << oos.num_trades << "," << oos.final_equity << ","
+          << (r.oos_stop_reason.empty() ? "-" : r.oos_stop_reason) << "\n";
+    }
+    return true;
+}
+
+bool writeWalkForwardEquity(const std::string& filepath, const BarSeries& bars, const WalkForwardReport& report) {
+    BufferedWriter f;
+    if (!f.open(filepath)) {
+        std::cerr << "Failed to open for writing: " << filepath << "\n";
+        return false;
+    }
+    f.write("window,bar_index,timestamp,equity\n");
+    const Column<std::int64_t> times = bars.times();
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < report.oos_equity.size(); ++i) {
+        const std::size_t bar = report.oos_bar[i];
+        while (k + 1 < report.windows.size() && bar >= report.windows[k + 1].window.oos_begin) ++k;
+        f.integer(static_cast<std::uint64_t>(k));
+        f.put(',');
+        f.integer(static_cast<std::uint64_t>(bar));
+        f.write(",\"");
+        f.timestamp(times[bar]);
+        f.write("\",");
+        f.fixed(report.oos_equity[i], 2);
+        f.put('\n');
+    }
+    if (!f.close()) {
+        std::cerr << "Failed to write walk-forward equity: " << filepath << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace backtest
@@ -1,7 +1,8 @@
 #include "ctm_strategy_simple.hpp"
 #include "context.hpp"
 #include "bar.hpp"
-#include <vector>
+#include "cached_sma.hpp"
+#include "indicators.hpp"
 #include <cmath>
 #include <algorithm>
 #include <memory>
@@ -10,24 +11,6 @@ namespace backtest {
 
 namespace {
 
-double sma(const std::vector<Bar>& bars, std::size_t end_index, int period) {
-    if (period <= 0 || end_index < static_cast<std::size_t>(period)) return 0;
-    double sum = 0;
-    for (int i = 0; i < period; ++i)
-        sum += bars[end_index - 1 - i].close;
-    return sum / period;
-}
-
-// Kalman smoothing: price -> smoothed price. State: kalman_price, kalman_velo.
-inline double kalman_smooth(double price, double prev_kalman_price, double prev_kalman_velo,
-                            double kalman_gain, double& out_kalman_price, double& out_kalman_velo) {
-    double distance = price - prev_kalman_price;
-    double smooth = prev_kalman_price + distance * std::sqrt(kalman_gain / 10000.0 * 2.0);
-    out_kalman_velo = prev_kalman_velo + (kalman_gain / 10000.0) * distance;
-    out_kalman_price = smooth + out_kalman_velo;
-    return out_kalman_price;
-}
-
 // Loft trend: 1 = UP, -1 = DOWN. Returns (trend_direction, loft_moved).
 inline void loft_trend(double price, int prev_trend, double prev_loft_level, double prev_dist_pct,
                        double dist_init, double dist_min, double dist_decrement,
@@ -75,14 +58,27 @@ inline void loft_trend(double price, int prev_trend, double prev_loft_level, dou
 
 class CtmStrategy : public IStrategy {
 public:
-    explicit CtmStrategy(const CtmParams& params) : p_(params) {}
-
-    void onStart(IContext& /*ctx*/) override {
+    explicit CtmStrategy(const CtmParams& params)
+        : p_(params)
+        , sma_long_fast_(period(params.long_fast))
+        , sma_long_medium_(period(params.long_medium))
+        , sma_long_slow_(period(params.long_slow))
+        , sma_short_fast_(period(params.short_fast))
+        , sma_short_medium_(period(params.short_medium))
+        , sma_short_slow_(period(params.short_slow))
+        , kalman_long_(params.kalman_gain_long)
+        , kalman_short_(params.kalman_gain_short)
+    {}
+
+    void onStart(IContext& ctx) override {
         prev_distance_long_ = 0;
         prev_distance_short_ = 0;
         has_prev_ = false;
-        kalman_initialized_long_ = false;
-        kalman_initialized_short_ = false;
+        for (CachedSma* s : { &sma_long_fast_, &sma_long_medium_, &sma_long_slow_,
+                              &sma_short_fast_, &sma_short_medium_, &sma_short_slow_ })
+            s->start(ctx);
+        kalman_long_.reset();
+        kalman_short_.reset();
         loft_trend_long_ = 1;
         loft_trend_short_ = -1;
         loft_level_long_ = 0;
@@ -92,35 +88,19 @@ public:
     }
 
     void onBar(const Bar& bar, IContext& ctx) override {
-        const auto& bars = ctx.bars();
-        std::size_t n = ctx.barIndex() + 1;
+        // SMAs see every bar's close, in order (O(1) each; a lookup when the run has an indicator cache).
+        for (CachedSma* s : { &sma_long_fast_, &sma_long_medium_, &sma_long_slow_,
+                              &sma_short_fast_, &sma_short_medium_, &sma_short_slow_ })
+            s->update(bar.close, ctx.barIndex());
+
+        std::size_t n = ctx.bars().size();
         double price = bar.close;
         if (price <= 0) return;
 
         // Kalman smoothing (run from first bar when filter enabled)
         double kalman_long = price, kalman_short = price;
-        if (p_.use_kalman_trend_long) {
-            if (!kalman_initialized_long_) {
-                kalman_price_long_ = price;
-                kalman_velo_long_ = 0;
-                kalman_initialized_long_ = true;
-                kalman_long = price;
-            } else {
-                kalman_long = kalman_smooth(price, kalman_price_long_, kalman_velo_long_,
-                    p_.kalman_gain_long, kalman_price_long_, kalman_velo_long_);
-            }
-        }
-        if (p_.use_kalman_trend_short) {
-            if (!kalman_initialized_short_) {
-                kalman_price_short_ = price;
-                kalman_velo_short_ = 0;
-                kalman_initialized_short_ = true;
-                kalman_short = price;
-            } else {
-                kalman_short = kalman_smooth(price, kalman_price_short_, kalman_velo_short_,
-                    p_.kalman_gain_short, kalman_price_short_, kalman_velo_short_);
-            }
-        }
+        if (p_.use_kalman_trend_long) kalman_long = kalman_long_.update(price);
+        if (p_.use_kalman_trend_short) kalman_short = kalman_short_.update(price);
 
         // Loft trend on Kalman price (when filter enabled)
         bool loft_moved_long = false, loft_moved_short = false;
@@ -150,15 +130,15 @@ public:
         }
 
         // Long: distance_long = min(price - sma_fast, price - sma_med, price - sma_slow)
-        double lf = sma(bars, n, p_.long_fast);
-        double lm = sma(bars, n, p_.long_medium);
-        double ls = sma(bars, n, p_.long_slow);
+        double lf = sma_long_fast_.value();
+        double lm = sma_long_medium_.value();
+        double ls = sma_long_slow_.value();
         double distance_long = std::min({ price - lf, price - lm, price - ls });
 
         // Short: distance_short = max(price - sma_fast, price - sma_med, price - sma_slow)
-        double sf = sma(bars, n, p_.short_fast);
-        double sm = sma(bars, n, p_.short_medium);
-        double ss = sma(bars, n, p_.short_slow);
+        double sf = sma_short_fast_.value();
+        double sm = sma_short_medium_.value();
+        double ss = sma_short_slow_.value();
         double distance_short = std::max({ price - sf, price - sm, price - ss });
 
         double pos = ctx.position();
@@ -220,18 +200,19 @@ public:
     void onEnd(IContext& /*ctx*/) override {}
 
 private:
+    static std::size_t period(int p) { return p > 0 ? static_cast<std::size_t>(p) : 1; }
+
     CtmParams p_;
     double prev_distance_long_ = 0;
     double prev_distance_short_ = 0;
     bool has_prev_ = false;
 
+    CachedSma sma_long_fast_, sma_long_medium_, sma_long_slow_;
+    CachedSma sma_short_fast_, sma_short_medium_, sma_short_slow_;
+
     // Kalman smoothing state
-    bool kalman_initialized_long_ = false;
-    bool kalman_initialized_short_ = false;
-    double kalman_price_long_ = 0;
-    double kalman_velo_long_ = 0;
-    double kalman_price_short_ = 0;
-    double kalman_velo_short_ = 0;
+    KalmanSmoother kalman_long_;
+    KalmanSmoother kalman_short_;
 
     // Loft trend state (1 = UP, -1 = DOWN)
     int loft_trend_long_ = 1;
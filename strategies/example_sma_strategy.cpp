@@ -1,8 +1,7 @@
 #include "example_sma_strategy.hpp"
 #include "context.hpp"
 #include "bar.hpp"
-#include <vector>
-#include <numeric>
+#include "cached_sma.hpp"
 #include <cmath>
 #include <memory>
 
@@ -16,18 +15,23 @@ public:
         : fast_period_(fast_period)
         , slow_period_(slow_period)
         , position_size_(position_size)
+        , fast_(static_cast<std::size_t>(fast_period))
+        , slow_(static_cast<std::size_t>(slow_period))
     {}
 
-    void onStart(IContext& /*ctx*/) override {}
+    void onStart(IContext& ctx) override {
+        fast_.start(ctx);
+        slow_.start(ctx);
+    }
 
     void onBar(const Bar& bar, IContext& ctx) override {
-        const auto& bars = ctx.bars();
-        // Use only bars up to and including current bar (no look-ahead)
-        std::size_t n = ctx.barIndex() + 1;
-        if (n < static_cast<std::size_t>(slow_period_)) return;
+        // Fed every bar, in order: both SMAs cover bars up to and including this one (no look-ahead)
+        fast_.update(bar.close, ctx.barIndex());
+        slow_.update(bar.close, ctx.barIndex());
+        if (ctx.bars().size() < static_cast<std::size_t>(slow_period_)) return;
 
-        double fast_sma = sma(bars, n, fast_period_);
-        double slow_sma = sma(bars, n, slow_period_);
+        double fast_sma = fast_.value();
+        double slow_sma = slow_.value();
         double current_pos = ctx.position();
         double price = bar.close;
 
@@ -61,18 +65,11 @@ public:
     void onEnd(IContext& /*ctx*/) override {}
 
 private:
-    static double sma(const std::vector<Bar>& bars, std::size_t end_index, int period) {
-        if (period <= 0 || end_index < static_cast<std::size_t>(period)) return 0;
-        double sum = 0;
-        for (int i = 0; i < period; ++i) {
-            sum += bars[end_index - 1 - i].close;
-        }
-        return sum / period;
-    }
-
     int fast_period_;
     int slow_period_;
     double position_size_;
+    CachedSma fast_;
+    CachedSma slow_;
 };
 
 } // namespace backtest
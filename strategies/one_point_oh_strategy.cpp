@@ -1,67 +1,66 @@
 #include "one_point_oh_strategy.hpp"
 #include "context.hpp"
 #include "bar.hpp"
+#include "indicators.hpp"
 #include <cmath>
 #include <memory>
-#include <vector>
-#include <algorithm>
-#include <limits>
 
 namespace backtest {
 
-namespace {
-
-/// Linear regression on points (0, y[0]), (1, y[1]), ..., (n-1, y[n-1]).
-/// Returns slope and intercept; value at x is intercept + slope * x.
-void fitLine(const double* y, int n, double& slope, double& intercept) {
-    if (n < 2) {
-        slope = 0;
-        intercept = n == 1 ? y[0] : 0;
-        return;
-    }
-    double sum_x = 0, sum_y = 0, sum_xy = 0, sum_xx = 0;
-    for (int i = 0; i < n; ++i) {
-        sum_x += i;
-        sum_y += y[i];
-        sum_xy += i * y[i];
-        sum_xx += i * i;
-    }
-    double denom = n * sum_xx - sum_x * sum_x;
-    if (std::fabs(denom) < 1e-20) {
-        slope = 0;
-        intercept = sum_y / n;
-        return;
-    }
-    slope = (n * sum_xy - sum_x * sum_y) / denom;
-    intercept = (sum_y - slope * sum_x) / n;
-}
-
-} // namespace
-
 class OnePointOhStrategy : public IStrategy {
 public:
-    explicit OnePointOhStrategy(const OnePointOhParams& params) : p_(params) {}
+    explicit OnePointOhStrategy(const OnePointOhParams& params)
+        : p_(params)
+        , high_line_(window(params.lookback))
+        , low_line_(window(params.lookback))
+        , stop_low_(window(params.stop_lookback))
+        , stop_high_(window(params.stop_lookback))
+    {}
 
     void onStart(IContext& /*ctx*/) override {
+        high_line_.reset();
+        low_line_.reset();
+        stop_low_.reset();
+        stop_high_.reset();
+        has_prev_bar_ = false;
         in_position_ = false;
         entry_price_ = 0;
         stop_price_ = 0;
         target_price_ = 0;
         position_qty_ = 0;
         is_long_ = true;
+        bracket_ = BracketOrderIds{};
     }
 
     void onBar(const Bar& bar, IContext& ctx) override {
-        const std::vector<Bar>& bars = ctx.bars();
         const std::size_t i = ctx.barIndex();
         const int lookback = p_.lookback;
-        const int stop_lookback = p_.stop_lookback;
+
+        // Rolling state sees every bar, O(1) each: regression windows end at this bar; the stop
+        // windows hold the stop_lookback bars before it, so they take the previous bar's high/low.
+        high_line_.update(bar.high);
+        low_line_.update(bar.low);
+        if (has_prev_bar_) {
+            stop_low_.update(prev_low_);
+            stop_high_.update(prev_high_);
+        }
+        const double prev_close = prev_close_;
+        prev_low_ = bar.low;
+        prev_high_ = bar.high;
+        prev_close_ = bar.close;
+        has_prev_bar_ = true;
 
         if (bar.close <= 0) return;
 
-        // --- Exit logic: check stop and target (stop first, conservative) ---
+        // --- Exit logic: resting bracket is done once none of its orders is left ---
         double pos = ctx.position();
-        if (in_position_ && pos != 0) {
+        if (p_.resting_exits) {
+            if (in_position_ && !ctx.isOrderOpen(bracket_.entry) && !ctx.isOrderOpen(bracket_.stop)
+                && !ctx.isOrderOpen(bracket_.target))
+                in_position_ = false;
+        }
+        // --- Exit logic: check stop and target (stop first, conservative) ---
+        else if (in_position_ && pos != 0) {
             int qty = static_cast<int>(std::abs(pos));
             if (qty <= 0) { in_position_ = false; return; }
             if (is_long_) {
@@ -94,23 +93,13 @@ public:
         if (i < static_cast<std::size_t>(lookback)) return;
         if (i < 1u) return;
 
-        const Bar& prev_bar = bars[i - 1];
-        double prev_close = prev_bar.close;
         double curr_close = bar.close;
 
-        // Fit line to last lookback highs (x = 0..lookback-1, y = high)
-        std::vector<double> highs(static_cast<std::size_t>(lookback));
-        std::vector<double> lows(static_cast<std::size_t>(lookback));
-        for (int k = 0; k < lookback; ++k) {
-            std::size_t idx = i - lookback + 1 + static_cast<std::size_t>(k);
-            highs[static_cast<std::size_t>(k)] = bars[idx].high;
-            lows[static_cast<std::size_t>(k)] = bars[idx].low;
-        }
-
+        // Lines fitted to the last lookback highs / lows (x = 0..lookback-1)
         double slope_high = 0, intercept_high = 0;
         double slope_low = 0, intercept_low = 0;
-        fitLine(highs.data(), lookback, slope_high, intercept_high);
-        fitLine(lows.data(), lookback, slope_low, intercept_low);
+        high_line_.fit(slope_high, intercept_high);
+        low_line_.fit(slope_low, intercept_low);
 
         // Line value at previous bar (index lookback-2) and current bar (lookback-1)
         const int prev_x = lookback - 2;
@@ -123,11 +112,7 @@ public:
         // Long: descending line on highs (slope < 0), close crosses above
         if (slope_high < 0 && prev_close <= line_high_prev && curr_close > line_high_curr) {
             // Stop = nearest local low (min of lows over last stop_lookback bars before current)
-            std::size_t start = (i >= static_cast<std::size_t>(stop_lookback))
-                ? i - static_cast<std::size_t>(stop_lookback) : 0;
-            double stop = std::numeric_limits<double>::max();
-            for (std::size_t k = start; k < i; ++k)
-                if (bars[k].low < stop) stop = bars[k].low;
+            double stop = stop_low_.value();
             if (stop >= curr_close) return;  // stop must be below entry
             double entry = curr_close;
             double risk = entry - stop;
@@ -138,7 +123,7 @@ public:
             int qty = static_cast<int>((eq * p_.position_fraction) / entry);
             if (qty < 1) qty = 1;
 
-            ctx.placeOrder(Side::Long, static_cast<double>(qty));
+            enter(ctx, Side::Long, qty, stop, target);
             in_position_ = true;
             entry_price_ = entry;
             stop_price_ = stop;
@@ -150,11 +135,7 @@ public:
 
         // Short: ascending line on lows (slope > 0), close crosses below
         if (slope_low > 0 && prev_close >= line_low_prev && curr_close < line_low_curr) {
-            std::size_t start = (i >= static_cast<std::size_t>(stop_lookback))
-                ? i - static_cast<std::size_t>(stop_lookback) : 0;
-            double stop = -std::numeric_limits<double>::max();
-            for (std::size_t k = start; k < i; ++k)
-                if (bars[k].high > stop) stop = bars[k].high;
+            double stop = stop_high_.value();
             if (stop <= curr_close) return;  // stop must be above entry
             double entry = curr_close;
             double risk = stop - entry;
@@ -165,7 +146,7 @@ public:
             int qty = static_cast<int>((eq * p_.position_fraction) / entry);
             if (qty < 1) qty = 1;
 
-            ctx.placeOrder(Side::Short, static_cast<double>(qty));
+            enter(ctx, Side::Short, qty, stop, target);
             in_position_ = true;
             entry_price_ = entry;
             stop_price_ = stop;
@@ -176,6 +157,20 @@ public:
     }
 
 private:
+    static std::size_t window(int n) { return n > 0 ? static_cast<std::size_t>(n) : 1; }
+
+    // Market entry at the next open; with resting_exits its stop and target go in with it.
+    void enter(IContext& ctx, Side side, int qty, double stop, double target) {
+        if (!p_.resting_exits) {
+            ctx.placeOrder(side, static_cast<double>(qty));
+            return;
+        }
+        Order entry;
+        entry.side = side;
+        entry.quantity = static_cast<double>(qty);
+        bracket_ = ctx.submitBracket(entry, stop, target);
+    }
+
     OnePointOhParams p_;
     bool in_position_{false};
     double entry_price_{0};
@@ -183,6 +178,16 @@ private:
     double target_price_{0};
     int position_qty_{0};
     bool is_long_{true};
+    BracketOrderIds bracket_;  // resting_exits only
+
+    RollingRegression high_line_;
+    RollingRegression low_line_;
+    RollingMin stop_low_;
+    RollingMax stop_high_;
+    bool has_prev_bar_{false};
+    double prev_low_{0};
+    double prev_high_{0};
+    double prev_close_{0};
 };
 
 std::unique_ptr<IStrategy> createOnePointOhStrategy(const OnePointOhParams& params) {
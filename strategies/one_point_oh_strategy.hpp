@@ -14,6 +14,7 @@ struct OnePointOhParams {
     int stop_lookback = 20;     // bars to find nearest local high/low for stop
     double position_fraction = 0.15;  // fraction of equity per trade
     double risk_reward_ratio = 3.0;  // take profit = entry + R:R * (entry - stop) for long
+    bool resting_exits = false;  // stop + target as a resting bracket (intrabar fills) instead of checks at each close
 };
 
 std::unique_ptr<IStrategy> createOnePointOhStrategy(const OnePointOhParams& params = OnePointOhParams{});
@@ -1,104 +1,75 @@
 #include "orb_strategy.hpp"
 #include "context.hpp"
 #include "bar.hpp"
+#include "timestamp.hpp"
 #include <cmath>
+#include <cstdint>
+#include <limits>
 #include <memory>
-#include <string>
 
 namespace backtest {
 
-namespace {
-
-/// Return calendar date "YYYY-MM-DD" from bar timestamp.
-std::string barDate(const std::string& timestamp) {
-    auto t = timestamp.find('T');
-    auto s = timestamp.find(' ');
-    if (t != std::string::npos)
-        return timestamp.substr(0, t);
-    if (s != std::string::npos)
-        return timestamp.substr(0, s);
-    return timestamp.size() >= 10 ? timestamp.substr(0, 10) : "";
-}
-
-/// Parse time from timestamp; support "T09:30", "T09_30", " 09:30:00". Returns true if parsed.
-bool barTime(const std::string& timestamp, int& hour, int& minute) {
-    hour = 0;
-    minute = 0;
-    std::string timePart;
-    auto t = timestamp.find('T');
-    auto s = timestamp.find(' ');
-    if (t != std::string::npos && t + 1 < timestamp.size())
-        timePart = timestamp.substr(t + 1);
-    else if (s != std::string::npos && s + 1 < timestamp.size())
-        timePart = timestamp.substr(s + 1);
-    else
-        return false;
-    for (auto& c : timePart) if (c == '_') c = ':';
-    auto c1 = timePart.find(':');
-    if (c1 == std::string::npos || c1 < 1) return false;
-    try {
-        hour = std::stoi(timePart.substr(0, c1));
-        auto c2 = timePart.find(':', c1 + 1);
-        if (c2 != std::string::npos)
-            minute = std::stoi(timePart.substr(c1 + 1, c2 - (c1 + 1)));
-        else if (c1 + 1 < timePart.size())
-            minute = std::stoi(timePart.substr(c1 + 1));
-        return true;
-    } catch (...) {
-        return false;
-    }
-}
-
-} // namespace
-
 class OrbStrategy : public IStrategy {
 public:
     explicit OrbStrategy(const OrbParams& params) : p_(params) {}
 
     void onStart(IContext& /*ctx*/) override {
-        current_date_.clear();
+        current_day_ = NO_DAY;
         orb_bar_index_ = -1;
         orb_high_ = orb_low_ = 0;
         triggered_this_day_ = false;
         stop_price_ = 0;
+        midnight_bars_ = 0;
+        bracket_ = BracketOrderIds{};
     }
 
     void onBar(const Bar& bar, IContext& ctx) override {
-        std::string date = barDate(bar.timestamp);
-        if (date.empty()) return;
+        const std::int64_t day = bar.day();
         double pos = ctx.position();
         double price = bar.close;
         if (price <= 0) return;
 
         // New day: close any open position at EOD, then reset ORB state
-        if (date != current_date_) {
+        if (day != current_day_) {
+            if (p_.resting_exits) {  // entry not filled yet or stop still resting: drop them before the EOD exit
+                ctx.cancelOrder(bracket_.entry);
+                ctx.cancelOrder(bracket_.stop);
+                bracket_ = BracketOrderIds{};
+            }
             if (pos != 0) {  // always exit at EOD (position is day-trade only)
                 if (pos > 0)
                     ctx.placeOrder(Side::Short, static_cast<double>(static_cast<int>(pos)));
                 else
                     ctx.placeOrder(Side::Long, static_cast<double>(static_cast<int>(-pos)));
             }
-            current_date_ = date;
+            current_day_ = day;
             orb_bar_index_ = -1;  // haven't seen 9:30 bar yet this day
             orb_high_ = orb_low_ = 0;
             triggered_this_day_ = false;
             stop_price_ = 0;
+            midnight_bars_ = 0;
         }
 
-        int bar_hour = 0, bar_minute = 0;
-        bool has_time = barTime(bar.timestamp, bar_hour, bar_minute);
-
-        // Only treat a bar as the 9:30 (ORB) bar when its time matches session start (or first bar of day if no time in timestamp)
+        // Only treat a bar as the 9:30 (ORB) bar when its time matches session start
         if (orb_bar_index_ == -1) {
-            bool is_session_start = has_time
-                ? (bar_hour == p_.session_start_hour && bar_minute == p_.session_start_minute)
-                : true;  // date-only timestamp: assume first bar of day is ORB
+            bool is_session_start = bar.hour() == p_.session_start_hour && bar.minute() == p_.session_start_minute;
             if (is_session_start) {
                 orb_high_ = bar.high;
                 orb_low_ = bar.low;
                 orb_bar_index_ = 1;
+                return;
             }
-            return;
+            // Date-only timestamps (every row of the day at 00:00): the day's first bar is the ORB bar.
+            // That's only known at a second 00:00 bar the same day, which is then the trigger bar.
+            if (timeOfDay(bar.timestamp) != 0) return;
+            if (++midnight_bars_ == 1) {
+                first_high_ = bar.high;
+                first_low_ = bar.low;
+                return;
+            }
+            orb_high_ = first_high_;
+            orb_low_ = first_low_;
+            orb_bar_index_ = 1;
         }
 
         // Bar right after 9:30 = 9:45 bar (trigger bar)
@@ -107,13 +78,13 @@ public:
                 if (bar.close > orb_high_) {
                     double units = std::floor(ctx.equity() / price * p_.position_equity_pct);
                     if (units < 1.0) units = 1.0;
-                    ctx.placeOrder(Side::Long, units);
+                    enter(ctx, Side::Long, units, orb_low_);
                     stop_price_ = orb_low_;
                     triggered_this_day_ = true;
                 } else if (bar.close < orb_low_) {
                     double units = std::floor(ctx.equity() / price * p_.position_equity_pct);
                     if (units < 1.0) units = 1.0;
-                    ctx.placeOrder(Side::Short, units);
+                    enter(ctx, Side::Short, units, orb_high_);
                     stop_price_ = orb_high_;
                     triggered_this_day_ = true;
                 }
@@ -123,7 +94,7 @@ public:
         }
 
         // Bar 2+ of day: check stop loss (long stop at ORB low, short stop at ORB high)
-        if (stop_price_ != 0) {
+        if (stop_price_ != 0 && !p_.resting_exits) {
             if (pos > 0 && bar.low <= stop_price_) {
                 ctx.placeOrder(Side::Short, static_cast<double>(static_cast<int>(pos)));
                 stop_price_ = 0;
@@ -137,13 +108,31 @@ public:
     void onEnd(IContext& /*ctx*/) override {}
 
 private:
+    // Market entry at the next open; with resting_exits its stop goes in with it.
+    void enter(IContext& ctx, Side side, double units, double stop) {
+        if (!p_.resting_exits) {
+            ctx.placeOrder(side, units);
+            return;
+        }
+        Order entry;
+        entry.side = side;
+        entry.quantity = units;
+        bracket_ = ctx.submitBracket(entry, stop, 0);
+    }
+
+    static constexpr std::int64_t NO_DAY = std::numeric_limits<std::int64_t>::min();
+
     OrbParams p_;
-    std::string current_date_;
+    std::int64_t current_day_ = NO_DAY;  // Bar::day() of the session being traded
     int orb_bar_index_ = -1;
     double orb_high_ = 0;
     double orb_low_ = 0;
     bool triggered_this_day_ = false;
     double stop_price_ = 0;   // 0 = no active stop
+    int midnight_bars_ = 0;   // bars at 00:00 so far today (date-only timestamps, see onBar)
+    double first_high_ = 0;   // the day's first 00:00 bar
+    double first_low_ = 0;
+    BracketOrderIds bracket_;  // resting_exits only
 };
 
 std::unique_ptr<IStrategy> createOrbStrategy(const OrbParams& params) {
@@ -0,0 +1,82 @@
+/**
+ * Replacement global operator new / delete that count every heap allocation, for the allocation-free
+ * bar loop test. Kept in its own translation unit so the compiler never sees a replacement operator
+ * and its callers together (inlining malloc / free into std::allocator call sites trips
+ * -Wmismatched-new-delete). Every new has its matching delete: plain, array, nothrow and aligned.
+ */
+#include "alloc_counter.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> g_allocations{0};
+
+void* allocate(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+// Aligned blocks: over-allocate, align, and keep malloc's pointer just before the block (portable to
+// MSVC, which has no std::aligned_alloc).
+void* allocateAligned(std::size_t size, std::align_val_t align) {
+    const std::size_t a = static_cast<std::size_t>(align);
+    void* const raw = allocate(size + a + sizeof(void*));
+    if (!raw) return nullptr;
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+    void* const p = reinterpret_cast<void*>((start + a - 1) & ~(std::uintptr_t(a) - 1));
+    static_cast<void**>(p)[-1] = raw;
+    return p;
+}
+
+void freeAligned(void* p) {
+    if (p) std::free(static_cast<void**>(p)[-1]);
+}
+
+} // namespace
+
+namespace test {
+
+std::size_t heapAllocations() { return g_allocations.load(); }
+
+} // namespace test
+
+void* operator new(std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t align) {
+    if (void* p = allocateAligned(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    if (void* p = allocateAligned(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(p); }
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+namespace test {
+
+/// Heap allocations made by the process so far (every operator new variant; see alloc_counter.cpp).
+std::size_t heapAllocations();
+
+} // namespace test
@@ -4,12 +4,44 @@
  */
 #include "simulator.hpp"
 #include "bar.hpp"
+#include "bar_aggregator.hpp"
+#include "bar_series.hpp"
+#include "buffered_writer.hpp"
+#include "backtester.hpp"
 #include "data_source.hpp"
+#include "databento_index.hpp"
+#include "dbn_decoder.hpp"
+#include "sweep.hpp"
+#include "portfolio.hpp"
+#include "pruning.hpp"
+#include "report.hpp"
+#include "sma_lockstep.hpp"
+#include "static_backtester.hpp"
+#include "example_sma_strategy.hpp"
+#include "orb_strategy.hpp"
+#include "thread_pool.hpp"
+#include "walk_forward.hpp"
+#include "timestamp.hpp"
+#include "indicators.hpp"
+#include "indicator_cache.hpp"
+#include "monte_carlo.hpp"
+#include "alloc_counter.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <filesystem>
 #include <fstream>
+#include <stdexcept>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #define ASSERT_EQ(a, b) do { \
     auto _a = (a); auto _b = (b); \
@@ -31,11 +63,20 @@ namespace {
 
 using namespace backtest;
 
+std::int64_t ts(const char* text) {
+    std::int64_t t = 0;
+    if (!parseTimestamp(text, t)) {
+        std::cerr << "FAIL: bad test timestamp " << text << "\n";
+        std::exit(1);
+    }
+    return t;
+}
+
 //--- Simulator: one long trade, fill at next bar open, then close
 void run_simulator_long_trade() {
     Simulator sim(10000.0, 0.0);
-    Bar bar1; bar1.timestamp = "2024-01-01T10:00"; bar1.open = 100; bar1.high = 101; bar1.low = 99; bar1.close = 100.5;
-    Bar bar2; bar2.timestamp = "2024-01-01T10:15"; bar2.open = 102; bar2.high = 103; bar2.low = 101; bar2.close = 102;
+    Bar bar1; bar1.timestamp = ts("2024-01-01T10:00"); bar1.open = 100; bar1.high = 101; bar1.low = 99; bar1.close = 100.5;
+    Bar bar2; bar2.timestamp = ts("2024-01-01T10:15"); bar2.open = 102; bar2.high = 103; bar2.low = 101; bar2.close = 102;
 
     ASSERT_EQ(sim.position(), 0);
     sim.placeOrder(Side::Long, 10);
@@ -68,8 +109,8 @@ void run_simulator_commission() {
 void run_simulator_slippage() {
     const double slip = 0.01;  // 1%
     Simulator sim(10000.0, 0.0, slip);
-    Bar bar1; bar1.timestamp = "2024-01-01T10:00"; bar1.open = 100; bar1.close = 100;
-    Bar bar2; bar2.timestamp = "2024-01-01T10:15"; bar2.open = 102; bar2.close = 102;
+    Bar bar1; bar1.timestamp = ts("2024-01-01T10:00"); bar1.open = 100; bar1.close = 100;
+    Bar bar2; bar2.timestamp = ts("2024-01-01T10:15"); bar2.open = 102; bar2.close = 102;
     sim.placeOrder(Side::Long, 10);
     sim.processOrders(bar1);  // fill at 100 * 1.01 = 101
     sim.placeOrder(Side::Short, 10);
@@ -80,6 +121,144 @@ void run_simulator_slippage() {
     ASSERT_NEAR(sim.trades()[0].pnl, (100.98 - 101.0) * 10, 1e-6);  // -0.20
 }
 
+//--- Resting orders: limit / stop / stop-limit fills along the intrabar path, brackets, OCO, reduce-only
+void run_simulator_resting_orders() {
+    auto bar = [](const char* t, double o, double h, double l, double c) {
+        Bar b; b.timestamp = ts(t); b.open = o; b.high = h; b.low = l; b.close = c;
+        return b;
+    };
+    auto order = [](Side side, double qty, OrderType type, double limit, double stop) {
+        Order o; o.side = side; o.quantity = qty; o.type = type; o.limit_price = limit; o.stop_price = stop;
+        return o;
+    };
+
+    // Buy limit rests until a bar trades down to it; fills at the limit, no slippage.
+    Simulator sim(10000.0, 0.0, 0.01);
+    OrderId id = sim.submitOrder(order(Side::Long, 10, OrderType::Limit, 95, 0));
+    ASSERT_EQ(id != 0, true);
+    sim.processOrders(bar("2024-01-01T10:00", 100, 101, 96, 99));
+    ASSERT_NEAR(sim.position(), 0.0, 1e-12);
+    sim.processOrders(bar("2024-01-01T10:01", 98, 99, 94, 97));
+    ASSERT_NEAR(sim.position(), 10.0, 1e-12);
+    ASSERT_NEAR(sim.avgEntryPrice(), 95.0, 1e-12);
+    ASSERT_EQ(sim.orderBook().contains(id), false);
+    // Sell stop gapped through at the open: fills at the open, with slippage.
+    sim.submitOrder(order(Side::Short, 10, OrderType::Stop, 94, 90));
+    ASSERT_EQ(sim.submitOrder(order(Side::Short, 10, OrderType::Stop, 0, 0)), 0u);  // no stop price
+    sim.placeOrder(Side::Long, 1);  // market order at the open first, resting orders after it
+    sim.processOrders(bar("2024-01-01T10:02", 89, 92, 88, 91));
+    ASSERT_EQ(sim.trades().size(), 1u);
+    ASSERT_NEAR(sim.trades()[0].exit_price, 89 * 0.99, 1e-9);
+    ASSERT_NEAR(sim.position(), 1.0, 1e-12);
+    ASSERT_EQ(sim.orderBook().empty(), true);
+
+    // Bracket: entry at the open, then the path decides. Up bar goes open -> low -> high: target.
+    Simulator b1(10000.0);
+    Order entry = order(Side::Long, 5, OrderType::Market, 0, 0);
+    BracketOrderIds ids = b1.submitBracket(entry, 90, 110);
+    ASSERT_EQ(ids.entry != 0 && ids.stop != 0 && ids.target != 0, true);
+    b1.processOrders(bar("2024-01-01T10:00", 100, 111, 98, 105));
+    ASSERT_EQ(b1.trades().size(), 1u);
+    ASSERT_NEAR(b1.trades()[0].exit_price, 110.0, 1e-12);
+    ASSERT_NEAR(b1.position(), 0.0, 1e-12);
+    ASSERT_EQ(b1.orderBook().empty(), true);  // stop cancelled with it (OCO)
+    // Both legs inside an up bar: the low comes first, so the stop wins.
+    ids = b1.submitBracket(entry, 90, 110);
+    b1.processOrders(bar("2024-01-01T10:01", 100, 111, 89, 105));
+    ASSERT_EQ(b1.trades().size(), 2u);
+    ASSERT_NEAR(b1.trades()[1].exit_price, 90.0, 1e-12);
+    ASSERT_EQ(b1.orderBook().empty(), true);
+    // Cancelling the entry takes its legs with it; cancelling twice fails.
+    ids = b1.submitBracket(entry, 90, 110);
+    ASSERT_EQ(b1.orderBook().size(), 3u);
+    ASSERT_EQ(b1.cancelOrder(ids.entry), true);
+    ASSERT_EQ(b1.cancelOrder(ids.entry), false);
+    ASSERT_EQ(b1.orderBook().empty(), true);
+
+    // Reduce-only while flat is dropped; stop-limit arms at its stop and fills as a limit.
+    Simulator b2(10000.0);
+    Order reduce = order(Side::Short, 3, OrderType::Limit, 100, 0);
+    reduce.reduce_only = true;
+    b2.submitOrder(reduce);
+    b2.submitOrder(order(Side::Long, 2, OrderType::StopLimit, 106, 105));
+    b2.processOrders(bar("2024-01-01T10:00", 100, 110, 99, 108));
+    ASSERT_EQ(b2.trades().size(), 0u);
+    ASSERT_NEAR(b2.position(), 2.0, 1e-12);
+    ASSERT_NEAR(b2.avgEntryPrice(), 105.0, 1e-12);
+    ASSERT_EQ(b2.orderBook().empty(), true);
+}
+
+//--- Intrabar fills: resting orders follow the 1m bars inside an aggregated bar, not its OHLC
+void run_intrabar_fills() {
+    BarSeries fine;
+    auto add = [&](const char* t, double o, double h, double l, double c) {
+        Bar b; b.timestamp = ts(t); b.open = o; b.high = h; b.low = l; b.close = c; b.volume = 1;
+        fine.push_back(b);
+    };
+    add("2024-01-01T10:00", 100, 100, 95, 96);   // the low comes first...
+    add("2024-01-01T10:01", 96, 104, 96, 97);    // ...then the high
+    add("2024-01-01T10:15", 97, 98, 97, 98);
+    add("2024-01-01T10:02", 97, 97, 97, 97);     // out of order on purpose
+
+    BarResolution res;
+    ASSERT_EQ(parseBarResolution("15m", res), true);
+    BarSeries coarse = fine;
+    IntrabarSeries intrabar;
+    aggregateInPlace(coarse, res, intrabar);
+    ASSERT_EQ(coarse.size(), 2u);
+    ASSERT_EQ(intrabar.coarseSize(), 2u);
+    ASSERT_EQ(intrabar.of(0).size(), 3u);
+    ASSERT_EQ(intrabar.of(1).size(), 1u);
+    ASSERT_EQ(intrabar.of(0)[2].timestamp, ts("2024-01-01T10:02"));
+    ASSERT_NEAR(coarse[0].high, 104.0, 1e-12);
+    ASSERT_NEAR(coarse[0].low, 95.0, 1e-12);
+
+    // Down bar (close < open): on its own OHLC the high (target) comes before the low (stop).
+    Order entry; entry.side = Side::Long; entry.quantity = 1;
+    Simulator own(10000.0), inner(10000.0);
+    own.submitBracket(entry, 96.5, 103.5);
+    inner.submitBracket(entry, 96.5, 103.5);
+    own.processOrders(coarse[0]);
+    inner.processOrders(coarse[0], intrabar.of(0));
+    ASSERT_NEAR(own.trades()[0].exit_price, 103.5, 1e-12);
+    ASSERT_NEAR(inner.trades()[0].exit_price, 96.5, 1e-12);
+    ASSERT_EQ(inner.trades()[0].exit_time, coarse[0].timestamp);
+
+    // Nothing to aggregate at the base resolution: no intrabar bars kept.
+    DataSource ds("");
+    ds.assign(fine);
+    ASSERT_EQ(ds.aggregateBars("1m", &intrabar), true);
+    ASSERT_EQ(intrabar.empty(), true);
+    ASSERT_EQ(ds.aggregateBars("15m", &intrabar), true);
+    ASSERT_EQ(intrabar.coarseSize(), ds.size());
+}
+
+//--- BarSeries: SoA columns are 64-byte aligned; views/slices see the same bars
+void run_bar_series_columns() {
+    BarSeries s;
+    for (int i = 0; i < 10; ++i) {
+        Bar b;
+        b.timestamp = i * NS_PER_MINUTE;
+        b.open = 100 + i; b.high = 101 + i; b.low = 99 + i; b.close = 100.5 + i; b.volume = i;
+        s.push_back(b);
+    }
+    ASSERT_EQ(s.size(), 10u);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(s.closes().data()) % 64, 0u);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(s.times().data()) % 64, 0u);
+    ASSERT_NEAR(s[3].close, 103.5, 1e-12);
+
+    BarSeriesView v = s.view(2, 7);
+    ASSERT_EQ(v.size(), 5u);
+    ASSERT_EQ(v[0].timestamp, 2 * NS_PER_MINUTE);
+    ASSERT_NEAR(v.closes()[4], 106.5, 1e-12);
+    BarSeriesView w = v.slice(1, 3);
+    ASSERT_EQ(w.size(), 2u);
+    ASSERT_NEAR(w.back().high, 105, 1e-12);
+    double sum = 0;
+    for (const Bar& b : w) sum += b.open;
+    ASSERT_NEAR(sum, 103 + 104, 1e-12);
+}
+
 //--- DataSource: load from CSV string (temp file)
 void run_data_source_csv_load() {
     std::string csv = "timestamp,open,high,low,close\n"
@@ -99,6 +278,1392 @@ void run_data_source_csv_load() {
     std::remove(path.c_str());
 }
 
+//--- DataSource: mapped loader matches the stream loader (CRLF, BOM, blank/bad rows, column order)
+void run_data_source_mapped_matches_stream() {
+    std::string csv = "\xEF\xBB\xBF" "Close,Volume,Date,Open,High,Low\r\n"
+                      "100.5,100,2024-01-01T09:30,100,101,99\r\n"
+                      "\r\n"
+                      "bad,1,2024-01-01T09:31,100,101,99\r\n"
+                      " 101 ,200, 2024-01-01T09:32 ,+100.5,102,100\r\n"
+                      "102,,2024-01-01T09:33,101,103,100.5\r\n"
+                      "101.5,50,2024-01-01T09:34,102,102.5,101";
+    std::string path = "test_mapped_ohlc.csv";
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << csv;
+    }
+    DataSource mapped(path);
+    ASSERT_EQ(mapped.load(CsvLoadMode::Mapped), true);
+    ASSERT_EQ(mapped.size(), 3u);
+    ASSERT_EQ(mapped.at(1).timestamp, ts("2024-01-01T09:32"));
+    ASSERT_NEAR(mapped.at(1).open, 100.5, 1e-12);
+    ASSERT_NEAR(mapped.at(2).volume, 50, 1e-12);
+
+    // Stream path does not strip the BOM, so compare it on the file without one.
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << csv.substr(3);
+    }
+    DataSource stream(path);
+    ASSERT_EQ(stream.load(CsvLoadMode::Stream), true);
+    ASSERT_EQ(stream.size(), mapped.size());
+    for (std::size_t i = 0; i < stream.size(); ++i) {
+        ASSERT_EQ(stream.at(i).timestamp, mapped.at(i).timestamp);
+        ASSERT_EQ(stream.at(i).open, mapped.at(i).open);
+        ASSERT_EQ(stream.at(i).high, mapped.at(i).high);
+        ASSERT_EQ(stream.at(i).low, mapped.at(i).low);
+        ASSERT_EQ(stream.at(i).close, mapped.at(i).close);
+        ASSERT_EQ(stream.at(i).volume, mapped.at(i).volume);
+    }
+    std::remove(path.c_str());
+}
+
+//--- Timestamp: parse/format round trip across the accepted spellings
+void run_timestamp_parse_format() {
+    std::int64_t t = 0;
+    ASSERT_EQ(parseTimestamp("1970-01-01", t), true);
+    ASSERT_EQ(t, 0);
+    ASSERT_EQ(parseTimestamp("2025-08-04T00_00_00.000000000Z", t), true);
+    ASSERT_EQ(formatTimestamp(t), std::string("2025-08-04 00:00:00Z"));
+    ASSERT_EQ(parseTimestamp("2024-02-29 13:45:07", t), true);
+    ASSERT_EQ(formatTimestamp(t), std::string("2024-02-29 13:45:07Z"));
+    std::int64_t back = 0;
+    ASSERT_EQ(parseTimestamp(formatTimestamp(t), back), true);
+    ASSERT_EQ(back, t);
+    ASSERT_EQ(parseTimestamp("2024-01-02T09:30:00.5", t), true);
+    ASSERT_EQ(formatTimestamp(t), std::string("2024-01-02 09:30:00.500000000Z"));
+    ASSERT_EQ(parseTimestamp("not a time", t), false);
+    ASSERT_EQ(parseTimestamp("2024-01-02T9:30", t), false);
+
+    ASSERT_EQ(dayOf(ts("2024-03-01T23:59")), dayOf(ts("2024-03-01T00:00")));
+    ASSERT_EQ(hourOf(ts("2024-03-01T14:30")), 14);
+    ASSERT_EQ(minuteOf(ts("2024-03-01T14:30")), 30);
+    ASSERT_EQ(dayOf(-1), -1);
+    ASSERT_EQ(hourOf(-1), 23);
+}
+
+//--- ORB: with date-only rows the day's first row is the opening range; a 00:00 intraday bar is not
+void run_orb_date_only_rows() {
+    auto runOrb = [](const std::string& csv) {
+        const std::string path = "test_orb_rows.csv";
+        {
+            std::ofstream f(path);
+            f << "timestamp,open,high,low,close\n" << csv;
+        }
+        DataSource ds(path);
+        ASSERT_EQ(ds.load(), true);
+        std::remove(path.c_str());
+        OrbParams params;  // session start 9:30
+        Backtester bt(createOrbStrategy(params), std::make_shared<const BarSeries>(ds.bars()), 100000.0);
+        ASSERT_EQ(bt.run(), true);
+        return bt.simulator().trades();
+    };
+
+    // Range 99-101, the second row closes above it: long at the third row's open, out at the next day's
+    std::vector<Trade> trades = runOrb("2024-01-02,100,101,99,100\n"
+                                       "2024-01-02,100,103,100,102.5\n"
+                                       "2024-01-02,102,104,101.5,103\n"
+                                       "2024-01-03,103,104,102,103.5\n"
+                                       "2024-01-03,103.5,104,103,103.5\n");
+    ASSERT_EQ(trades.size(), 1u);
+    ASSERT_EQ(trades[0].side == Side::Long, true);
+    ASSERT_NEAR(trades[0].entry_price, 102.0, 1e-9);
+    ASSERT_NEAR(trades[0].exit_price, 103.5, 1e-9);
+
+    // Same prices as 1m bars from midnight: no 9:30 bar, no trade
+    trades = runOrb("2024-01-02T00:00,100,101,99,100\n"
+                    "2024-01-02T00:01,100,103,100,102.5\n"
+                    "2024-01-02T00:02,102,104,101.5,103\n");
+    ASSERT_EQ(trades.empty(), true);
+}
+
+//--- BufferedWriter: to_chars text equals iostream std::fixed, across buffer flushes
+void run_buffered_writer() {
+    const std::string path = "test_buffered_writer.txt";
+    const double values[] = { 0.0, -0.0, 1.005, 2.675, -0.001, 0.125, 0.375, 123456789.98765, -42.5, 1e20, -3.14159e-7 };
+    std::ostringstream want;
+    want << std::fixed;
+    BufferedWriter w(4096);  // small buffer: the loop below flushes many times
+    ASSERT_EQ(w.open(path), true);
+    for (int rep = 0; rep < 400; ++rep) {
+        for (double v : values) {
+            for (int prec : { 0, 2, 4 }) {
+                want << std::setprecision(prec) << v << ',';
+                w.fixed(v, prec);
+                w.put(',');
+            }
+        }
+        want << rep << ',' << static_cast<std::size_t>(rep) * 1000003u << '\n';
+        w.integer(static_cast<std::int64_t>(rep));
+        w.put(',');
+        w.integer(static_cast<std::uint64_t>(rep) * 1000003u);
+        w.put('\n');
+    }
+    const std::string big(10000, 'x');  // longer than the buffer: written through
+    want << big << formatTimestamp(ts("2024-03-05T09:31:07")) << "\"a\"\"b\"" << "\"q\\\"\\\\\\n\\r.\"";
+    w.write(big);
+    w.timestamp(ts("2024-03-05T09:31:07"));
+    w.csvQuoted("a\"b");
+    w.jsonString("q\"\\\n\r.");
+    ASSERT_EQ(w.close(), true);
+
+    std::ifstream f(path, std::ios::binary);
+    std::string got((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    std::filesystem::remove(path);
+    ASSERT_EQ(got.size(), want.str().size());
+    ASSERT_EQ(got == want.str(), true);
+
+    BufferedWriter bad;
+    ASSERT_EQ(bad.open("no_such_dir/x/y.txt"), false);
+    ASSERT_EQ(bad.ok(), false);
+}
+
+//--- LOD pyramid: coarser levels keep every span's high / low; session.lod's index and chunks are at their offsets
+void run_session_lod() {
+    BarSeries bars;
+    const std::int64_t t0 = ts("2024-01-01T00:00:00");
+    double px = 100.0;
+    for (std::size_t i = 0; i < 30000; ++i) {
+        px += (i * 2654435761u % 7 < 3) ? 0.5 : -0.25;
+        Bar b;
+        b.timestamp = t0 + static_cast<std::int64_t>(i) * NS_PER_MINUTE;
+        b.open = px;
+        b.high = px + 1.0 + static_cast<double>(i % 13);
+        b.low = px - 1.0 - static_cast<double>(i % 11);
+        b.close = px + 0.25;
+        b.volume = 1;
+        bars.push_back(b);
+    }
+
+    const LodPyramid pyramid = buildLodPyramid(bars, 4096);
+    ASSERT_EQ(pyramid.base_period_ns, NS_PER_MINUTE);
+    ASSERT_EQ(pyramid.levels.size() >= 2, true);
+    ASSERT_EQ(pyramid.levels.front().period_ns, 5 * NS_PER_MINUTE);
+    ASSERT_EQ(pyramid.levels.back().bars.size() <= 4096, true);
+    for (const auto& level : pyramid.levels) {
+        BarResolution res{ level.period_ns, level.period_ns == 7 * NS_PER_DAY ? 4 * NS_PER_DAY : 0 };
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            if (res.bucketStart(bars.times()[i]) != level.bars.times()[k]) ++k;
+            ASSERT_EQ(level.bars.times()[k], res.bucketStart(bars.times()[i]));
+            ASSERT_EQ(level.bars.highs()[k] >= bars.highs()[i], true);
+            ASSERT_EQ(level.bars.lows()[k] <= bars.lows()[i], true);
+        }
+        ASSERT_EQ(k + 1, level.bars.size());
+    }
+    BarSeries short_bars;
+    for (std::size_t i = 0; i < 100; ++i) short_bars.push_back(bars[i]);
+    ASSERT_EQ(buildLodPyramid(short_bars, 4096).levels.size(), 0u);  // fits the top level as is
+
+    Simulator sim(100000.0);
+    const std::string path = "test_session.lod";
+    Report report(sim, bars, 100000.0, "test", "fast=1");
+    ASSERT_EQ(report.writeSessionLod(path, "SYM"), true);
+    std::ifstream f(path, std::ios::binary);
+    std::string got((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(got.size() > 32, true);
+    const std::string trailer = got.substr(got.size() - 32);
+    ASSERT_EQ(trailer.compare(0, 10, "LOD-INDEX "), 0);
+    ASSERT_EQ(trailer.back(), '\n');
+    const std::size_t index_offset = static_cast<std::size_t>(std::stoull(trailer.substr(10)));
+    ASSERT_EQ(got.compare(index_offset, 15, "{\"symbol\":\"SYM\""), 0);
+    // The first chunk of the first level: bar 0 at [offset, offset + length)
+    const std::size_t chunks = got.find("\"chunks\":[[", index_offset);
+    ASSERT_EQ(chunks != std::string::npos, true);
+    std::istringstream entry(got.substr(chunks + 11));
+    std::int64_t first_s = 0, last_s = 0;
+    std::size_t offset = 0, length = 0;
+    char comma = 0;
+    entry >> first_s >> comma >> last_s >> comma >> offset >> comma >> length;
+    ASSERT_EQ(first_s, t0 / NS_PER_SECOND);
+    ASSERT_EQ(last_s, t0 / NS_PER_SECOND + 4095 * 60);
+    ASSERT_EQ(got.substr(offset, 2), std::string("[["));
+    ASSERT_EQ(got.substr(offset + length - 2, 3), std::string("]]\n"));
+}
+
+//--- session.bin: header counts and strings, then 64-byte-aligned columns holding the bars, trades and curve
+void run_session_binary() {
+    auto series = std::make_shared<BarSeries>();
+    double px = 100.0;
+    for (int i = 0; i < 500; ++i) {
+        px += (i % 17 < 8) ? 0.75 : -0.5;
+        Bar b;
+        b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * NS_PER_MINUTE;
+        b.open = px;
+        b.high = px + 1.0;
+        b.low = px - 1.0;
+        b.close = px + 0.25;
+        b.volume = i;
+        series->push_back(b);
+    }
+    Backtester bt(createSmaCrossoverStrategy(3, 9, 1e-6), std::shared_ptr<const BarSeries>(series), 10000.0);
+    ASSERT_EQ(bt.run(), true);
+    const auto& trades = bt.simulator().trades();
+    const auto& curve = bt.simulator().equityCurve();
+    ASSERT_EQ(trades.size() > 2, true);
+
+    const std::string path = "test_session.bin";
+    Report report(bt.simulator(), bt.bars(), 10000.0, "sma_crossover", "fast=3 slow=9");
+    ASSERT_EQ(report.writeSessionBinary(path, "SYM"), true);
+    std::ifstream f(path, std::ios::binary);
+    std::string got((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    std::filesystem::remove(path);
+
+    auto u32 = [&](std::size_t at) { std::uint32_t v; std::memcpy(&v, got.data() + at, sizeof(v)); return v; };
+    auto u64 = [&](std::size_t at) { std::uint64_t v; std::memcpy(&v, got.data() + at, sizeof(v)); return v; };
+    auto f64 = [&](std::size_t at) { double v; std::memcpy(&v, got.data() + at, sizeof(v)); return v; };
+    auto stride = [](std::size_t n) { return (n * 8 + 63) / 64 * 64; };
+    ASSERT_EQ(got.compare(0, 6, "BTSESS"), 0);
+    ASSERT_EQ(u32(8), 1u);
+    ASSERT_EQ(u32(12), 0x01020304u);
+    ASSERT_EQ(u64(16), series->size());
+    ASSERT_EQ(u64(24), trades.size());
+    ASSERT_EQ(u64(32), curve.size());
+    ASSERT_EQ(got.substr(64, u32(40) + u32(44) + u32(48)), std::string("SYMsma_crossoverfast=3 slow=9"));
+    const std::size_t bars_at = static_cast<std::size_t>(u64(56));
+    ASSERT_EQ(bars_at % 64, 0u);
+
+    const std::size_t n = series->size(), m = trades.size();
+    ASSERT_EQ(u64(bars_at + 7 * 8), static_cast<std::uint64_t>(series->times()[7]));
+    ASSERT_NEAR(f64(bars_at + 2 * stride(n) + 9 * 8), series->highs()[9], 0.0);  // high column
+    ASSERT_NEAR(f64(bars_at + 5 * stride(n) + 11 * 8), 11.0, 0.0);               // volume column
+    const std::size_t trades_at = bars_at + 6 * stride(n);
+    ASSERT_EQ(u64(trades_at + 8), static_cast<std::uint64_t>(trades[1].entry_time));
+    ASSERT_EQ(u64(trades_at + stride(m) + 8), static_cast<std::uint64_t>(trades[1].exit_time));
+    ASSERT_EQ(static_cast<std::int64_t>(u64(trades_at + 2 * stride(m) + 8)), trades[1].side == Side::Long ? 1 : -1);
+    ASSERT_NEAR(f64(trades_at + 6 * stride(m) + 8), trades[1].pnl, 0.0);
+    const std::size_t equity_at = trades_at + 7 * stride(m);
+    ASSERT_NEAR(f64(equity_at + (curve.size() - 1) * 8), curve.back(), 0.0);
+    ASSERT_EQ(got.size(), equity_at + stride(curve.size()));
+}
+
+//--- DataSource: CSV load writes a .btc cache, the next load reads it, a source change invalidates it
+void run_data_source_csv_cache() {
+    std::string path = "test_cache_ohlc.csv";
+    std::string cache = path + ".btc";
+    {
+        std::ofstream f(path);
+        f << "timestamp,open,high,low,close,volume\n"
+             "2024-01-01T09:30:00,100,101,99,100.5,10\n"
+             "2024-01-01T09:31,100.5,102,100,101,20\n";
+    }
+    DataSource first(path);
+    first.setUseCache(true);
+    ASSERT_EQ(first.load(), true);
+    ASSERT_EQ(first.loadedFromCache(), false);
+    ASSERT_EQ(std::filesystem::exists(cache), true);
+
+    DataSource second(path);
+    second.setUseCache(true);
+    ASSERT_EQ(second.load(), true);
+    ASSERT_EQ(second.loadedFromCache(), true);
+    ASSERT_EQ(second.size(), first.size());
+    for (std::size_t i = 0; i < first.size(); ++i) {
+        ASSERT_EQ(second.at(i).timestamp, first.at(i).timestamp);
+        ASSERT_EQ(second.at(i).high, first.at(i).high);
+        ASSERT_EQ(second.at(i).volume, first.at(i).volume);
+    }
+    ASSERT_EQ(second.at(0).timestamp, ts("2024-01-01T09:30"));
+
+    {
+        std::ofstream f(path, std::ios::app);
+        f << "2024-01-01T09:32,101,103,100.5,102,30\n";
+    }
+    DataSource third(path);
+    third.setUseCache(true);
+    ASSERT_EQ(third.load(), true);
+    ASSERT_EQ(third.loadedFromCache(), false);
+    ASSERT_EQ(third.size(), 3u);
+    std::remove(path.c_str());
+    std::remove(cache.c_str());
+}
+
+//--- DataSource: Databento dir cache holds every symbol; later loads for any symbol hit it
+void run_data_source_databento_cache() {
+    namespace fs = std::filesystem;
+    fs::path dir = "test_databento_dir";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const char* names[] = {
+        "2025-08-04T00_01_00.000000000Z,33,1,1,101,102,100,101.5,20,NQU5",
+        "2025-08-04T00_00_00.000000000Z,33,1,1,100,101,99,100.5,10,NQU5",
+        "2025-08-04T00_00_00.000000000Z,33,1,2,50,51,49,50.5,5,ESU5",
+    };
+    for (const char* n : names) std::ofstream(dir / n).flush();
+
+    DataSource nq("");
+    nq.setUseCache(true);
+    ASSERT_EQ(nq.loadFromDatabentoDir(dir.string(), "nqu5"), true);
+    ASSERT_EQ(nq.loadedFromCache(), false);
+    ASSERT_EQ(nq.size(), 2u);
+    ASSERT_EQ(nq.at(0).timestamp, ts("2025-08-04T00:00"));
+    ASSERT_NEAR(nq.at(1).close, 101.5, 1e-12);
+
+    DataSource es("");
+    es.setUseCache(true);
+    ASSERT_EQ(es.loadFromDatabentoDir(dir.string(), "ESU5"), true);
+    ASSERT_EQ(es.loadedFromCache(), true);
+    ASSERT_EQ(es.size(), 1u);
+    ASSERT_NEAR(es.at(0).open, 50, 1e-12);
+
+    DataSource uncached("");
+    ASSERT_EQ(uncached.loadFromDatabentoDir(dir.string(), "NQU5"), true);
+    ASSERT_EQ(uncached.size(), 2u);
+    ASSERT_EQ(uncached.at(1).timestamp, nq.at(1).timestamp);
+
+    fs::remove_all(dir);
+    fs::remove(dir.string() + ".btc");
+}
+
+//--- DatabentoIndex: one scan partitions every symbol; select() serves each from memory
+void run_databento_index_scan() {
+    namespace fs = std::filesystem;
+    fs::path dir = "test_databento_index";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const char* names[] = {
+        "2025-08-04T00_02_00.000000000Z,33,1,1,102,103,101,102.5,30,NQU5",
+        "2025-08-04T00_00_00.000000000Z,33,1,1,100,101,99,100.5,10,NQU5",
+        "2025-08-04T00_01_00.000000000Z,33,1,2,51,52,50,51.5,6,ESU5",
+        "2025-08-04T00_00_00.000000000Z,33,1,2,50,51,49,50.5,5,ESU5",
+        "not,a,bar",
+    };
+    for (const char* n : names) std::ofstream(dir / n).flush();
+
+    ThreadPool pool(2);
+    DatabentoIndex index;
+    ASSERT_EQ(index.build(dir.string(), false, &pool), true);
+    ASSERT_EQ(index.symbols().size(), 2u);
+    ASSERT_EQ(index.symbolNames()[0], std::string("esu5"));
+    ASSERT_EQ(index.symbolNames()[1], std::string("nqu5"));
+    ASSERT_EQ(index.bars().size(), 4u);
+
+    BarSeries nq;
+    ASSERT_EQ(index.select("NQU5", nq), true);
+    ASSERT_EQ(nq.size(), 2u);
+    ASSERT_EQ(nq[0].timestamp, ts("2025-08-04T00:00"));
+    ASSERT_NEAR(nq[1].close, 102.5, 1e-12);
+
+    BarSeries all;
+    ASSERT_EQ(index.select("", all), true);
+    ASSERT_EQ(all.size(), 4u);
+    ASSERT_NEAR(all[0].open, 50, 1e-12);   // 00:00 ties keep symbol order
+    ASSERT_NEAR(all[1].open, 100, 1e-12);
+    ASSERT_NEAR(all[2].open, 51, 1e-12);
+    ASSERT_NEAR(all[3].open, 102, 1e-12);
+
+    BarSeries none;
+    ASSERT_EQ(index.select("CLU5", none), false);
+    ASSERT_EQ(none.size(), 0u);
+
+    Bar b;
+    std::string_view sym;
+    ASSERT_EQ(DatabentoIndex::parseFilename("2025-08-04T00_00_00Z,1,1,1,+1.5, 2,1,1.75,7, GCZ5 ", b, sym), true);
+    ASSERT_NEAR(b.open, 1.5, 1e-12);
+    ASSERT_NEAR(b.high, 2, 1e-12);
+    ASSERT_EQ(std::string(sym), std::string("GCZ5"));
+    ASSERT_EQ(DatabentoIndex::parseFilename("2025-08-04T00_00_00Z,1,1,1,x,2,1,1,7,GCZ5", b, sym), false);
+    fs::remove_all(dir);
+}
+
+//--- ThreadPool: parallelFor covers every index once and rethrows worker exceptions
+void run_thread_pool_parallel_for() {
+    ThreadPool pool(3);
+    std::vector<int> hits(1000, 0);
+    pool.parallelFor(hits.size(), [&](std::size_t i) { hits[i] += 1; });
+    for (int h : hits) ASSERT_EQ(h, 1);
+
+    auto f = pool.submit([]() { return 42; });
+    ASSERT_EQ(f.get(), 42);
+
+    bool thrown = false;
+    try {
+        pool.parallelFor(10, [](std::size_t i) { if (i == 7) throw std::runtime_error("boom"); });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    ASSERT_EQ(thrown, true);
+
+    // Nested use from a pool task must not deadlock.
+    std::atomic<int> inner{0};
+    pool.parallelFor(4, [&](std::size_t) {
+        pool.parallelFor(8, [&](std::size_t) { ++inner; });
+    });
+    ASSERT_EQ(inner.load(), 32);
+}
+
+//--- DBN: synthetic stream with two instruments, one mapped symbol, a non-OHLCV record and an undefined bar
+void putLe(std::string& out, std::uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+void putCstr(std::string& out, const std::string& s, std::size_t width) {
+    std::string f = s;
+    f.resize(width, '\0');
+    out += f;
+}
+void putOhlcv(std::string& out, std::uint32_t id, std::int64_t t, std::int64_t o, std::int64_t h,
+              std::int64_t l, std::int64_t c, std::uint64_t v) {
+    putLe(out, dbn::OHLCV_SIZE / 4, 1);
+    putLe(out, dbn::RTYPE_OHLCV_1M, 1);
+    putLe(out, 1, 2);  // publisher
+    putLe(out, id, 4);
+    putLe(out, static_cast<std::uint64_t>(t), 8);
+    for (std::int64_t px : { o, h, l, c }) putLe(out, static_cast<std::uint64_t>(px), 8);
+    putLe(out, v, 8);
+}
+std::string makeDbn(int version) {
+    const std::size_t w = version == 1 ? 22 : 71;
+    std::string m;
+    putCstr(m, "GLBX.MDP3", 16);
+    putLe(m, 6, 2);  // schema ohlcv-1m
+    putLe(m, static_cast<std::uint64_t>(ts("2025-08-04T00:00")), 8);
+    putLe(m, static_cast<std::uint64_t>(ts("2025-08-05T00:00")), 8);
+    putLe(m, 0, 8);                     // limit
+    if (version == 1) putLe(m, 0, 8);   // record_count
+    putLe(m, 1, 1);                     // stype_in raw_symbol
+    putLe(m, dbn::STYPE_INSTRUMENT_ID, 1);
+    putLe(m, 0, 1);                     // ts_out
+    if (version != 1) putLe(m, w, 2);
+    m.resize(100, '\0');
+    putLe(m, 0, 4);                     // schema definition
+    putLe(m, 1, 4); putCstr(m, "NQU5", w);
+    putLe(m, 0, 4);                     // partial
+    putLe(m, 0, 4);                     // not_found
+    putLe(m, 1, 4);                     // mappings
+    putCstr(m, "NQU5", w);
+    putLe(m, 1, 4);
+    putLe(m, 20250801, 4); putLe(m, 20250901, 4); putCstr(m, "42", w);
+
+    std::string out = "DBN";
+    out += static_cast<char>(version);
+    putLe(out, m.size(), 4);
+    out += m;
+    const std::int64_t S = 1000000000;  // fixed-point 1.0
+    putOhlcv(out, 42, ts("2025-08-04T00:01"), 20001 * S + S / 4, 20002 * S, 20000 * S, 20001 * S + S / 2, 7);
+    putOhlcv(out, 7, ts("2025-08-04T00:00"), 50 * S, 51 * S, 49 * S, 50 * S + S / 2, 3);
+    std::string other(48, '\0');  // unrelated record type (skipped)
+    other[0] = 12;
+    other[1] = 0x01;
+    out += other;
+    putOhlcv(out, 42, ts("2025-08-04T00:02"), dbn::UNDEF_PRICE, 0, 0, 0, 0);
+    putOhlcv(out, 42, ts("2025-08-04T00:00"), 20000 * S, 20001 * S, 19999 * S, 20001 * S + S / 4, 5);
+    return out;
+}
+
+void run_dbn_decoder() {
+    for (int version : { 1, 2, 3 }) {
+        const std::string buf = makeDbn(version);
+        DbnDecoder dec;
+        ASSERT_EQ(dec.openBuffer(buf.data(), buf.size()), true);
+        ASSERT_EQ(static_cast<int>(dec.metadata().version), version);
+        ASSERT_EQ(dec.metadata().dataset, std::string("GLBX.MDP3"));
+        ASSERT_EQ(dec.metadata().symbols.size(), 1u);
+        ASSERT_EQ(dec.metadata().mappings.size(), 1u);
+
+        DbnOhlcv r;
+        ASSERT_EQ(dec.next(r), true);
+        ASSERT_EQ(r.instrument_id, 42u);
+        ASSERT_EQ(r.ts_event, ts("2025-08-04T00:01"));
+        ASSERT_EQ(r.open, 20001.25);   // exact: fixed point / 1e9 rounds correctly
+        ASSERT_EQ(r.close, 20001.5);
+        ASSERT_NEAR(r.volume, 7, 1e-12);
+        ASSERT_EQ(std::string(dec.symbolFor(r.instrument_id, r.ts_event)), std::string("NQU5"));
+        ASSERT_EQ(dec.next(r), true);
+        ASSERT_EQ(r.instrument_id, 7u);
+        ASSERT_EQ(dec.symbolFor(7, r.ts_event).empty(), true);
+        ASSERT_EQ(dec.next(r), true);  // skips the foreign record and the undefined bar
+        ASSERT_EQ(r.ts_event, ts("2025-08-04T00:00"));
+        ASSERT_EQ(dec.next(r), false);
+        ASSERT_EQ(dec.error().empty(), true);
+    }
+
+    std::string truncated = makeDbn(2);
+    truncated.resize(truncated.size() - 10);
+    DbnDecoder dec;
+    ASSERT_EQ(dec.openBuffer(truncated.data(), truncated.size()), true);
+    DbnOhlcv r;
+    while (dec.next(r)) {}
+    ASSERT_EQ(dec.error().empty(), false);
+    ASSERT_EQ(dec.openBuffer("CSV,", 4), false);
+
+    // Through DataSource: symbol filter by mapped name, unmapped instruments keyed by id.
+    const std::string path = "test_ohlcv.dbn";
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << makeDbn(2);
+    }
+    ASSERT_EQ(DataSource::isDbnPath(path), true);
+    ASSERT_EQ(DataSource::isDbnPath("x.DBN.ZST"), true);
+    ASSERT_EQ(DataSource::isDbnPath("x.csv"), false);
+    DataSource ds(path);
+    ASSERT_EQ(ds.loadFromDbn("nqu5"), true);
+    ASSERT_EQ(ds.size(), 2u);
+    ASSERT_EQ(ds.at(0).timestamp, ts("2025-08-04T00:00"));
+    ASSERT_EQ(ds.at(1).close, 20001.5);
+    DatabentoIndex index;
+    ASSERT_EQ(index.buildFromDbn(path), true);
+    ASSERT_EQ(index.symbolNames().size(), 2u);
+    ASSERT_EQ(index.symbolNames()[0], std::string("7"));
+    ASSERT_EQ(index.symbolNames()[1], std::string("nqu5"));
+    std::remove(path.c_str());
+}
+
+//--- Indicators: streaming updates agree with naive window recomputation
+void run_indicators_match_naive() {
+    std::vector<double> px;
+    double p = 100.0;
+    for (int i = 0; i < 500; ++i) {
+        p += ((i * 7919) % 13 < 6) ? 0.25 : -0.25;
+        if (i % 37 == 0) p += 3.0;
+        px.push_back(p);
+    }
+    for (std::size_t period : { 1u, 2u, 7u, 50u }) {
+        Sma sma(period);
+        RollingVariance var(period);
+        RollingMin mn(period);
+        RollingMax mx(period);
+        RollingRegression reg(period);
+        for (std::size_t i = 0; i < px.size(); ++i) {
+            sma.update(px[i]);
+            var.update(px[i]);
+            mn.update(px[i]);
+            mx.update(px[i]);
+            reg.update(px[i]);
+
+            const std::size_t n = std::min(i + 1, period);
+            const std::size_t b = i + 1 - n;
+            double sum = 0, lo = px[b], hi = px[b];
+            for (std::size_t k = b; k <= i; ++k) {
+                sum += px[k];
+                lo = std::min(lo, px[k]);
+                hi = std::max(hi, px[k]);
+            }
+            const double mean = sum / static_cast<double>(n);
+            double m2 = 0, sxy = 0, sx = 0, sxx = 0;
+            for (std::size_t k = b; k <= i; ++k) {
+                m2 += (px[k] - mean) * (px[k] - mean);
+                const double x = static_cast<double>(k - b);
+                sx += x;
+                sxx += x * x;
+                sxy += x * px[k];
+            }
+            ASSERT_EQ(sma.ready(), n == period);
+            ASSERT_NEAR(sma.value(), n == period ? mean : 0.0, 1e-9);
+            ASSERT_NEAR(var.mean(), mean, 1e-9);
+            ASSERT_NEAR(var.variance(), m2 / static_cast<double>(n), 1e-7);
+            ASSERT_EQ(mn.value(), lo);
+            ASSERT_EQ(mx.value(), hi);
+            if (n >= 2) {
+                const double dn = static_cast<double>(n);
+                const double slope = (dn * sxy - sx * sum) / (dn * sxx - sx * sx);
+                double s, icpt;
+                reg.fit(s, icpt);
+                ASSERT_NEAR(s, slope, 1e-9);
+                ASSERT_NEAR(icpt, (sum - slope * sx) / dn, 1e-7);
+            }
+        }
+    }
+
+    Ema ema(3);
+    ema.update(1);
+    ema.update(2);
+    ASSERT_EQ(ema.ready(), false);
+    ASSERT_NEAR(ema.update(3), 2.0, 1e-12);      // seeded with SMA(1,2,3)
+    ASSERT_NEAR(ema.update(6), 4.0, 1e-12);      // 2 + 0.5 * (6 - 2)
+
+    KalmanSmoother k(2400);
+    ASSERT_NEAR(k.update(100), 100, 1e-12);
+    const double gain = 0.24, d = 10.0;
+    ASSERT_NEAR(k.update(110), 100 + d * std::sqrt(gain * 2) + gain * d, 1e-12);
+}
+
+//--- Sweep: one shared series, results in combination order and equal to a serial run
+class EnterExitStrategy : public IStrategy {
+public:
+    EnterExitStrategy(std::size_t entry, std::size_t exit) : entry_(entry), exit_(exit) {}
+    void onBar(const Bar&, IContext& ctx) override {
+        if (ctx.barIndex() == entry_) ctx.placeOrder(Side::Long, 1);
+        if (ctx.barIndex() == exit_ && ctx.position() > 0) ctx.placeOrder(Side::Short, 1);
+    }
+private:
+    std::size_t entry_;
+    std::size_t exit_;
+};
+
+void run_parameter_sweep() {
+    std::vector<SweepRange> ranges;
+    std::string err;
+    ASSERT_EQ(parseSweepSpec("entry=0:10:2,exit=5:30:5", ranges, err), true);
+    ASSERT_EQ(ranges.size(), 2u);
+    ASSERT_EQ(ranges[0].count(), 6u);
+    ASSERT_EQ(ranges[1].count(), 6u);
+    ASSERT_EQ(sweepSize(ranges), 36u);
+    ASSERT_NEAR(sweepValues(ranges, 7)[0], 2.0, 1e-12);  // 7 = 1 * 6 + 1
+    ASSERT_NEAR(sweepValues(ranges, 7)[1], 10.0, 1e-12);
+    std::vector<SweepRange> bad;
+    ASSERT_EQ(parseSweepSpec("fast=10:5", bad, err), false);
+    ASSERT_EQ(parseSweepSpec("fast=1:x", bad, err), false);
+    ASSERT_EQ(parseSweepSpec("fast=1:5,fast=2:3", bad, err), false);
+    ASSERT_EQ(parseSweepSpec("size=0.1:0.5:0.1", bad, err), true);
+    ASSERT_EQ(bad[0].count(), 5u);
+
+    auto series = std::make_shared<BarSeries>();
+    for (int i = 0; i < 50; ++i) {
+        Bar b;
+        b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * 60'000'000'000LL;
+        b.open = b.high = b.low = b.close = 100.0 + i;
+        series->push_back(b);
+    }
+    std::shared_ptr<const BarSeries> bars = series;
+
+    SweepStrategyFactory factory = [](const std::vector<double>& v) -> std::unique_ptr<IStrategy> {
+        if (v[1] <= v[0]) return nullptr;  // exit must come after entry
+        return std::make_unique<EnterExitStrategy>(static_cast<std::size_t>(v[0]), static_cast<std::size_t>(v[1]));
+    };
+    SweepOptions options;
+    options.initial_cash = 1000.0;
+
+    ThreadPool one(1), four(4);
+    std::vector<SweepResult> serial = runSweep(bars, ranges, factory, options, one);
+    std::vector<SweepResult> parallel = runSweep(bars, ranges, factory, options, four);
+    ASSERT_EQ(serial.size(), 32u);  // exit <= entry skipped: 6/5, 8/5, 10/5, 10/10
+    ASSERT_EQ(parallel.size(), serial.size());
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        ASSERT_EQ(parallel[i].index, serial[i].index);
+        if (i > 0) ASSERT_EQ(serial[i].index > serial[i - 1].index, true);
+        ASSERT_NEAR(parallel[i].metrics.final_equity, serial[i].metrics.final_equity, 0.0);
+        ASSERT_EQ(serial[i].metrics.num_trades, 1);
+        // Same run through a Backtester that owns its bars.
+        Backtester bt(factory(serial[i].values), *series, options.initial_cash);
+        ASSERT_EQ(bt.run(), true);
+        ASSERT_NEAR(bt.simulator().equity(), serial[i].metrics.final_equity, 0.0);
+        // Fills at the next bar's open: profit is exactly the number of bars held.
+        ASSERT_NEAR(bt.simulator().trades()[0].pnl, serial[i].values[1] - serial[i].values[0], 1e-9);
+    }
+    // Shared series left untouched.
+    ASSERT_EQ(bars->size(), 50u);
+
+    rankSweepResults(serial, SweepRank::Return);
+    ASSERT_NEAR(serial.front().values[0], 0.0, 1e-12);
+    ASSERT_NEAR(serial.front().values[1], 30.0, 1e-12);
+
+    // Past the cap nothing runs (and nothing is allocated per combination).
+    std::vector<SweepRange> huge;
+    ASSERT_EQ(parseSweepSpec("entry=1:100000:0.0001", huge, err), true);
+    ASSERT_EQ(sweepSize(huge) > MAX_SWEEP_COMBINATIONS, true);
+    ASSERT_EQ(runSweep(bars, huge, factory, options, four).empty(), true);
+}
+
+//--- Lockstep SMA kernel: every lane matches a Backtester + SmaCrossoverStrategy run
+void run_sma_lockstep_matches_backtester() {
+    BarSeries series;
+    double px = 100.0;
+    std::uint32_t seed = 12345;
+    for (int i = 0; i < 1500; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const double step = (static_cast<double>(seed >> 8) / 16777216.0 - 0.5) * 2.0;
+        Bar b;
+        b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * 60'000'000'000LL;
+        b.open = px;
+        px = std::max(1.0, px + step);
+        b.close = px;
+        b.high = std::max(b.open, b.close) + 0.5;
+        b.low = std::min(b.open, b.close) - 0.5;
+        series.push_back(b);
+    }
+
+    std::vector<SmaLane> lanes;
+    for (int fast = 1; fast <= 13; fast += 3)
+        for (int slow = 4; slow <= 64; slow += 12)
+            for (double size : { 0.5, 1.0, 40.0 })  // 40x: leveraged lanes that stop early
+                lanes.push_back({ fast, slow, size });
+    lanes.push_back({ 30, 10, 1.0 });  // fast > slow is still a valid lane
+
+    const double cash = 10000.0, commission = 1.5, slippage = 0.0005;
+    std::vector<SmaLaneResult> got = runSmaCrossoverLockstep(series, lanes, cash, commission, slippage);
+    ASSERT_EQ(got.size(), lanes.size());
+    int stopped = 0;
+    for (std::size_t i = 0; i < lanes.size(); ++i) {
+        Backtester bt(createSmaCrossoverStrategy(lanes[i].fast, lanes[i].slow, lanes[i].size), series,
+                      cash, commission, "1m", slippage);
+        ASSERT_EQ(bt.run(), true);
+        Report report(bt.simulator(), bt.bars(), cash);
+        const BacktestMetrics want = report.computeMetrics();
+        const BacktestMetrics& m = got[i].metrics;
+        ASSERT_NEAR(m.final_equity, want.final_equity, 0.0);
+        ASSERT_NEAR(m.total_return_pct, want.total_return_pct, 0.0);
+        ASSERT_NEAR(m.max_drawdown_pct, want.max_drawdown_pct, 0.0);
+        ASSERT_NEAR(m.sharpe_ratio, want.sharpe_ratio, 1e-9 * (1.0 + std::abs(want.sharpe_ratio)));
+        ASSERT_EQ(m.num_trades, want.num_trades);
+        ASSERT_EQ(m.winning_trades, want.winning_trades);
+        ASSERT_NEAR(m.avg_trade_pnl, want.avg_trade_pnl, 0.0);
+        ASSERT_NEAR(m.open_position, want.open_position, 0.0);
+        ASSERT_NEAR(m.unrealized_pnl, want.unrealized_pnl, 0.0);
+        ASSERT_EQ(got[i].stop_reason, bt.stoppedEarly() ? bt.stopReason() : std::string());
+        if (bt.stoppedEarly()) ++stopped;
+    }
+    ASSERT_EQ(stopped > 0, true);
+    ASSERT_EQ(stopped < static_cast<int>(lanes.size()), true);
+
+    // runSmaSweep (lanes built per chunk) returns what runSweep does, in the same order.
+    std::vector<SweepRange> ranges;
+    std::string err;
+    ASSERT_EQ(parseSweepSpec("fast=1:20,slow=4:64:4", ranges, err), true);
+    SweepOptions options;
+    options.initial_cash = cash;
+    options.commission = commission;
+    options.slippage = slippage;
+    SmaLaneFactory lane_factory = [](const std::vector<double>& v, SmaLane& lane) {
+        if (v[0] >= v[1]) return false;
+        lane = { static_cast<int>(v[0]), static_cast<int>(v[1]), 1.0 };
+        return true;
+    };
+    SweepStrategyFactory factory = [](const std::vector<double>& v) -> std::unique_ptr<IStrategy> {
+        if (v[0] >= v[1]) return nullptr;
+        return createSmaCrossoverStrategy(static_cast<int>(v[0]), static_cast<int>(v[1]), 1.0);
+    };
+    ThreadPool four(4);
+    const auto shared = std::make_shared<const BarSeries>(series);
+    std::vector<SweepResult> lockstep = runSmaSweep(series, ranges, lane_factory, options, four);
+    std::vector<SweepResult> per_run = runSweep(shared, ranges, factory, options, four);
+    ASSERT_EQ(lockstep.size(), per_run.size());
+    ASSERT_EQ(lockstep.size() > 64u, true);  // more than one chunk
+    for (std::size_t i = 0; i < lockstep.size(); ++i) {
+        ASSERT_EQ(lockstep[i].index, per_run[i].index);
+        ASSERT_NEAR(lockstep[i].metrics.final_equity, per_run[i].metrics.final_equity, 0.0);
+    }
+    std::vector<SweepRange> huge;
+    ASSERT_EQ(parseSweepSpec("fast=1:100000,slow=1:100000", huge, err), true);
+    ASSERT_EQ(runSmaSweep(series, huge, lane_factory, options, four).empty(), true);
+}
+
+//--- StaticBacktester: same loop as Backtester, so the same trades and curve for the same strategy logic
+struct FlipEveryN {
+    int n{7};
+    template <typename Ctx>
+    void onBar(const Bar& bar, Ctx& ctx) {
+        if (ctx.barIndex() % static_cast<std::size_t>(n) != 0) return;
+        if (ctx.position() > 0) ctx.placeOrder(Side::Short, 2.0);
+        else if (ctx.bars().size() > 1 && bar.close > ctx.bars()[ctx.barIndex() - 1].close) ctx.placeOrder(Side::Long, 1.0);
+    }
+};
+
+class FlipEveryNStrategy : public IStrategy {
+public:
+    void onBar(const Bar& bar, IContext& ctx) override { impl_.onBar(bar, ctx); }
+
+private:
+    FlipEveryN impl_;
+};
+
+void run_static_backtester_matches_backtester() {
+    auto series = std::make_shared<BarSeries>();
+    double px = 100.0;
+    std::uint32_t seed = 99;
+    for (int i = 0; i < 800; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        Bar b;
+        b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * 60'000'000'000LL;
+        b.open = px;
+        px = std::max(1.0, px + (static_cast<double>(seed >> 8) / 16777216.0 - 0.5));
+        b.close = px;
+        b.high = std::max(b.open, b.close) + 0.25;
+        b.low = std::min(b.open, b.close) - 0.25;
+        series->push_back(b);
+    }
+    std::shared_ptr<const BarSeries> bars = series;
+
+    Backtester dyn(std::make_unique<FlipEveryNStrategy>(), bars, 10000.0, 1.0, 0.0005);
+    ASSERT_EQ(dyn.run(), true);
+    StaticBacktester<FlipEveryN> fast(FlipEveryN{}, bars, 10000.0, 1.0, 0.0005);
+    ASSERT_EQ(fast.run(), true);
+
+    const Simulator& a = dyn.simulator();
+    const Simulator& b = fast.simulator();
+    ASSERT_EQ(a.trades().size() > 10, true);
+    ASSERT_EQ(b.trades().size(), a.trades().size());
+    for (std::size_t i = 0; i < a.trades().size(); ++i) {
+        ASSERT_NEAR(b.trades()[i].pnl, a.trades()[i].pnl, 0.0);
+        ASSERT_EQ(b.trades()[i].exit_time, a.trades()[i].exit_time);
+    }
+    ASSERT_EQ(b.equityCurve().size(), a.equityCurve().size());
+    for (std::size_t i = 0; i < a.equityCurve().size(); ++i)
+        ASSERT_NEAR(b.equityCurve()[i], a.equityCurve()[i], 0.0);
+    ASSERT_EQ(fast.stoppedEarly(), dyn.stoppedEarly());
+
+    StaticBacktester<FlipEveryN> empty(FlipEveryN{}, std::make_shared<const BarSeries>(), 10000.0);
+    ASSERT_EQ(empty.run(), false);
+}
+
+//--- Pruning: kill criteria stop runs early inside the bar loop; the percentile rule reads finished runs
+void run_sweep_pruning() {
+    auto series = std::make_shared<BarSeries>();
+    for (int i = 0; i < 100; ++i) {
+        Bar b;
+        b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * 60'000'000'000LL;
+        b.open = b.high = b.low = b.close = (i < 50) ? 100.0 + i : 149.0 - 2.0 * (i - 49);
+        series->push_back(b);
+    }
+    std::shared_ptr<const BarSeries> bars = series;
+
+    // No trades after 25 bars: entries at bar 30 / 40 never get a position in time
+    std::vector<SweepRange> ranges;
+    std::string err;
+    ASSERT_EQ(parseSweepSpec("entry=0:40:10,exit=90", ranges, err), true);
+    SweepStrategyFactory factory = [](const std::vector<double>& v) -> std::unique_ptr<IStrategy> {
+        return std::make_unique<EnterExitStrategy>(static_cast<std::size_t>(v[0]), static_cast<std::size_t>(v[1]));
+    };
+    SweepOptions options;
+    options.initial_cash = 1000.0;
+    options.prune.no_trade_bars = 25;
+    ThreadPool pool(2);
+    std::vector<SweepResult> results = runSweep(bars, ranges, factory, options, pool);
+    ASSERT_EQ(results.size(), 5u);
+    for (const SweepResult& r : results) {
+        const bool late = r.values[0] >= 30;
+        ASSERT_EQ(r.stop_reason, std::string(late ? "pruned: no trades" : ""));
+        ASSERT_EQ(r.metrics.num_trades, late ? 0 : 1);
+    }
+    // The pruned runs' 0% return / 0% drawdown beat every (losing) completed run: they still rank last
+    for (SweepRank rank : { SweepRank::Return, SweepRank::Drawdown, SweepRank::Sharpe }) {
+        std::vector<SweepResult> ranked = results;
+        rankSweepResults(ranked, rank);
+        for (std::size_t i = 0; i < ranked.size(); ++i) ASSERT_EQ(ranked[i].pruned(), i >= 3);
+        ASSERT_EQ(ranked.front().metrics.num_trades, 1);
+    }
+
+    // Drawdown: the long from bar 1 gives back ~5% of equity on the way down
+    Backtester bt(factory({ 0, 90 }), bars, 1000.0);
+    PruneCriteria dd;
+    dd.max_drawdown_pct = 3.0;
+    bt.setPruning(dd, nullptr);
+    ASSERT_EQ(bt.run(), true);
+    ASSERT_EQ(bt.stopReason(), std::string("pruned: drawdown"));
+    ASSERT_EQ(bt.metrics().max_drawdown_pct > 3.0, true);
+    ASSERT_EQ(bt.metrics().max_drawdown_pct < 3.2, true);  // stopped at the first bar past the limit
+
+    // Equity percentile: checkpoints at bars 20, 40, 60, 80 of 100
+    PruneBoard board(4);
+    ASSERT_EQ(board.checkpoints(), 4u);
+    double p = 0;
+    ASSERT_EQ(board.percentile(0, 50, 1, p), false);
+    board.record({ 100, 110, 120, 130 });
+    board.record({ 90, 80 });  // stopped before the third checkpoint
+    board.record({ 105, 100, 95, 90 });
+    ASSERT_EQ(board.percentile(0, 50, 3, p), true);
+    ASSERT_NEAR(p, 100.0, 0.0);
+    ASSERT_EQ(board.percentile(2, 50, 3, p), false);  // only two runs got there
+    ASSERT_EQ(board.percentile(2, 0, 2, p), true);
+    ASSERT_NEAR(p, 95.0, 0.0);
+
+    PruneCriteria pc;
+    pc.equity_percentile = 50;
+    pc.checkpoints = 4;
+    pc.min_completed = 3;
+    MetricsAccumulator acc(100.0);
+    RunPruner keeps(pc, 100, &board);
+    std::string reason;
+    for (std::size_t i = 0; i < 100; ++i)
+        ASSERT_EQ(keeps.check(i, 120.0, 0.0, acc, reason), false);
+    keeps.finish();  // recorded: now four runs at every checkpoint it passed
+    ASSERT_EQ(board.percentile(3, 0, 3, p), true);
+    ASSERT_NEAR(p, 90.0, 0.0);
+
+    RunPruner lags(pc, 100, &board);
+    std::size_t stopped_at = 0;
+    for (std::size_t i = 0; i < 100; ++i) {
+        if (lags.check(i, i < 30 ? 200.0 : 99.0, 0.0, acc, reason)) {
+            stopped_at = i;
+            break;
+        }
+    }
+    ASSERT_EQ(stopped_at, 40u);  // above the median at bar 20, below it (100) at bar 40
+    ASSERT_EQ(reason, std::string("pruned: below equity percentile"));
+    ASSERT_EQ(lags.pruned(), true);
+}
+
+//--- Walk-forward: windows by bars and by time; ranged runs equal runs on a copy; winners chain equity
+void run_walk_forward() {
+    WalkForwardSpec spec;
+    std::string err;
+    ASSERT_EQ(parseWalkForwardSpec("300:100", spec, err), true);
+    ASSERT_EQ(spec.in_sample_bars, 300u);
+    ASSERT_EQ(spec.out_of_sample_bars, 100u);
+    ASSERT_EQ(spec.anchored, false);
+    ASSERT_EQ(parseWalkForwardSpec("90d:30d:anchored", spec, err), true);
+    ASSERT_EQ(spec.in_sample_ns, 90 * NS_PER_DAY);
+    ASSERT_EQ(spec.out_of_sample_ns, 30 * NS_PER_DAY);
+    ASSERT_EQ(spec.anchored, true);
+    ASSERT_EQ(parseWalkForwardSpec("300", spec, err), false);
+    ASSERT_EQ(parseWalkForwardSpec("300:30d", spec, err), false);  // mixed kinds
+    ASSERT_EQ(parseWalkForwardSpec("300:0", spec, err), false);
+    ASSERT_EQ(parseWalkForwardSpec("300:100:rolling", spec, err), false);
+
+    // Prices rise for 200 bars, fall for 200, rise again: one regime change per out-of-sample window or so
+    auto series = std::make_shared<BarSeries>();
+    double px = 100.0;
+    for (int i = 0; i < 1000; ++i) {
+        px += (i / 200) % 2 == 0 ? 0.5 : -0.5;
+        Bar b;
+        b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * NS_PER_MINUTE;
+        b.open = b.high = b.low = b.close = px;
+        series->push_back(b);
+    }
+    std::shared_ptr<const BarSeries> bars = series;
+
+    ASSERT_EQ(parseWalkForwardSpec("300:100", spec, err), true);
+    std::vector<WalkForwardWindow> windows = walkForwardWindows(*bars, spec);
+    ASSERT_EQ(windows.size(), 7u);  // in-sample starts 0, 100, ..., 600
+    ASSERT_EQ(windows[1].is_begin, 100u);
+    ASSERT_EQ(windows[1].is_end, 400u);
+    ASSERT_EQ(windows[1].oos_begin, 400u);
+    ASSERT_EQ(windows[1].oos_end, 500u);
+    ASSERT_EQ(windows.back().oos_end, 1000u);
+    spec.anchored = true;
+    ASSERT_EQ(walkForwardWindows(*bars, spec)[3].is_begin, 0u);
+    ASSERT_EQ(walkForwardWindows(*bars, spec)[3].is_end, 600u);
+
+    // Calendar windows: 5h in-sample, 100m out-of-sample over 1000 minutes, same pairs as by bars
+    ASSERT_EQ(parseWalkForwardSpec("5h:100m", spec, err), true);
+    std::vector<WalkForwardWindow> by_time = walkForwardWindows(*bars, spec);
+    ASSERT_EQ(by_time.size(), 7u);
+    for (std::size_t k = 0; k < by_time.size(); ++k) {
+        ASSERT_EQ(by_time[k].is_begin, windows[k].is_begin);
+        ASSERT_EQ(by_time[k].oos_end, windows[k].oos_end);
+    }
+
+    // A ranged run on the shared series is the run on a copy of the window (indicators start over)
+    auto copy = std::make_shared<BarSeries>();
+    for (std::size_t i = 400; i < 500; ++i) copy->push_back((*bars)[i]);
+    Backtester ranged(createSmaCrossoverStrategy(3, 10, 1e-6), bars, 1000.0);
+    ranged.setIndicatorCache(std::make_shared<IndicatorCache>(), IndicatorCache::newSeriesId());
+    ranged.setRange(400, 500);
+    Backtester copied(createSmaCrossoverStrategy(3, 10, 1e-6), std::shared_ptr<const BarSeries>(copy), 1000.0);
+    ASSERT_EQ(ranged.run(), true);
+    ASSERT_EQ(copied.run(), true);
+    ASSERT_EQ(ranged.simulator().equityCurve().size(), 100u);
+    ASSERT_EQ(ranged.metrics().num_trades, copied.metrics().num_trades);
+    ASSERT_NEAR(ranged.metrics().final_equity, copied.metrics().final_equity, 1e-9);
+    for (std::size_t i = 0; i < 100; ++i)
+        ASSERT_NEAR(ranged.simulator().equityCurve()[i], copied.simulator().equityCurve()[i], 1e-9);
+    Backtester empty(createSmaCrossoverStrategy(3, 10, 1e-6), bars, 1000.0);
+    empty.setRange(1000, 2000);
+    ASSERT_EQ(empty.run(), false);
+
+    // Each window's winner is the in-sample sweep's best; out-of-sample runs chain their equity
+    std::vector<SweepRange> ranges;
+    ASSERT_EQ(parseSweepSpec("entry=0:40:10,exit=60:280:110", ranges, err), true);
+    SweepStrategyFactory factory = [](const std::vector<double>& v) -> std::unique_ptr<IStrategy> {
+        return std::make_unique<EnterExitStrategy>(static_cast<std::size_t>(v[0]), static_cast<std::size_t>(v[1]));
+    };
+    SweepOptions options;
+    options.initial_cash = 1000.0;
+    ThreadPool pool(2);
+    WalkForwardReport report = runWalkForward(bars, windows, ranges, factory, options, SweepRank::Return, pool);
+    ASSERT_EQ(report.windows.size(), windows.size());
+    std::size_t oos_bars = 0;
+    double cash = options.initial_cash;
+    for (const WalkForwardResult& r : report.windows) {
+        auto is_copy = std::make_shared<BarSeries>();
+        for (std::size_t i = r.window.is_begin; i < r.window.is_end; ++i) is_copy->push_back((*bars)[i]);
+        std::vector<SweepResult> is = runSweep(is_copy, ranges, factory, options, pool);
+        rankSweepResults(is, SweepRank::Return);
+        ASSERT_EQ(r.best.index, is.front().index);
+        ASSERT_EQ(r.candidates, is.size());
+        ASSERT_NEAR(r.oos.initial_equity, cash, 1e-9);
+        cash = r.oos.final_equity;
+        oos_bars += r.window.oos_end - r.window.oos_begin;
+    }
+    ASSERT_EQ(report.oos_equity.size(), oos_bars);
+    ASSERT_EQ(report.oos_bar.front(), 300u);
+    ASSERT_EQ(report.oos_bar.back(), 999u);
+    ASSERT_NEAR(report.oos_equity.back(), cash, 1e-9);
+
+    // With runs pruned in-sample (entries at bar 30 / 40 of a window), the winner is never a pruned run
+    options.prune.no_trade_bars = 25;
+    WalkForwardReport pruned = runWalkForward(bars, windows, ranges, factory, options, SweepRank::Drawdown, pool);
+    ASSERT_EQ(pruned.windows.size(), windows.size());
+    for (const WalkForwardResult& r : pruned.windows) {
+        ASSERT_EQ(r.best.pruned(), false);
+        ASSERT_EQ(r.best.values[0] < 30, true);
+    }
+}
+
+//--- Monte Carlo: shuffle keeps the total, bootstrap spreads it; paths independent of threads; ruin, compounding
+std::vector<Trade> tradesWithPnl(const std::vector<double>& pnls) {
+    std::vector<Trade> trades(pnls.size());
+    for (std::size_t i = 0; i < pnls.size(); ++i) trades[i].pnl = pnls[i];
+    return trades;
+}
+
+void run_monte_carlo() {
+    MonteCarloMethod method;
+    ASSERT_EQ(parseMonteCarloMethod("shuffle", method), true);
+    ASSERT_EQ(method == MonteCarloMethod::Shuffle, true);
+    ASSERT_EQ(parseMonteCarloMethod("bootstrap", method), true);
+    ASSERT_EQ(parseMonteCarloMethod("permute", method), false);
+
+    ThreadPool one(1), four(4);
+    const std::vector<Trade> trades = tradesWithPnl({ 100, -50, 30, -80, 20 });
+    MonteCarloOptions options;
+    options.paths = 5000;  // not a multiple of the lane / task sizes
+
+    // Shuffle: same total every path; drawdown at most all the losses in a row (130 of 1000)
+    options.method = MonteCarloMethod::Shuffle;
+    MonteCarloPaths shuffled = runMonteCarlo(trades, 1000.0, options, four);
+    ASSERT_EQ(shuffled.return_pct.size(), 5000u);
+    double worst = 0;
+    for (std::size_t p = 0; p < shuffled.return_pct.size(); ++p) {
+        ASSERT_NEAR(shuffled.return_pct[p], 2.0, 1e-9);
+        worst = std::max(worst, shuffled.max_drawdown_pct[p]);
+    }
+    ASSERT_NEAR(worst, 13.0, 1e-9);  // 5000 paths hit the worst of the 120 orders
+
+    // Paths depend on (seed, path) only, not on the thread count
+    MonteCarloPaths serial = runMonteCarlo(trades, 1000.0, options, one);
+    for (std::size_t p = 0; p < serial.return_pct.size(); ++p)
+        ASSERT_EQ(serial.max_drawdown_pct[p], shuffled.max_drawdown_pct[p]);
+
+    // Bootstrap: mean total near 5 x the mean trade (+20 = 2%), spread on both sides
+    options.method = MonteCarloMethod::Bootstrap;
+    options.paths = 20000;
+    MonteCarloPaths boot = runMonteCarlo(trades, 1000.0, options, four);
+    MonteCarloSummary s = summarizeMonteCarlo(boot, trades.size(), options);
+    ASSERT_EQ(s.paths, 20000u);
+    ASSERT_NEAR(s.mean_return_pct, 2.0, 0.5);
+    for (std::size_t k = 1; k < MONTE_CARLO_PERCENTILE_COUNT; ++k) {
+        ASSERT_EQ(s.return_pct[k] >= s.return_pct[k - 1], true);
+        ASSERT_EQ(s.max_drawdown_pct[k] >= s.max_drawdown_pct[k - 1], true);
+    }
+    // Extremes: five draws of -80 / of +100 (each 1 in 3125 paths)
+    ASSERT_NEAR(*std::min_element(boot.return_pct.begin(), boot.return_pct.end()), -40.0, 1e-9);
+    ASSERT_NEAR(*std::max_element(boot.return_pct.begin(), boot.return_pct.end()), 50.0, 1e-9);
+    ASSERT_EQ(s.return_pct[0] > -40.0 && s.return_pct[MONTE_CARLO_PERCENTILE_COUNT - 1] < 50.0, true);
+    ASSERT_EQ(s.loss_probability_pct > 20 && s.loss_probability_pct < 60, true);
+    options.seed = 2;
+    ASSERT_EQ(runMonteCarlo(trades, 1000.0, options, four).return_pct != boot.return_pct, true);
+
+    // Ruin: two draws of -600 wipe out 1000 (equity stays at 0), a quarter of the paths
+    MonteCarloPaths ruin = runMonteCarlo(tradesWithPnl({ -600, 10 }), 1000.0, options, four);
+    s = summarizeMonteCarlo(ruin, 2, options);
+    ASSERT_NEAR(s.ruin_probability_pct, 25.0, 1.5);
+    ASSERT_NEAR(s.return_pct[0], -100.0, 1e-9);
+    ASSERT_NEAR(s.max_drawdown_pct[MONTE_CARLO_PERCENTILE_COUNT - 1], 100.0, 1e-9);
+
+    // Compound: +10% then -10% of the equity before each trade, in either order 1000 -> 990
+    options.method = MonteCarloMethod::Shuffle;
+    options.compound = true;
+    MonteCarloPaths compound = runMonteCarlo(tradesWithPnl({ 100, -110 }), 1000.0, options, four);
+    for (double r : compound.return_pct) ASSERT_NEAR(r, -1.0, 1e-9);
+
+    ASSERT_EQ(runMonteCarlo({}, 1000.0, options, four).return_pct.empty(), true);
+
+    Simulator sim(1000.0);
+    BarSeries bars;
+    Report report(sim, bars, 1000.0);
+    std::ostringstream out;
+    report.printSummary(out);
+    ASSERT_EQ(out.str().find("Monte Carlo"), std::string::npos);
+    report.setMonteCarlo(summarizeMonteCarlo(boot, trades.size(), MonteCarloOptions{}));
+    std::ostringstream with_mc;
+    report.printSummary(with_mc);
+    ASSERT_EQ(with_mc.str().find("Monte Carlo (bootstrap, 20000 paths of 5 trades)") != std::string::npos, true);
+}
+
+//--- Online metrics: the accumulator during run() matches Report's pass over the stored curve
+void run_online_metrics() {
+    auto series = std::make_shared<BarSeries>();
+    double px = 100.0;
+    std::uint32_t seed = 31337;
+    for (int i = 0; i < 1200; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        Bar b;
+        b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * 60'000'000'000LL;
+        b.open = px;
+        px = std::max(1.0, px + (static_cast<double>(seed >> 8) / 16777216.0 - 0.5) * 2.0);
+        b.close = px;
+        b.high = std::max(b.open, b.close) + 0.5;
+        b.low = std::min(b.open, b.close) - 0.5;
+        series->push_back(b);
+    }
+    std::shared_ptr<const BarSeries> bars = series;
+
+    for (double size : { 0.5, 40.0 }) {  // 40x: leveraged, stops early
+        Backtester bt(createSmaCrossoverStrategy(4, 15, size), bars, 10000.0, 1.5, 0.0005);
+        ASSERT_EQ(bt.run(), true);
+        Report report(bt.simulator(), bt.bars(), 10000.0);
+        const BacktestMetrics want = report.computeMetrics();
+        const BacktestMetrics got = bt.metrics();
+        ASSERT_EQ(got.num_trades > 0, true);
+        ASSERT_NEAR(got.final_equity, want.final_equity, 0.0);
+        ASSERT_NEAR(got.total_return_pct, want.total_return_pct, 0.0);
+        ASSERT_NEAR(got.max_drawdown_pct, want.max_drawdown_pct, 0.0);
+        ASSERT_NEAR(got.sharpe_ratio, want.sharpe_ratio, 1e-9 * (1.0 + std::abs(want.sharpe_ratio)));
+        ASSERT_NEAR(got.sortino_ratio, want.sortino_ratio, 1e-9 * (1.0 + std::abs(want.sortino_ratio)));
+        ASSERT_NEAR(got.calmar_ratio, want.calmar_ratio, 0.0);
+        ASSERT_EQ(got.num_trades, want.num_trades);
+        ASSERT_EQ(got.winning_trades, want.winning_trades);
+        ASSERT_NEAR(got.avg_trade_pnl, want.avg_trade_pnl, 0.0);
+        ASSERT_NEAR(got.open_position, want.open_position, 0.0);
+        ASSERT_NEAR(got.unrealized_pnl, want.unrealized_pnl, 0.0);
+        ASSERT_EQ(got.exposure_pct > 0 && got.exposure_pct < 100.0, true);
+        if (size > 1.0) ASSERT_EQ(bt.stoppedEarly(), true);
+
+        // Without the stored curve: same metrics, nothing kept per bar
+        Backtester lean(createSmaCrossoverStrategy(4, 15, size), bars, 10000.0, 1.5, 0.0005);
+        lean.setRecordEquityCurve(false);
+        ASSERT_EQ(lean.run(), true);
+        ASSERT_EQ(lean.simulator().equityCurve().empty(), true);
+        const BacktestMetrics m = lean.metrics();
+        ASSERT_NEAR(m.final_equity, got.final_equity, 0.0);
+        ASSERT_NEAR(m.sharpe_ratio, got.sharpe_ratio, 0.0);
+        ASSERT_NEAR(m.max_drawdown_pct, got.max_drawdown_pct, 0.0);
+        ASSERT_NEAR(m.exposure_pct, got.exposure_pct, 0.0);
+    }
+
+    // Flat run: no exposure, no ratios
+    MetricsAccumulator acc(1000.0);
+    for (int i = 0; i < 5; ++i) acc.addBar(1000.0, 0.0);
+    const BacktestMetrics flat = acc.metrics();
+    ASSERT_NEAR(flat.final_equity, 1000.0, 0.0);
+    ASSERT_NEAR(flat.sharpe_ratio, 0.0, 0.0);
+    ASSERT_NEAR(flat.sortino_ratio, 0.0, 0.0);
+    ASSERT_NEAR(flat.calmar_ratio, 0.0, 0.0);
+    ASSERT_NEAR(flat.exposure_pct, 0.0, 0.0);
+}
+
+//--- Bar loop: a run's heap allocations don't grow with its bar count (setup only; nothing per bar)
+class BracketEveryN : public IStrategy {
+public:
+    void onBar(const Bar& bar, IContext& ctx) override {
+        if (ctx.position() != 0 || ctx.barIndex() % 5 != 0) return;
+        Order entry;
+        entry.side = (ctx.barIndex() % 10 == 0) ? Side::Long : Side::Short;
+        entry.quantity = 1.0;
+        const double dir = entry.side == Side::Long ? 1.0 : -1.0;
+        ctx.submitBracket(entry, bar.close - dir * 0.6, bar.close + dir * 0.6);
+    }
+};
+
+void run_bar_loop_allocation_free() {
+    auto makeBars = [](int n) {
+        auto series = std::make_shared<BarSeries>();
+        series->reserve(static_cast<std::size_t>(n));
+        double px = 100.0;
+        std::uint32_t seed = 4242;
+        for (int i = 0; i < n; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            Bar b;
+            b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * 60'000'000'000LL;
+            b.open = px;
+            px = std::max(1.0, px + (static_cast<double>(seed >> 8) / 16777216.0 - 0.5));
+            b.close = px;
+            b.high = std::max(b.open, b.close) + 0.3;
+            b.low = std::min(b.open, b.close) - 0.3;
+            series->push_back(b);
+        }
+        return std::shared_ptr<const BarSeries>(series);
+    };
+    auto allocationsPerRun = [](std::unique_ptr<IStrategy> strategy, std::shared_ptr<const BarSeries> bars,
+                                std::size_t& trades) {
+        Backtester bt(std::move(strategy), std::move(bars), 100000.0, 1.0, 0.0005);
+        const std::size_t before = test::heapAllocations();
+        ASSERT_EQ(bt.run(), true);
+        const std::size_t n = test::heapAllocations() - before;
+        ASSERT_EQ(bt.stoppedEarly(), false);
+        trades = bt.simulator().trades().size();
+        return n;
+    };
+
+    const auto small = makeBars(2000), large = makeBars(8000);
+    std::size_t trades_small = 0, trades_large = 0;
+    std::size_t a = allocationsPerRun(createSmaCrossoverStrategy(3, 8, 1e-6), small, trades_small);
+    std::size_t b = allocationsPerRun(createSmaCrossoverStrategy(3, 8, 1e-6), large, trades_large);
+    ASSERT_EQ(trades_large > trades_small, true);
+    ASSERT_EQ(a > 0, true);  // the counter sees the run's setup
+    ASSERT_EQ(b, a);
+
+    a = allocationsPerRun(std::make_unique<BracketEveryN>(), small, trades_small);
+    b = allocationsPerRun(std::make_unique<BracketEveryN>(), large, trades_large);
+    ASSERT_EQ(trades_large > trades_small, true);
+    ASSERT_EQ(b, a);
+
+    // Portfolio: the account curve gets a point per distinct timestamp. With the second symbol 30s off
+    // the first, that is twice either series, and the run still allocates no more than when they line up.
+    auto portfolioAllocations = [](const std::shared_ptr<const BarSeries>& bars, std::int64_t offset,
+                                   std::size_t& points) {
+        auto shifted = std::make_shared<BarSeries>(*bars);
+        for (std::size_t i = 0; i < shifted->size(); ++i) {
+            Bar bar = (*shifted)[i];
+            bar.timestamp += offset;
+            shifted->set(i, bar);
+        }
+        PortfolioBacktester pb(createPerSymbolStrategy([](const std::string&) { return createSmaCrossoverStrategy(3, 8, 1e-6); }),
+                               100000.0, 1.0, 0.0005);
+        pb.addSymbol("A", bars);
+        pb.addSymbol("B", shifted);
+        const std::size_t before = test::heapAllocations();
+        ASSERT_EQ(pb.run(), true);
+        const std::size_t n = test::heapAllocations() - before;
+        points = pb.equityCurve().size();
+        return n;
+    };
+    std::size_t points_aligned = 0, points_apart = 0, points_large = 0;
+    a = portfolioAllocations(small, 0, points_aligned);
+    b = portfolioAllocations(small, 30 * NS_PER_SECOND, points_apart);
+    ASSERT_EQ(points_aligned, small->size());
+    ASSERT_EQ(points_apart, 2 * small->size());
+    ASSERT_EQ(b, a);
+    ASSERT_EQ(portfolioAllocations(large, 30 * NS_PER_SECOND, points_large), a);
+}
+
+//--- Indicator cache: columns equal the streaming indicators, shared by runs, LRU within the budget
+void run_indicator_cache() {
+    BarSeries series;
+    double px = 50.0;
+    std::uint32_t seed = 777;
+    for (int i = 0; i < 600; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        Bar b;
+        b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * 60'000'000'000LL;
+        b.open = px;
+        px = std::max(1.0, px + (static_cast<double>(seed >> 8) / 16777216.0 - 0.5));
+        b.close = b.high = b.low = px;
+        series.push_back(b);
+    }
+    const std::size_t column_bytes = series.size() * sizeof(double);
+
+    IndicatorCache cache(3 * column_bytes);
+    const std::uint64_t id = IndicatorCache::newSeriesId();
+    ASSERT_EQ(IndicatorCache::newSeriesId() != id, true);
+    IndicatorColumnPtr sma = cache.get(id, series, IndicatorKind::Sma, 20);
+    IndicatorColumnPtr ema = cache.get(id, series, IndicatorKind::Ema, 20);
+    ASSERT_EQ(sma->size(), series.size());
+    Sma s(20);
+    Ema e(20);
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        ASSERT_NEAR((*sma)[i], s.update(series.closes()[i]), 0.0);
+        ASSERT_NEAR((*ema)[i], e.update(series.closes()[i]), 0.0);
+    }
+    ASSERT_EQ(cache.get(id, series, IndicatorKind::Sma, 20) == sma, true);
+    ASSERT_EQ(cache.hits(), 1u);
+    ASSERT_EQ(cache.misses(), 2u);
+
+    // Budget of 3 columns: a 4th evicts the least recently used (Ema 20); evicted columns stay valid.
+    cache.get(id, series, IndicatorKind::Sma, 5);
+    cache.get(id, series, IndicatorKind::Sma, 50);
+    ASSERT_EQ(cache.bytesUsed(), 3 * column_bytes);
+    ASSERT_EQ(cache.get(id, series, IndicatorKind::Sma, 20) == sma, true);
+    ASSERT_EQ(cache.get(id, series, IndicatorKind::Ema, 20) == ema, false);
+    ASSERT_NEAR((*ema)[599], e.value(), 0.0);
+
+    // Concurrent requests for one column compute it once.
+    IndicatorCache shared;
+    ThreadPool pool(4);
+    std::vector<IndicatorColumnPtr> got(64);
+    pool.parallelFor(got.size(), [&](std::size_t i) { got[i] = shared.get(id, series, IndicatorKind::Sma, 9); });
+    for (const auto& c : got) ASSERT_EQ(c == got[0], true);
+    ASSERT_EQ(shared.misses(), 1u);
+
+    // Strategies read the cached columns: same result as streaming, one column per period.
+    auto cached_cache = std::make_shared<IndicatorCache>();
+    for (int slow : { 12, 30 }) {
+        Backtester plain(createSmaCrossoverStrategy(4, slow, 1.0), series, 10000.0);
+        Backtester cached(createSmaCrossoverStrategy(4, slow, 1.0), series, 10000.0);
+        cached.setIndicatorCache(cached_cache, id);
+        ASSERT_EQ(plain.run(), true);
+        ASSERT_EQ(cached.run(), true);
+        ASSERT_EQ(cached.simulator().trades().size(), plain.simulator().trades().size());
+        ASSERT_NEAR(cached.simulator().equity(), plain.simulator().equity(), 0.0);
+    }
+    ASSERT_EQ(cached_cache->misses(), 3u);  // 4, 12, 30
+    ASSERT_EQ(cached_cache->hits(), 1u);    // 4 again
+}
+
+//--- Portfolio: symbols merged by time onto one account
+class RecordingPortfolioStrategy : public IPortfolioStrategy {
+public:
+    void onBar(std::size_t symbol, const Bar& bar, IPortfolioContext& ctx) override {
+        seen.emplace_back(bar.timestamp, symbol);
+        ASSERT_EQ(ctx.time(), bar.timestamp);
+        ASSERT_EQ(ctx.bars(symbol).size(), ctx.barIndex(symbol) + 1);
+        ASSERT_EQ(ctx.bars(symbol).back().timestamp, bar.timestamp);
+        if (ctx.barIndex(symbol) == 1) ctx.placeOrder(symbol, Side::Long, 2);
+    }
+    std::vector<std::pair<std::int64_t, std::size_t>> seen;
+};
+
+void run_portfolio_backtester() {
+    auto series = [](int n, int step_min, int offset_min, double base) {
+        auto s = std::make_shared<BarSeries>();
+        for (int i = 0; i < n; ++i) {
+            Bar b;
+            b.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(offset_min + i * step_min) * NS_PER_MINUTE;
+            b.open = base + i;
+            b.close = b.high = base + i + 0.5;
+            b.low = base + i - 0.5;
+            s->push_back(b);
+        }
+        return s;
+    };
+    // a: every minute; b: every 2 minutes from minute 1 (shares timestamps 1, 3, 5, ... with a).
+    auto a = series(10, 1, 0, 100.0);
+    auto b = series(6, 2, 1, 50.0);
+
+    auto rec = std::make_unique<RecordingPortfolioStrategy>();
+    RecordingPortfolioStrategy* r = rec.get();
+    PortfolioBacktester pb(std::move(rec), 10000.0);
+    ASSERT_EQ(pb.addSymbol("A", a), 0u);
+    ASSERT_EQ(pb.addSymbol("B", b), 1u);
+    ASSERT_EQ(pb.run(), true);
+    ASSERT_EQ(r->seen.size(), 16u);
+    for (std::size_t i = 1; i < r->seen.size(); ++i)
+        ASSERT_EQ(r->seen[i - 1] < r->seen[i], true);  // time order, ties in symbol order
+    ASSERT_EQ(pb.equityCurve().size(), 11u);  // one point per distinct timestamp (minutes 0..9, 11)
+    ASSERT_EQ(pb.equityTimes().back(), b->times()[5]);
+    ASSERT_NEAR(pb.simulator(0).position(), 2.0, 1e-12);
+    ASSERT_NEAR(pb.simulator(1).position(), 2.0, 1e-12);
+    // One account: pooled cash plus both positions at their last closes.
+    double expect = 10000.0;
+    for (std::size_t s = 0; s < 2; ++s)
+        expect += pb.simulator(s).cash() + pb.simulator(s).position() * pb.simulator(s).lastClose();
+    ASSERT_NEAR(pb.equity(), expect, 1e-9);
+    ASSERT_NEAR(pb.cash(), 10000.0 + pb.simulator(0).cash() + pb.simulator(1).cash(), 1e-9);
+
+    // A one-symbol portfolio of a single-symbol strategy is the plain backtest. (Fixed 1-unit orders:
+    // the portfolio sizes on account equity marked at the open, Backtester on the last close.)
+    BarSeries walk;
+    double px = 100.0;
+    std::uint32_t seed = 99;
+    for (int i = 0; i < 400; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        Bar bar;
+        bar.timestamp = ts("2024-01-02T14:30") + static_cast<std::int64_t>(i) * NS_PER_MINUTE;
+        bar.open = px;
+        px = std::max(1.0, px + (static_cast<double>(seed >> 8) / 16777216.0 - 0.5));
+        bar.close = px;
+        bar.high = std::max(bar.open, bar.close);
+        bar.low = std::min(bar.open, bar.close);
+        walk.push_back(bar);
+    }
+    Backtester bt(createSmaCrossoverStrategy(5, 20, 1e-6), walk, 10000.0, 1.0);
+    ASSERT_EQ(bt.run(), true);
+    PortfolioBacktester one(createPerSymbolStrategy([](const std::string&) { return createSmaCrossoverStrategy(5, 20, 1e-6); }),
+                            10000.0, 1.0);
+    one.addSymbol("W", std::make_shared<const BarSeries>(walk));
+    ASSERT_EQ(one.run(), true);
+    ASSERT_EQ(one.simulator(0).trades().size(), bt.simulator().trades().size());
+    ASSERT_EQ(one.equityCurve().size(), bt.simulator().equityCurve().size());
+    for (std::size_t i = 0; i < one.equityCurve().size(); ++i)
+        ASSERT_NEAR(one.equityCurve()[i], bt.simulator().equityCurve()[i], 1e-6);
+    ASSERT_EQ(one.computeMetrics().num_trades, static_cast<int>(bt.simulator().trades().size()));
+}
+
 //--- DataSource: aggregate 1m to 15m (4 bars -> 1)
 void run_data_source_aggregate_15m() {
     std::string csv = "timestamp,open,high,low,close,volume\n"
@@ -121,6 +1686,60 @@ void run_data_source_aggregate_15m() {
     ASSERT_NEAR(ds.at(0).low, 99, 1e-6);
     ASSERT_NEAR(ds.at(0).close, 101.5, 1e-6);
     ASSERT_NEAR(ds.at(0).volume, 500, 1e-6);
+    ASSERT_EQ(ds.at(0).timestamp, ts("2024-01-01T09:30"));
+    std::remove(path.c_str());
+}
+
+//--- DataSource: 5m, session-anchored 1d@22:00 and midnight 1d buckets from unsorted 1m rows; --bar spellings
+void run_data_source_aggregate_resolutions() {
+    // Out of order on purpose (aggregation sorts first); session day 2024-01-01 22:00 -> 2024-01-02 22:00.
+    std::string csv = "timestamp,open,high,low,close,volume\n"
+                      "2024-01-01T22:04,12,14,11,13,20\n"
+                      "2024-01-01T21:58,10,11,9,10.5,10\n"
+                      "2024-01-01T21:59,10.5,12,10,11,10\n"
+                      "2024-01-02T03:00,13,20,12,19,30\n"
+                      "2024-01-02T22:00,19,19,18,18.5,5\n";
+    std::string path = "test_agg_res.csv";
+    {
+        std::ofstream f(path);
+        f << csv;
+    }
+    DataSource ds(path);
+    ASSERT_EQ(ds.load(), true);
+    ASSERT_EQ(ds.aggregateBars("5m"), true);
+    ASSERT_EQ(ds.size(), 4u);
+    ASSERT_EQ(ds.at(0).timestamp, ts("2024-01-01T21:55"));
+    ASSERT_NEAR(ds.at(0).open, 10, 1e-9);
+    ASSERT_NEAR(ds.at(0).close, 11, 1e-9);
+    ASSERT_EQ(ds.at(1).timestamp, ts("2024-01-01T22:00"));
+
+    ASSERT_EQ(ds.load(), true);
+    ASSERT_EQ(ds.aggregateBars("1d@22:00"), true);
+    ASSERT_EQ(ds.size(), 3u);
+    ASSERT_EQ(ds.at(0).timestamp, ts("2023-12-31T22:00"));
+    ASSERT_EQ(ds.at(1).timestamp, ts("2024-01-01T22:00"));
+    ASSERT_NEAR(ds.at(1).open, 12, 1e-9);
+    ASSERT_NEAR(ds.at(1).high, 20, 1e-9);
+    ASSERT_NEAR(ds.at(1).low, 11, 1e-9);
+    ASSERT_NEAR(ds.at(1).close, 19, 1e-9);
+    ASSERT_NEAR(ds.at(1).volume, 50, 1e-9);
+    ASSERT_EQ(ds.at(2).timestamp, ts("2024-01-02T22:00"));
+
+    ASSERT_EQ(ds.load(), true);
+    ASSERT_EQ(ds.aggregateBars("1d"), true);
+    ASSERT_EQ(ds.size(), 2u);
+    ASSERT_NEAR(ds.at(0).volume, 40, 1e-9);
+
+    BarResolution res;
+    ASSERT_EQ(parseBarResolution("4H", res), true);
+    ASSERT_EQ(res.period_ns, 4 * NS_PER_HOUR);
+    ASSERT_EQ(parseBarResolution("15min", res), true);
+    ASSERT_EQ(res.period_ns, 15 * NS_PER_MINUTE);
+    ASSERT_EQ(parseBarResolution("0m", res), false);
+    ASSERT_EQ(parseBarResolution("3w", res), false);
+    ASSERT_EQ(parseBarResolution("1d@25:00", res), false);
+    ASSERT_EQ(ds.aggregateBars("bogus"), false);
+    ASSERT_EQ(ds.size(), 2u);
     std::remove(path.c_str());
 }
 
@@ -128,8 +1747,34 @@ void run_all_tests() {
     std::cerr << "  simulator_long_trade ... "; run_simulator_long_trade(); std::cerr << "ok\n";
     std::cerr << "  simulator_commission ... "; run_simulator_commission(); std::cerr << "ok\n";
     std::cerr << "  simulator_slippage ... "; run_simulator_slippage(); std::cerr << "ok\n";
+    std::cerr << "  simulator_resting_orders ... "; run_simulator_resting_orders(); std::cerr << "ok\n";
+    std::cerr << "  intrabar_fills ... "; run_intrabar_fills(); std::cerr << "ok\n";
+    std::cerr << "  bar_series_columns ... "; run_bar_series_columns(); std::cerr << "ok\n";
     std::cerr << "  data_source_csv_load ... "; run_data_source_csv_load(); std::cerr << "ok\n";
+    std::cerr << "  data_source_mapped_matches_stream ... "; run_data_source_mapped_matches_stream(); std::cerr << "ok\n";
+    std::cerr << "  timestamp_parse_format ... "; run_timestamp_parse_format(); std::cerr << "ok\n";
+    std::cerr << "  orb_date_only_rows ... "; run_orb_date_only_rows(); std::cerr << "ok\n";
+    std::cerr << "  buffered_writer ... "; run_buffered_writer(); std::cerr << "ok\n";
+    std::cerr << "  session_lod ... "; run_session_lod(); std::cerr << "ok\n";
+    std::cerr << "  session_binary ... "; run_session_binary(); std::cerr << "ok\n";
+    std::cerr << "  data_source_csv_cache ... "; run_data_source_csv_cache(); std::cerr << "ok\n";
+    std::cerr << "  data_source_databento_cache ... "; run_data_source_databento_cache(); std::cerr << "ok\n";
+    std::cerr << "  databento_index_scan ... "; run_databento_index_scan(); std::cerr << "ok\n";
+    std::cerr << "  thread_pool_parallel_for ... "; run_thread_pool_parallel_for(); std::cerr << "ok\n";
+    std::cerr << "  parameter_sweep ... "; run_parameter_sweep(); std::cerr << "ok\n";
+    std::cerr << "  sma_lockstep_matches_backtester ... "; run_sma_lockstep_matches_backtester(); std::cerr << "ok\n";
+    std::cerr << "  static_backtester_matches_backtester ... "; run_static_backtester_matches_backtester(); std::cerr << "ok\n";
+    std::cerr << "  sweep_pruning ... "; run_sweep_pruning(); std::cerr << "ok\n";
+    std::cerr << "  walk_forward ... "; run_walk_forward(); std::cerr << "ok\n";
+    std::cerr << "  monte_carlo ... "; run_monte_carlo(); std::cerr << "ok\n";
+    std::cerr << "  online_metrics ... "; run_online_metrics(); std::cerr << "ok\n";
+    std::cerr << "  bar_loop_allocation_free ... "; run_bar_loop_allocation_free(); std::cerr << "ok\n";
+    std::cerr << "  indicator_cache ... "; run_indicator_cache(); std::cerr << "ok\n";
+    std::cerr << "  portfolio_backtester ... "; run_portfolio_backtester(); std::cerr << "ok\n";
+    std::cerr << "  dbn_decoder ... "; run_dbn_decoder(); std::cerr << "ok\n";
+    std::cerr << "  indicators_match_naive ... "; run_indicators_match_naive(); std::cerr << "ok\n";
     std::cerr << "  data_source_aggregate_15m ... "; run_data_source_aggregate_15m(); std::cerr << "ok\n";
+    std::cerr << "  data_source_aggregate_resolutions ... "; run_data_source_aggregate_resolutions(); std::cerr << "ok\n";
 }
 
 } // namespace